@@ -9,6 +9,11 @@
 #include "bench/BigPath.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkPath.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkRasterClip.h"
+#include "src/core/SkScan.h"
 #include "tools/ToolUtils.h"
 
 enum Align {
@@ -25,13 +30,18 @@ class BigPathBench : public Benchmark {
     SkString    fName;
     Align       fAlign;
     bool        fRound;
+    bool        fSparseStrips;
 
 public:
-    BigPathBench(Align align, bool round) : fAlign(align), fRound(round) {
+    BigPathBench(Align align, bool round, bool sparseStrips = false)
+        : fAlign(align), fRound(round), fSparseStrips(sparseStrips) {
         fName.printf("bigpath_%s", gAlignName[fAlign]);
         if (round) {
             fName.append("_round");
         }
+        if (sparseStrips) {
+            fName.append("_sparsestrips");
+        }
     }
 
 protected:
@@ -43,6 +53,11 @@ protected:
         return SkIPoint::Make(640, 100);
     }
 
+    bool isSuitableFor(Backend backend) override {
+        // The sparse strips variants scan convert straight into the canvas' pixels.
+        return !fSparseStrips || backend == kRaster_Backend;
+    }
+
     void onDelayedSetup() override { fPath = BenchUtils::make_big_path(); }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -67,8 +82,32 @@ protected:
                 break;
         }
 
+        if (!fSparseStrips) {
+            for (int i = 0; i < loops; i++) {
+                canvas->drawPath(fPath, paint);
+            }
+            return;
+        }
+
+        // Do the same work drawPath() would for each draw: stroke, transform, pick a blitter and
+        // scan convert, but always with sparse strips.
+        SkPixmap dst;
+        if (!canvas->peekPixels(&dst)) {
+            return;
+        }
+        const SkMatrix ctm = canvas->getTotalMatrix();
+        const SkMatrixProvider matrixProvider(ctm);
+        const SkRasterClip clip(canvas->getDeviceClipBounds());
+        SkPaint fillPaint(paint);
+        fillPaint.setStyle(SkPaint::kFill_Style);
         for (int i = 0; i < loops; i++) {
-            canvas->drawPath(fPath, paint);
+            SkPath devPath;
+            paint.getFillPath(fPath, &devPath);
+            devPath.transform(ctm);
+            SkSTArenaAlloc<kSkBlitterContextSize> alloc;
+            SkBlitter* blitter = SkBlitter::Choose(dst, matrixProvider, fillPaint, &alloc,
+                                                   false, nullptr);
+            SkScan::SparseStripsAntiFillPath(devPath, clip, blitter);
         }
     }
 
@@ -83,3 +122,11 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     false, true); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, true); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    false, true); )
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     true,  true); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   true,  true); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    true,  true); )
@@ -8,6 +8,7 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
@@ -18,6 +19,8 @@
 #define FILTER_HEIGHT_SMALL 32
 #define FILTER_WIDTH_LARGE  256
 #define FILTER_HEIGHT_LARGE 256
+#define FILTER_WIDTH_HUGE   2048
+#define FILTER_HEIGHT_HUGE  2048
 #define BLUR_SIGMA_MINI     0.5f
 #define BLUR_SIGMA_SMALL    1.0f
 #define BLUR_SIGMA_LARGE    10.0f
@@ -161,3 +164,83 @@ DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, tr
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, false, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, true, true, true);)
 DEF_BENCH(return new BlurImageFilterBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, false, true, true);)
+
+// Measures how the raster blur scales with threads. It blurs a huge checkerboard directly with
+// SkImage::makeWithFilter(), so the whole image is filtered no matter how big the canvas is.
+// With 1 thread everything runs inline; otherwise a pool of that many threads is installed as the
+// default SkExecutor, which the blur splits its passes across, for the duration of the bench.
+class BlurImageFilterThreadsBench : public Benchmark {
+public:
+    BlurImageFilterThreadsBench(SkScalar sigmaX, SkScalar sigmaY, int threads)
+      : fSigmaX(sigmaX)
+      , fSigmaY(sigmaY)
+      , fThreads(threads) {
+        fName.printf("blur_image_filter_huge_%.2f_%.2f_threads_%d",
+            SkScalarToFloat(sigmaX), SkScalarToFloat(sigmaY), threads);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fCheckerboard = make_checkerboard(FILTER_WIDTH_HUGE, FILTER_HEIGHT_HUGE);
+        fFilter = SkImageFilters::Blur(fSigmaX, fSigmaY, nullptr);
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        if (fThreads > 1) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        } else {
+            fExecutor = std::make_unique<InlineExecutor>();
+        }
+        fPreviousExecutor = &SkExecutor::GetDefault();
+        SkExecutor::SetDefault(fExecutor.get());
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkExecutor::SetDefault(fPreviousExecutor);
+        fExecutor.reset();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect bounds = SkIRect::MakeWH(fCheckerboard->width(), fCheckerboard->height());
+        for (int i = 0; i < loops; i++) {
+            SkIRect outSubset;
+            SkIPoint offset;
+            sk_sp<SkImage> blurred = fCheckerboard->makeWithFilter(nullptr, fFilter.get(),
+                                                                   bounds, bounds,
+                                                                   &outSubset, &offset);
+            SkASSERT(blurred);
+        }
+    }
+
+private:
+    class InlineExecutor final : public SkExecutor {
+    public:
+        void add(std::function<void(void)> work) override { work(); }
+    };
+
+    SkString fName;
+    SkScalar fSigmaX, fSigmaY;
+    int fThreads;
+    sk_sp<SkImage> fCheckerboard;
+    sk_sp<SkImageFilter> fFilter;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkExecutor* fPreviousExecutor = nullptr;
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, 1);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, 2);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, 4);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_LARGE, BLUR_SIGMA_LARGE, 8);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, 1);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, 2);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, 4);)
+DEF_BENCH(return new BlurImageFilterThreadsBench(BLUR_SIGMA_HUGE, BLUR_SIGMA_HUGE, 8);)
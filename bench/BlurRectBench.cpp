@@ -128,7 +128,9 @@ private:
 
 class BlurRectBoxFilterBench: public BlurRectSeparableBench {
 public:
-    BlurRectBoxFilterBench(SkScalar rad) : INHERITED(rad) {
+    BlurRectBoxFilterBench(SkScalar rad,
+                           SkMaskBlurFilter::Quality quality = SkMaskBlurFilter::Quality::kExact)
+            : INHERITED(rad), fQuality(quality) {
         SkString name;
 
         if (SkScalarFraction(rad) != 0) {
@@ -136,6 +138,9 @@ public:
         } else {
             name.printf("blurrect_boxfilter_%d", SkScalarRoundToInt(rad));
         }
+        if (quality == SkMaskBlurFilter::Quality::kFastApproximate) {
+            name.append("_fast");
+        }
 
         this->setName(name);
     }
@@ -145,12 +150,14 @@ protected:
     void makeBlurryRect(const SkRect&) override {
         SkMask mask;
         if (!SkBlurMask::BoxBlur(&mask, fSrcMask, SkBlurMask::ConvertRadiusToSigma(this->radius()),
-                                 kNormal_SkBlurStyle)) {
+                                 kNormal_SkBlurStyle, nullptr, fQuality)) {
             return;
         }
         SkMask::FreeImage(mask.fImage);
     }
 private:
+    SkMaskBlurFilter::Quality fQuality;
+
     using INHERITED = BlurRectSeparableBench;
 };
 
@@ -201,6 +208,9 @@ DEF_BENCH(return new BlurRectDirectBench(kMedBig);)
 DEF_BENCH(return new BlurRectBoxFilterBench(kMedium);)
 DEF_BENCH(return new BlurRectBoxFilterBench(kMedBig);)
 
+DEF_BENCH(return new BlurRectBoxFilterBench(SMALL, SkMaskBlurFilter::Quality::kFastApproximate);)
+DEF_BENCH(return new BlurRectBoxFilterBench(BIG,   SkMaskBlurFilter::Quality::kFastApproximate);)
+
 #if 0
 // disable Gaussian benchmarks; the algorithm works well enough
 // and serves as a baseline for ground truth, but it's too slow
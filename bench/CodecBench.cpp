@@ -10,12 +10,32 @@
 #include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
 #include "src/core/SkOSFile.h"
+#include "tools/ProcStats.h"
 #include "tools/flags/CommandLineFlags.h"
 
 // Actually zeroing the memory would throw off timing, so we just lie.
 static DEFINE_bool(zero_init, false,
                    "Pretend our destination is zero-intialized, simulating Android?");
 
+static DEFINE_int(codec_threads, 0,
+                  "If > 0, let codecs split decodes across a thread pool of this size.");
+
+static DEFINE_bool(codec_unmapped, false,
+                   "Hide the encoded data's memory from codecs, as if streaming from a file, "
+                   "so they copy it into their own buffers.");
+
+static DEFINE_bool(codec_rss, false, "Log the peak RSS before and after each codec bench.");
+
+namespace {
+// An SkMemoryStream that doesn't admit to being one, like an SkFILEStream.
+class UnmappedStream : public SkMemoryStream {
+public:
+    explicit UnmappedStream(sk_sp<SkData> data) : SkMemoryStream(std::move(data)) {}
+
+    const void* getMemoryBase() override { return nullptr; }
+};
+}  // namespace
+
 CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType,
         SkAlphaType alphaType)
     : fColorType(colorType)
@@ -25,6 +45,12 @@ CodecBench::CodecBench(SkString baseName, SkData* encoded, SkColorType colorType
     // Parse filename and the color type to give the benchmark a useful name
     fName.printf("Codec_%s_%s%s", baseName.c_str(), color_type_to_str(colorType),
             alpha_type_to_str(alphaType));
+    if (FLAGS_codec_threads > 0) {
+        fName.appendf("_%dthreads", FLAGS_codec_threads);
+    }
+    if (FLAGS_codec_unmapped) {
+        fName.append("_unmapped");
+    }
     // Ensure that we can create an SkCodec from this data.
     SkASSERT(SkCodec::MakeFromData(fData));
 }
@@ -45,6 +71,10 @@ void CodecBench::onDelayedSetup() {
                             .makeColorSpace(nullptr);
 
     fPixelStorage.reset(fInfo.computeMinByteSize());
+
+    if (FLAGS_codec_threads > 0 && !fExecutor) {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(FLAGS_codec_threads);
+    }
 }
 
 void CodecBench::onDraw(int n, SkCanvas* canvas) {
@@ -53,8 +83,13 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
     if (FLAGS_zero_init) {
         options.fZeroInitialized = SkCodec::kYes_ZeroInitialized;
     }
+    options.fExecutor = fExecutor.get();
     for (int i = 0; i < n; i++) {
-        codec = SkCodec::MakeFromData(fData);
+        if (FLAGS_codec_unmapped) {
+            codec = SkCodec::MakeFromStream(std::make_unique<UnmappedStream>(fData));
+        } else {
+            codec = SkCodec::MakeFromData(fData);
+        }
 #ifdef SK_DEBUG
         const SkCodec::Result result =
 #endif
@@ -64,3 +99,16 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
                  || result == SkCodec::kIncompleteInput);
     }
 }
+
+void CodecBench::onPerCanvasPreDraw(SkCanvas*) {
+    fMaxRSSBeforeMB = sk_tools::getMaxResidentSetSizeMB();
+}
+
+void CodecBench::onPerCanvasPostDraw(SkCanvas*) {
+    // The peak only moves if this bench needed more memory than any before it, so run it alone
+    // (e.g. with --match) to see what decoding this image costs.
+    if (FLAGS_codec_rss) {
+        SkDebugf("%s: peak RSS %dMB before, %dMB after\n",
+                 fName.c_str(), fMaxRSSBeforeMB, sk_tools::getMaxResidentSetSizeMB());
+    }
+}
@@ -10,11 +10,14 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkString.h"
 #include "src/core/SkAutoMalloc.h"
 
+#include <memory>
+
 /**
  *  Time SkCodec.
  */
@@ -28,6 +31,8 @@ protected:
     bool isSuitableFor(Backend backend) override;
     void onDraw(int n, SkCanvas* canvas) override;
     void onDelayedSetup() override;
+    void onPerCanvasPreDraw(SkCanvas*) override;
+    void onPerCanvasPostDraw(SkCanvas*) override;
 
 private:
     SkString                fName;
@@ -36,6 +41,8 @@ private:
     sk_sp<SkData>           fData;
     SkImageInfo             fInfo;          // Set in onDelayedSetup.
     SkAutoMalloc            fPixelStorage;
+    std::unique_ptr<SkExecutor> fExecutor;    // Set in onDelayedSetup, if --codec_threads.
+    int                     fMaxRSSBeforeMB = -1;
     using INHERITED = Benchmark;
 };
 #endif // CodecBench_DEFINED
@@ -7,7 +7,10 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/utils/SkAnimCodecPlayer.h"
 #include "modules/skottie/include/Skottie.h"
 #include "tools/Resources.h"
 
@@ -55,6 +58,37 @@ private:
 };
 
 
+// Decodes every frame of an animation, on fThreads threads, or serially if fThreads is 0.
+class AnimationDecodeBench final : public DecodeBench {
+public:
+    AnimationDecodeBench(const char* name, const char* source, int threads)
+        : INHERITED(threads ? SkStringPrintf("anim_%s_%dthreads", name, threads).c_str()
+                            : SkStringPrintf("anim_%s_serial", name).c_str(),
+                    source)
+        , fThreads(threads)
+    {}
+
+    void onDelayedSetup() override {
+        this->INHERITED::onDelayedSetup();
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkAssertResult(SkAnimCodecPlayer::DecodeAllFrames(fData, fExecutor.get(),
+                                                              [](int, sk_sp<SkImage>) {}));
+        }
+    }
+
+private:
+    const int                   fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = DecodeBench;
+};
+
 class SkottieDecodeBench final : public DecodeBench {
 public:
     SkottieDecodeBench(const char* name, const char* source)
@@ -233,3 +267,12 @@ DEF_BENCH(return new BitmapDecodeBench("png_small"    /*  32x  32*/, "images/man
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_connecting"   , "images/Connecting.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_generic_error", "images/Generic_Error.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_onboard"      , "images/Onboard.png"));
+
+// 60 frames at 320x240.
+DEF_BENCH(return new AnimationDecodeBench("gif_flight", "images/flightAnim.gif", 0));
+DEF_BENCH(return new AnimationDecodeBench("gif_flight", "images/flightAnim.gif", 1));
+DEF_BENCH(return new AnimationDecodeBench("gif_flight", "images/flightAnim.gif", 2));
+DEF_BENCH(return new AnimationDecodeBench("gif_flight", "images/flightAnim.gif", 4));
+DEF_BENCH(return new AnimationDecodeBench("gif_flight", "images/flightAnim.gif", 8));
+DEF_BENCH(return new AnimationDecodeBench("webp_stoplight", "images/stoplight.webp", 0));
+DEF_BENCH(return new AnimationDecodeBench("webp_stoplight", "images/stoplight.webp", 4));
@@ -7,6 +7,8 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
@@ -75,15 +77,19 @@ static bool encode_webp_lossless(SkWStream* dst, const SkPixmap& src) {
 static bool encode_png(SkWStream* dst,
                        const SkPixmap& src,
                        SkPngEncoder::FilterFlag filters,
-                       int zlibLevel) {
+                       int zlibLevel,
+                       SkPngEncoder::FilterHeuristic heuristic) {
     SkPngEncoder::Options opts;
     opts.fFilterFlags = filters;
     opts.fZLibLevel = zlibLevel;
+    opts.fFilterHeuristic = heuristic;
     return SkPngEncoder::Encode(dst, src, opts);
 }
 
-#define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
-           return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
+#define PNG_H(FLAG, ZLIBLEVEL, HEURISTIC) [](SkWStream* d, const SkPixmap& s) { \
+           return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL,    \
+                             SkPngEncoder::FilterHeuristic::HEURISTIC); }
+#define PNG(FLAG, ZLIBLEVEL) PNG_H(FLAG, ZLIBLEVEL, kLibpng)
 
 static const char* srcs[2] = {"images/mandrill_512.png", "images/color_wheel.jpg"};
 
@@ -122,4 +128,69 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 6), "PNG_6n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
+// Skia's own SIMD filters, choosing as libpng does (m) or from a sample of each row (x).
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_H(kAll, 6, kMinSum),        "PNG_6m"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_H(kAll, 6, kSampledMinSum), "PNG_6x"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_H(kAll, 1, kMinSum),        "PNG_1m"));
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_H(kAll, 1, kSampledMinSum), "PNG_1x"));
+
+DEF_BENCH(return new EncodeBench(srcs[1], PNG_H(kAll, 6, kMinSum),        "PNG_6m"));
+DEF_BENCH(return new EncodeBench(srcs[1], PNG_H(kAll, 6, kSampledMinSum), "PNG_6x"));
+DEF_BENCH(return new EncodeBench(srcs[1], PNG_H(kAll, 1, kMinSum),        "PNG_1m"));
+DEF_BENCH(return new EncodeBench(srcs[1], PNG_H(kAll, 1, kSampledMinSum), "PNG_1x"));
+
 #undef PNG
+#undef PNG_H
+
+// Encodes a large sprite sheet (mandrill tiled 4x4) as a png, serially or in parallel strips
+// on a pool of fThreads threads.  Divide the 16MB of pixels by the reported time for MB/s.
+class ParallelPngEncodeBench : public Benchmark {
+public:
+    explicit ParallelPngEncodeBench(int threads)
+        : fThreads(threads)
+        , fName(threads ? SkStringPrintf("Encode_PNG_2048_%dthreads", threads)
+                        : SkString("Encode_PNG_2048_serial")) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap tile;
+        SkAssertResult(GetResourceAsBitmap(srcs[0], &tile));
+        fBitmap.allocN32Pixels(4 * tile.width(), 4 * tile.height());
+        SkCanvas canvas(fBitmap);
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                canvas.drawImage(tile.asImage(), x * tile.width(), y * tile.height());
+            }
+        }
+        if (fThreads) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options opts;
+        opts.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkPixmap pixmap;
+            SkAssertResult(fBitmap.peekPixels(&pixmap));
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, pixmap, opts));
+            SkASSERT(dst.bytesWritten() > 0);
+        }
+    }
+
+private:
+    int                         fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new ParallelPngEncodeBench(0));
+DEF_BENCH(return new ParallelPngEncodeBench(1));
+DEF_BENCH(return new ParallelPngEncodeBench(2));
+DEF_BENCH(return new ParallelPngEncodeBench(4));
+DEF_BENCH(return new ParallelPngEncodeBench(8));
@@ -7,12 +7,17 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkString.h"
 #include "include/private/SkChecksum.h"
 #include "include/private/SkTemplates.h"
+#include "src/core/SkStrikeCache.h"
+#include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
+#include "tools/ToolUtils.h"
 
 #include "bench/gUniqueGlyphIDs.h"
 
@@ -197,3 +202,65 @@ private:
 };
 DEF_BENCH( return new FontPathBench(true); )
 DEF_BENCH( return new FontPathBench(false); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Many threads finding strikes and glyph metrics in one shared SkStrikeCache, as happens when
+// text is shaped and drawn on several raster threads at once.
+class FontCacheThreadedBench : public Benchmark {
+    static constexpr int kStrikeCount  = 64;
+    static constexpr int kLookupsPerLoop = 16;
+
+    const int fThreads;
+    SkString fName;
+    SkStrikeCache fCache;
+    std::vector<SkStrikeSpec> fSpecs;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkGlyphID fGlyphs[16];
+
+public:
+    explicit FontCacheThreadedBench(int threads) : fThreads(threads) {
+        fName.printf("fontcache_threaded_lookup_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        sk_sp<SkTypeface> typeface = ToolUtils::create_portable_typeface();
+        for (int i = 0; i < kStrikeCount; ++i) {
+            SkFont font(typeface, 8 + i);
+            font.setEdging(SkFont::Edging::kAntiAlias);
+            fSpecs.push_back(SkStrikeSpec::MakeMask(
+                    font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I()));
+        }
+        for (size_t i = 0; i < SK_ARRAY_COUNT(fGlyphs); ++i) {
+            fGlyphs[i] = i;
+        }
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup tasks(*fExecutor);
+        tasks.batch(fThreads, [&](int thread) {
+            const SkGlyph* glyphs[SK_ARRAY_COUNT(fGlyphs)];
+            int next = thread * 7;
+            for (int i = 0; i < loops * kLookupsPerLoop; ++i) {
+                sk_sp<SkStrike> strike = fSpecs[next++ % kStrikeCount].findOrCreateStrike(&fCache);
+                strike->metrics(SkMakeSpan(fGlyphs), glyphs);
+            }
+        });
+        tasks.wait();
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new FontCacheThreadedBench(1); )
+DEF_BENCH( return new FontCacheThreadedBench(4); )
+DEF_BENCH( return new FontCacheThreadedBench(8); )
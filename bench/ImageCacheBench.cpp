@@ -6,7 +6,10 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -75,3 +78,55 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Many threads hitting the same few Recs in one shared cache, like raster threads fetching the
+// same blur masks and mipmaps.
+class ImageCacheThreadedBench : public Benchmark {
+    static constexpr int kRecCount = 64;
+    static constexpr int kFindsPerLoop = 16;
+
+    const int fThreads;
+    SkString fName;
+    SkResourceCache fCache;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    explicit ImageCacheThreadedBench(int threads) : fThreads(threads), fCache(kRecCount * 100) {
+        fName.printf("imagecache_threaded_find_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < kRecCount; ++i) {
+            fCache.add(new TestRec(TestKey(i), i));
+        }
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkTaskGroup tasks(*fExecutor);
+        tasks.batch(fThreads, [&](int thread) {
+            int next = thread * 7;
+            for (int i = 0; i < loops * kFindsPerLoop; ++i) {
+                SkDEBUGCODE(bool found =) fCache.find(TestKey(next++ % kRecCount),
+                                                      TestRec::Visitor, nullptr);
+                SkASSERT(found);
+            }
+        });
+        tasks.wait();
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+DEF_BENCH( return new ImageCacheThreadedBench(1); )
+DEF_BENCH( return new ImageCacheThreadedBench(4); )
+DEF_BENCH( return new ImageCacheThreadedBench(8); )
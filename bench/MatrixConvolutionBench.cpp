@@ -14,14 +14,35 @@
 
 #include "tools/ToolUtils.h"
 
+enum class KernelType {
+    k3x3,
+    k9x9,
+    k9x9Separable,  // A binomial blur, which is the outer product of two 1D kernels.
+};
+
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(bool bigKernel, SkTileMode tileMode, bool convolveAlpha)
+    MatrixConvolutionBench(KernelType kernelType, SkTileMode tileMode, bool convolveAlpha)
         : fName(SkStringPrintf("matrixconvolution_%s%s%s",
-                               bigKernel ? "bigKernel_" : "",
+                               kernelType == KernelType::k9x9          ? "bigKernel_" :
+                               kernelType == KernelType::k9x9Separable ? "separableKernel_" : "",
                                ToolUtils::tilemode_name(tileMode),
                                convolveAlpha ? "" : "_noConvolveAlpha")) {
-        if (bigKernel) {
+        if (kernelType == KernelType::k9x9Separable) {
+            SkISize kernelSize = SkISize::Make(9, 9);
+            const SkScalar binomial[9] = {1, 8, 28, 56, 70, 56, 28, 8, 1};
+            SkScalar kernel[81];
+            for (int y = 0; y < 9; y++) {
+                for (int x = 0; x < 9; x++) {
+                    kernel[y * 9 + x] = binomial[y] * binomial[x];
+                }
+            }
+            SkScalar gain = 1.0f / (256 * 256), bias = 0;
+            SkIPoint kernelOffset = SkIPoint::Make(4, 4);
+            fFilter = SkImageFilters::MatrixConvolution(kernelSize, kernel, gain, bias,
+                                                        kernelOffset, tileMode, convolveAlpha,
+                                                        nullptr);
+        } else if (kernelType == KernelType::k9x9) {
             SkISize kernelSize = SkISize::Make(9, 9);
             SkScalar kernel[81];
             for (int i = 0; i < 81; i++) {
@@ -74,14 +95,18 @@ private:
     using INHERITED = Benchmark;
 };
 
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(false, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k3x3, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k3x3, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k3x3, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k3x3, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k3x3, SkTileMode::kDecal, false); )
+
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k9x9, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k9x9, SkTileMode::kRepeat, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k9x9, SkTileMode::kMirror, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k9x9, SkTileMode::kDecal, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k9x9, SkTileMode::kDecal, false); )
 
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kClamp, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kRepeat, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kMirror, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, true); )
-DEF_BENCH( return new MatrixConvolutionBench(true, SkTileMode::kDecal, false); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k9x9Separable, SkTileMode::kClamp, true); )
+DEF_BENCH( return new MatrixConvolutionBench(KernelType::k9x9Separable, SkTileMode::kDecal,
+                                             false); )
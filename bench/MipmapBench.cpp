@@ -8,22 +8,38 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "src/core/SkMipmap.h"
 
 class MipmapBench: public Benchmark {
+public:
+    enum class Mode {
+        kPortable,  // The portable downsamplers, on one thread.
+        kOpts,      // SkOpts downsamplers where we have them, on one thread.
+        kThreaded,  // SkOpts downsamplers, with each level split across a thread pool.
+    };
+
+private:
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    const Mode fMode;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, bool halfFloat = false, Mode mode = Mode::kOpts)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fMode(mode)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        switch (mode) {
+            case Mode::kPortable: fName.append("_portable"); break;
+            case Mode::kOpts:                                break;
+            case Mode::kThreaded: fName.append("_threaded"); break;
+        }
     }
 
 protected:
@@ -39,11 +55,18 @@ protected:
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+
+        if (fMode == Mode::kThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
+        SkMipmap::BuildOptions options;
+        options.fAllowOpts = fMode != Mode::kPortable;
+        options.fExecutor  = fExecutor.get();  // Null uses the default, serial executor.
         for (int i = 0; i < loops * 4; i++) {
-            SkMipmap::Build(fBitmap, nullptr)->unref();
+            SkMipmap::Build(fBitmap.pixmap(), nullptr, true, options)->unref();
         }
     }
 
@@ -66,3 +89,13 @@ DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+// Compare the portable downsamplers against the SkOpts and threaded builds.
+DEF_BENCH( return new MipmapBench(2048, 2048, false, MipmapBench::Mode::kPortable); )
+DEF_BENCH( return new MipmapBench(2048, 2048, false, MipmapBench::Mode::kThreaded); )
+DEF_BENCH( return new MipmapBench(4096, 4096, false, MipmapBench::Mode::kPortable); )
+DEF_BENCH( return new MipmapBench(4096, 4096, false, MipmapBench::Mode::kOpts); )
+DEF_BENCH( return new MipmapBench(4096, 4096, false, MipmapBench::Mode::kThreaded); )
+DEF_BENCH( return new MipmapBench(2048, 2048, true,  MipmapBench::Mode::kPortable); )
+DEF_BENCH( return new MipmapBench(2048, 2048, true,  MipmapBench::Mode::kOpts); )
+DEF_BENCH( return new MipmapBench(2048, 2048, true,  MipmapBench::Mode::kThreaded); )
@@ -10,6 +10,7 @@
 #include "include/core/SkString.h"
 #include "include/private/SkTemplates.h"
 #include "include/utils/SkRandom.h"
+#include "src/core/SkPackedBVH.h"
 #include "src/core/SkRTree.h"
 
 // confine rectangles to a smallish area, so queries generally hit something, and overlap occurs:
@@ -20,11 +21,16 @@ static const int GRID_WIDTH = 100;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
+template <typename Tree> static const char* tree_name();
+template <> const char* tree_name<SkRTree>()     { return "rtree"; }
+template <> const char* tree_name<SkPackedBVH>() { return "packedbvh"; }
+
 // Time how long it takes to build an R-Tree.
+template <typename Tree>
 class RTreeBuildBench : public Benchmark {
 public:
     RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+        fName.printf("%s_%s_build", tree_name<Tree>(), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -43,7 +49,7 @@ protected:
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
+            Tree tree;
             tree.insert(rects.get(), NUM_BUILD_RECTS);
             SkASSERT(rects != nullptr);  // It'd break this bench if the tree took ownership of rects.
         }
@@ -55,10 +61,11 @@ private:
 };
 
 // Time how long it takes to perform queries on an R-Tree.
+template <typename Tree>
 class RTreeQueryBench : public Benchmark {
 public:
     RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+        fName.printf("%s_%s_query", tree_name<Tree>(), name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -90,7 +97,7 @@ protected:
         }
     }
 private:
-    SkRTree fTree;
+    Tree fTree;
     MakeRectProc fProc;
     SkString fName;
     using INHERITED = Benchmark;
@@ -128,12 +135,22 @@ static inline SkRect make_concentric_rects(SkRandom&, int index, int numRects) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH(return new RTreeBuildBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeBuildBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeBuildBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeBuildBench("concentric", &make_concentric_rects));
-
-DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
-DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
-DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
-DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeBuildBench<SkRTree>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("random", &make_random_rects));
+DEF_BENCH(return new RTreeQueryBench<SkRTree>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeBuildBench<SkPackedBVH>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedBVH>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedBVH>("random", &make_random_rects));
+DEF_BENCH(return new RTreeBuildBench<SkPackedBVH>("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeQueryBench<SkPackedBVH>("XY", &make_XYordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedBVH>("YX", &make_YXordered_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedBVH>("random", &make_random_rects));
+DEF_BENCH(return new RTreeQueryBench<SkPackedBVH>("concentric", &make_concentric_rects));
@@ -34,16 +34,23 @@ SkIPoint PictureCentricBench::onGetSize() {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH)
+RecordingBench::RecordingBench(const char* name, const SkPicture* pic, bool useBBH,
+                               bool usePackedBVH)
     : INHERITED(name, pic)
     , fUseBBH(useBBH)
+    , fUsePackedBVH(usePackedBVH)
 {}
 
 void RecordingBench::onDraw(int loops, SkCanvas*) {
-    SkRTreeFactory factory;
+    SkRTreeFactory rtreeFactory;
+    SkPackedBVHFactory packedFactory;
+    SkBBHFactory* factory = nullptr;
+    if (fUseBBH) {
+        factory = fUsePackedBVH ? (SkBBHFactory*)&packedFactory : (SkBBHFactory*)&rtreeFactory;
+    }
     SkPictureRecorder recorder;
     while (loops --> 0) {
-        fSrc->playback(recorder.beginRecording(fSrc->cullRect(), fUseBBH ? &factory : nullptr));
+        fSrc->playback(recorder.beginRecording(fSrc->cullRect(), factory));
         (void)recorder.finishRecordingAsPicture();
     }
 }
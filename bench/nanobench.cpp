@@ -35,6 +35,7 @@
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkLeanWindows.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkRasterPipeline.h"
 #include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/utils/SkJSONWriter.h"
@@ -78,6 +79,8 @@
 
 extern bool gSkForceRasterPipelineBlitter;
 extern bool gForceHighPrecisionRasterPipeline;
+extern bool gDisableRasterPipelineFusion;
+extern bool gCountRasterPipelineFusion;
 extern bool gUseSkVMBlitter;
 extern bool gSkVMAllowJIT;
 extern bool gSkVMJITViaDylib;
@@ -139,6 +142,7 @@ static DEFINE_string(zoom, "1.0,0",
                      "Comma-separated zoomMax,zoomPeriodMs factors for a periodic SKP zoom "
                      "function that ping-pongs between 1.0 and zoomMax.");
 static DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
+static DEFINE_bool(packedBVH, false, "With --bbh, build an SkPackedBVH instead of an SkRTree.");
 static DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
 static DEFINE_int(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 static DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
@@ -154,6 +158,9 @@ static DEFINE_string(benchType,  "",
 
 static DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
 static DEFINE_bool(forceRasterPipelineHP, false, "sets gSkForceRasterPipelineBlitter and gForceHighPrecisionRasterPipeline");
+static DEFINE_bool(rasterPipelineFusion, true, "Fuse common runs of SkRasterPipeline stages?");
+static DEFINE_bool(rasterPipelineFusionStats, false,
+                   "Count how often SkRasterPipeline fuses stages, and print the counts at exit.");
 static DEFINE_bool(skvm, false, "sets gUseSkVMBlitter");
 static DEFINE_bool(jit, true, "JIT SkVM?");
 static DEFINE_bool(dylib, false, "JIT via dylib (much slower compile but easier to debug/profile)");
@@ -941,7 +948,7 @@ public:
             fBenchType  = "recording";
             fSKPBytes = static_cast<double>(pic->approximateBytesUsed());
             fSKPOps   = pic->approximateOpCount();
-            return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh);
+            return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh, FLAGS_packedBVH);
         }
 
         // Add all .skps as DeserializePictureBenchs.
@@ -970,11 +977,14 @@ public:
 
                 if (FLAGS_bbh) {
                     // The SKP we read off disk doesn't have a BBH.  Re-record so it grows one.
-                    SkRTreeFactory factory;
+                    SkRTreeFactory rtreeFactory;
+                    SkPackedBVHFactory packedFactory;
+                    SkBBHFactory* factory = FLAGS_packedBVH ? (SkBBHFactory*)&packedFactory
+                                                            : (SkBBHFactory*)&rtreeFactory;
                     SkPictureRecorder recorder;
                     pic->playback(recorder.beginRecording(pic->cullRect().width(),
                                                           pic->cullRect().height(),
-                                                          &factory));
+                                                          factory));
                     pic = recorder.finishRecordingAsPicture();
                 }
                 SkString name = SkOSPath::Basename(path.c_str());
@@ -1420,6 +1430,8 @@ int main(int argc, char** argv) {
 
     gSkForceRasterPipelineBlitter     = FLAGS_forceRasterPipelineHP || FLAGS_forceRasterPipeline;
     gForceHighPrecisionRasterPipeline = FLAGS_forceRasterPipelineHP;
+    gDisableRasterPipelineFusion      = !FLAGS_rasterPipelineFusion;
+    gCountRasterPipelineFusion        = FLAGS_rasterPipelineFusionStats;
     gUseSkVMBlitter = FLAGS_skvm;
     gSkVMAllowJIT = FLAGS_jit;
     gSkVMJITViaDylib = FLAGS_dylib;
@@ -1637,6 +1649,10 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (FLAGS_rasterPipelineFusionStats) {
+        SkRasterPipeline::GetFusionStats().dump();
+    }
+
     if (FLAGS_dmsaaStatsDump) {
         SkDebugf("<<Total Combined DMSAA Stats>>\n");
         combinedDMSAAStats.dump();
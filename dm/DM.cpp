@@ -23,7 +23,9 @@
 #include "src/core/SkLeanWindows.h"
 #include "src/core/SkMD5.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkRasterPipeline.h"
 #include "src/core/SkTaskGroup.h"
+#include "src/core/SkVMBlitter.h"
 #include "src/utils/SkOSPath.h"
 #include "tests/Test.h"
 #include "tests/TestHarness.h"
@@ -58,6 +60,7 @@
 #endif
 
 extern bool gSkForceRasterPipelineBlitter;
+extern bool gCountRasterPipelineFusion;
 extern bool gUseSkVMBlitter;
 extern bool gSkVMAllowJIT;
 extern bool gSkBlobAsSlugTesting;
@@ -94,8 +97,12 @@ static DEFINE_int(shard,  0, "Which shard do I run?");
 
 static DEFINE_string(mskps, "", "Directory to read mskps from, or a single mskp file.");
 static DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
+static DEFINE_bool(rasterPipelineFusionStats, false,
+                   "Count how often SkRasterPipeline fuses stages, and print the counts at exit.");
 static DEFINE_bool(skvm, false, "sets gUseSkVMBlitter");
 static DEFINE_bool(jit,  true,  "sets gSkVMAllowJIT");
+static DEFINE_string(skvmProgramCache, "",
+                     "If set, preload SkVMBlitter programs from this file, and save them at exit.");
 static DEFINE_bool(blobAsSlugTesting, false, "sets gSkBlobAsSlugTesting");
 
 static DEFINE_string(bisect, "",
@@ -1511,10 +1518,18 @@ int main(int argc, char** argv) {
     CommonFlags::SetAnalyticAA();
 
     gSkForceRasterPipelineBlitter = FLAGS_forceRasterPipeline;
+    gCountRasterPipelineFusion    = FLAGS_rasterPipelineFusionStats;
     gUseSkVMBlitter               = FLAGS_skvm;
     gSkVMAllowJIT                 = FLAGS_jit;
     gSkBlobAsSlugTesting          = FLAGS_blobAsSlugTesting;
 
+    if (!FLAGS_skvmProgramCache.isEmpty()) {
+        if (auto stream = SkStream::MakeFromFile(FLAGS_skvmProgramCache[0])) {
+            info("Loaded %d SkVM programs from %s.\n",
+                 SkVMBlitter::LoadProgramCache(stream.get()), FLAGS_skvmProgramCache[0]);
+        }
+    }
+
     // The bots like having a verbose.log to upload, so always touch the file even if --verbose.
     if (!FLAGS_writePath.isEmpty()) {
         sk_mkdir(FLAGS_writePath[0]);
@@ -1600,6 +1615,23 @@ int main(int argc, char** argv) {
     // Make sure we've flushed all our results to disk.
     dump_json();
 
+    {
+        SkVMBlitter::ProgramCacheStats stats = SkVMBlitter::GetProgramCacheStats();
+        vlog("SkVM program cache: %d hits, %d misses, %.1fms compiling, %d preloaded, "
+             "%d verified.\n",
+             stats.hits, stats.misses, stats.compileMs, stats.loaded, stats.verified);
+    }
+    if (FLAGS_rasterPipelineFusionStats) {
+        SkRasterPipeline::GetFusionStats().dump();
+    }
+    if (!FLAGS_skvmProgramCache.isEmpty()) {
+        SkFILEWStream stream(FLAGS_skvmProgramCache[0]);
+        if (stream.isValid()) {
+            info("Saved %d SkVM programs to %s.\n",
+                 SkVMBlitter::SaveProgramCache(&stream), FLAGS_skvmProgramCache[0]);
+        }
+    }
+
     if (!gFailures->empty()) {
         info("Failures:\n");
         for (const SkString& fail : *gFailures) {
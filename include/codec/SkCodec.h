@@ -27,6 +27,7 @@
 class SkAndroidCodec;
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -162,6 +163,10 @@ public:
      *      If the PNG does not contain unknown chunks, the SkPngChunkReader
      *      will not be used or modified.
      *
+     *  If the stream has a memory base (e.g. an SkMemoryStream, perhaps of an
+     *  mmapped SkData from SkStream::MakeFromFile), the JPEG, PNG, WebP and GIF
+     *  codecs read the encoded data in place rather than copying it.
+     *
      *  If NULL is returned, the stream is deleted immediately. Otherwise, the
      *  SkCodec takes ownership of it, and will delete it when done with it.
      */
@@ -289,6 +294,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -332,6 +338,15 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may split the decode into independent pieces and run
+         *  them on this executor, returning once all of them have finished.
+         *
+         *  Currently only used by JPEGs with restart markers, decoded at full size.
+         *  Ignored by scanline and incremental decodes.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
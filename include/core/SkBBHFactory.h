@@ -60,4 +60,13 @@ public:
     sk_sp<SkBBoxHierarchy> operator()() const override;
 };
 
+/**
+ *  Builds hierarchies with the same results as SkRTreeFactory, laid out for faster queries during
+ *  playback of pictures with many ops.
+ */
+class SK_API SkPackedBVHFactory : public SkBBHFactory {
+public:
+    sk_sp<SkBBoxHierarchy> operator()() const override;
+};
+
 #endif
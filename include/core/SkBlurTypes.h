@@ -19,4 +19,9 @@ enum SkBlurStyle : int {
     kLastEnum_SkBlurStyle = kInner_SkBlurStyle,
 };
 
+enum class SkBlurQuality {
+    kExact,            //!< true Gaussian for small sigmas, as the spec describes
+    kFastApproximate,  //!< faster CPU mask blurs at some small sigmas; see SkMaskFilter::MakeBlur
+};
+
 #endif
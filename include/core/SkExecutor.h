@@ -22,6 +22,14 @@ public:
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0,
                                                           bool allowBorrowing = true);
 
+    // Create a work-stealing thread pool SkExecutor, by default with one thread per core.
+    // Work added from one of its own threads stays on that thread's deque unless idle threads
+    // steal it, so tasks that fan out into many subtasks do not contend on a shared queue.
+    // Its own threads may always borrow(), even when allowBorrowing is false, so a task can
+    // wait on the subtasks it spawns.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingThreadPool(int threads = 0,
+                                                                  bool allowBorrowing = true);
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
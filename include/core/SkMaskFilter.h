@@ -27,10 +27,15 @@ public:
      *  @param style      The SkBlurStyle to use
      *  @param sigma      Standard deviation of the Gaussian blur to apply. Must be > 0.
      *  @param respectCTM if true the blur's sigma is modified by the CTM.
+     *  @param quality    with kFastApproximate, CPU mask blurs whose device-space sigma is in
+     *                   [1.2, 2) use three box blurs instead of a true Gaussian. This is faster,
+     *                   but each coverage value may differ from the exact blur by up to 34/255.
+     *                   Blurs with any other sigma, and GPU blurs, are unchanged.
      *  @return The new blur maskfilter
      */
     static sk_sp<SkMaskFilter> MakeBlur(SkBlurStyle style, SkScalar sigma,
-                                        bool respectCTM = true);
+                                        bool respectCTM = true,
+                                        SkBlurQuality quality = SkBlurQuality::kExact);
 
     /**
      *  Returns the approximate bounds that would result from filtering the src rect.
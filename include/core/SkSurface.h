@@ -28,6 +28,7 @@
 class SkCanvas;
 class SkDeferredDisplayList;
 class SkPaint;
+class SkRegion;
 class SkSurfaceCharacterization;
 class GrBackendRenderTarget;
 class GrBackendSemaphore;
@@ -513,6 +514,30 @@ public:
     */
     void notifyContentWillChange(ContentChangeMode mode);
 
+    /** Starts tracking which pixels of a raster SkSurface drawing changes, in tiles of tileSize
+        by tileSize pixels. Each draw damages the tiles under the conservative device bounds
+        SkCanvas computes for it, or under its clip if its bounds can't be computed. So do
+        writePixels() calls. Damage from earlier frames is discarded.
+
+        Returns false for GPU and other non-raster SkSurface, or if tileSize is not positive.
+
+        @param tileSize  width and height of the tiles damage is tracked in
+        @return          true if damage is being tracked
+    */
+    bool enableDamageTracking(int tileSize = 64);
+
+    /** Sets damage to the tiles damaged since the last call, or since enableDamageTracking(),
+        and starts a new frame. damage is empty if nothing was drawn, or if damage is not being
+        tracked, so an idle frame can skip presenting entirely.
+
+        To repaint only what changed from a recorded SkPicture, clip to damage before replaying
+        it: canvas->clipRegion(damage); canvas->drawPicture(picture). Ops outside the damaged
+        tiles are culled.
+
+        @param damage  set to the damaged tiles, clipped to the SkSurface bounds
+    */
+    void takeDamage(SkRegion* damage);
+
     /** Returns the recording context being used by the SkSurface.
 
         @return the recording context, if available; nullptr otherwise
@@ -10,6 +10,10 @@
 
 #include "include/codec/SkCodec.h"
 
+#include <functional>
+
+class SkData;
+class SkExecutor;
 class SkImage;
 
 class SkAnimCodecPlayer {
@@ -44,6 +48,25 @@ public:
      */
     bool seek(uint32_t msec);
 
+    /**
+     *  Decodes every frame of the encoded image in data, passing each to onFrame() as it's
+     *  ready.  Frames arrive as the codec decodes them, before any origin is applied, and not
+     *  necessarily in order.
+     *
+     *  Each frame waits for the frame it's drawn over (SkCodec::FrameInfo::fRequiredFrame), but
+     *  frames that don't depend on each other are decoded concurrently on executor, each thread
+     *  with its own codec.  Without an executor, frames are decoded on this thread.  A decoded
+     *  frame is only kept (as a keyframe) until the frames drawn over it have started, so long
+     *  animations need not hold all of their frames at once.
+     *
+     *  onFrame() may be called from any of executor's threads, but never concurrently.
+     *
+     *  Returns false if data can't be decoded or any frame fails, in which case frames that
+     *  depend on a failed frame are skipped.
+     */
+    static bool DecodeAllFrames(sk_sp<SkData> data, SkExecutor* executor,
+                                const std::function<void(int index, sk_sp<SkImage>)>& onFrame);
+
 
 private:
     std::unique_ptr<SkCodec>        fCodec;
@@ -16,11 +16,15 @@
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkParseEncodedOrigin.h"
+#include "src/core/SkTaskGroup.h"
 
 // stdio is needed for libjpeg-turbo
 #include <stdio.h>
 #include "src/codec/SkJpegUtility.h"
 
+#include <algorithm>
+#include <vector>
+
 #ifdef SK_CODEC_DECODES_JPEG
 
 // This warning triggers false postives way too often in here.
@@ -520,6 +524,266 @@ static inline bool needs_swizzler_to_convert_from_cmyk(J_COLOR_SPACE jpegColorTy
     return !hasCMYKColorSpace || !hasColorSpaceXform;
 }
 
+namespace {
+
+// Locates the pieces of a baseline JPEG's encoded bytes that a band of restart intervals can be
+// decoded from on its own: the tables up to the scan's SOS, and where each interval's
+// entropy-coded data starts and ends.
+struct RestartIndex {
+    std::vector<uint8_t> fHeader;        // SOI through SOS, minus APPn and COM segments.
+    size_t               fHeightOffset;  // Of the frame height in fHeader.
+    size_t               fEntropyStart;
+    size_t               fEntropyEnd;    // Of the EOI marker.
+    std::vector<size_t>  fMarkers;       // Of each RSTn marker, in order.
+
+    int intervals() const { return SkToInt(fMarkers.size()) + 1; }
+    size_t intervalStart(int i) const { return i == 0 ? fEntropyStart : fMarkers[i - 1] + 2; }
+    size_t intervalEnd(int i) const {
+        return i == this->intervals() - 1 ? fEntropyEnd : fMarkers[i];
+    }
+};
+
+bool index_restart_markers(const uint8_t* data, size_t size, RestartIndex* index) {
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {  // SOI
+        return false;
+    }
+    index->fHeader.assign(data, data + 2);
+    index->fHeightOffset = 0;
+
+    size_t pos = 2;
+    for (;;) {
+        if (pos + 4 > size || data[pos] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) {
+            pos++;  // Fill byte.
+            continue;
+        }
+        const size_t segment = 2 + ((data[pos + 2] << 8) | data[pos + 3]);
+        if (segment < 4 || pos + segment > size) {
+            return false;
+        }
+
+        const bool isAPPnOrCOM = (marker >= JPEG_APP0 && marker <= JPEG_APP0 + 15) ||
+                                 marker == JPEG_COM;
+        if (marker == 0xC0 || marker == 0xC1) {  // SOF0 and SOF1, baseline and extended.
+            index->fHeightOffset = index->fHeader.size() + 5;
+        } else if (marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 &&
+                   marker != 0xCC) {  // Any other SOFn.
+            return false;
+        }
+        if (!isAPPnOrCOM) {
+            index->fHeader.insert(index->fHeader.end(), data + pos, data + pos + segment);
+        }
+        pos += segment;
+        if (marker == 0xDA) {  // SOS
+            break;
+        }
+    }
+    if (index->fHeightOffset == 0) {
+        return false;
+    }
+    index->fEntropyStart = pos;
+
+    // In entropy-coded data 0xFF is either stuffed (FF 00), padding (FF FF), or a marker.
+    // The only markers we expect are RST0 through RST7, cycling, and then EOI.
+    index->fMarkers.clear();
+    for (;;) {
+        const void* ff = memchr(data + pos, 0xFF, size - pos);
+        if (!ff) {
+            return false;
+        }
+        pos = static_cast<const uint8_t*>(ff) - data;
+        if (pos + 1 >= size) {
+            return false;
+        }
+        const uint8_t next = data[pos + 1];
+        if (next == 0x00) {
+            pos += 2;
+        } else if (next == 0xFF) {
+            pos += 1;
+        } else if (next >= JPEG_RST0 && next <= JPEG_RST0 + 7) {
+            if (next - JPEG_RST0 != (int)(index->fMarkers.size() % 8)) {
+                return false;
+            }
+            index->fMarkers.push_back(pos);
+            pos += 2;
+        } else {
+            index->fEntropyEnd = pos;
+            return next == JPEG_EOI;
+        }
+    }
+}
+
+// Writes a JPEG holding just intervals [firstInterval, endInterval) of the indexed one, which
+// must cover the MCU rows of a band that is height pixels tall.
+void make_band_jpeg(const uint8_t* data, const RestartIndex& index, int firstInterval,
+                    int endInterval, int height, std::vector<uint8_t>* band) {
+    const size_t start = index.intervalStart(firstInterval),
+                 end   = index.intervalEnd(endInterval - 1);
+
+    band->assign(index.fHeader.begin(), index.fHeader.end());
+    (*band)[index.fHeightOffset + 0] = SkToU8(height >> 8);
+    (*band)[index.fHeightOffset + 1] = SkToU8(height & 0xFF);
+
+    const size_t entropyStart = band->size();
+    band->insert(band->end(), data + start, data + end);
+    // Restart markers count up from RST0 again in the band.
+    for (int i = firstInterval; i < endInterval - 1; i++) {
+        (*band)[entropyStart + index.fMarkers[i] - start + 1] =
+                SkToU8(JPEG_RST0 + (i - firstInterval) % 8);
+    }
+    band->push_back(0xFF);
+    band->push_back(JPEG_EOI);
+}
+
+}  // namespace
+
+/*
+ * Decodes a band of rows [dstTop, dstBottom) from a JPEG made by make_band_jpeg() whose first
+ * row is the image's bandTop, discarding any rows above dstTop.
+ */
+bool SkJpegCodec::decodeBand(const std::vector<uint8_t>& band, const SkImageInfo& dstInfo,
+                             void* dst, size_t dstRowBytes, int bandTop, int dstTop,
+                             int dstBottom) const {
+    const jpeg_decompress_struct* srcInfo = fDecoderMgr->dinfo();
+    const bool xformFromScratch = this->colorXform() && dstInfo.bytesPerPixel() != 4;
+    SkAutoTMalloc<uint32_t> scratch(dstInfo.width());
+
+    SkMemoryStream stream(band.data(), band.size(), false);
+    JpegDecoderMgr decoderMgr(&stream);
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+    if (setjmp(jmp)) {
+        return decoderMgr.returnFalse("decodeBand");
+    }
+
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, true)) {
+        return false;
+    }
+    // The band has none of the APPn segments libjpeg would guess the color space from.
+    dinfo->jpeg_color_space = srcInfo->jpeg_color_space;
+    dinfo->out_color_space = srcInfo->out_color_space;
+    dinfo->dither_mode = srcInfo->dither_mode;
+    dinfo->dct_method = srcInfo->dct_method;
+    dinfo->do_fancy_upsampling = srcInfo->do_fancy_upsampling;
+    if (!jpeg_start_decompress(dinfo)) {
+        return false;
+    }
+
+    for (int y = bandTop; y < dstBottom; y++) {
+        void* dstRow = SkTAddOffset<void>(dst, (y - dstTop) * dstRowBytes);
+        JSAMPLE* decodeDst = (y < dstTop || xformFromScratch) ? (JSAMPLE*) scratch.get()
+                                                               : (JSAMPLE*) dstRow;
+        if (0 == jpeg_read_scanlines(dinfo, &decodeDst, 1)) {
+            return false;
+        }
+        if (y >= dstTop && this->colorXform()) {
+            this->applyColorXform(dstRow, decodeDst, dstInfo.width());
+        }
+    }
+    return true;
+}
+
+/*
+ * Splits a full sized decode of a JPEG with restart markers into bands of MCU rows that start
+ * at a restart interval, and decodes them on options.fExecutor.
+ * Returns kUnimplemented without touching fDecoderMgr if the image can't be split this way.
+ */
+SkCodec::Result SkJpegCodec::decodeRestartIntervals(const SkImageInfo& dstInfo, void* dst,
+                                                    size_t dstRowBytes, const Options& options) {
+    const jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const uint8_t* data = static_cast<const uint8_t*>(this->stream()->getMemoryBase());
+    if (!options.fExecutor || !data || !this->stream()->hasLength() ||
+        dinfo->restart_interval == 0 || dinfo->progressive_mode || dinfo->arith_code ||
+        dinfo->comps_in_scan != dinfo->num_components || JCS_CMYK == dinfo->out_color_space ||
+        dstInfo.dimensions() != this->dimensions()) {
+        return kUnimplemented;
+    }
+
+    RestartIndex index;
+    if (!index_restart_markers(data, this->stream()->getLength(), &index)) {
+        return kUnimplemented;
+    }
+
+    // A single component scan codes one block per MCU, whatever its sampling factors.
+    const bool interleaved = dinfo->num_components > 1;
+    const int width = this->dimensions().width(),
+              height = this->dimensions().height(),
+              mcuWidth = interleaved ? DCTSIZE * dinfo->max_h_samp_factor : DCTSIZE,
+              mcuHeight = interleaved ? DCTSIZE * dinfo->max_v_samp_factor : DCTSIZE,
+              mcusPerRow = (width + mcuWidth - 1) / mcuWidth,
+              mcuRows = (height + mcuHeight - 1) / mcuHeight;
+    const int64_t interval = dinfo->restart_interval;
+    if (index.intervals() != ((int64_t)mcusPerRow * mcuRows + interval - 1) / interval) {
+        return kUnimplemented;
+    }
+
+    // Vertically upsampled chroma blends in the MCU rows on either side, so bands that need
+    // it are decoded from the restart interval before them to the one after them.
+    bool needsContext = false;
+    for (int i = 0; i < dinfo->num_components; i++) {
+        needsContext |= dinfo->comp_info[i].v_samp_factor != dinfo->max_v_samp_factor;
+    }
+
+    // MCU rows a band can start on, followed by mcuRows.
+    std::vector<int> startRows;
+    for (int row = 0; row < mcuRows; row++) {
+        if ((int64_t)row * mcusPerRow % interval == 0) {
+            startRows.push_back(row);
+        }
+    }
+    startRows.push_back(mcuRows);
+
+    // Aim for enough bands to keep a handful of threads busy, without paying for the overlap
+    // and per-band setup on small images.
+    constexpr int kMinBandMCURows = 4,
+                  kMaxBands       = 16;
+    const int bandRows = std::max(kMinBandMCURows, (mcuRows + kMaxBands - 1) / kMaxBands);
+    std::vector<int> bands = {0};  // Indices into startRows.
+    for (int i = 1; i < SkToInt(startRows.size()); i++) {
+        if (startRows[i] - startRows[bands.back()] >= bandRows || startRows[i] == mcuRows) {
+            bands.push_back(i);
+        }
+    }
+    if (bands.size() < 3) {
+        return kUnimplemented;
+    }
+
+    auto intervalAt = [&](int row) {
+        return row == mcuRows ? index.intervals() : SkToInt(row * (int64_t)mcusPerRow / interval);
+    };
+    auto decode = [&](int b) {
+        const int first = bands[b],
+                  last  = bands[b + 1],
+                  from  = needsContext && first > 0 ? first - 1 : first,
+                  to    = needsContext && startRows[last] < mcuRows ? last + 1 : last;
+        const int bandTop    = startRows[from] * mcuHeight,
+                  dstTop     = startRows[first] * mcuHeight,
+                  dstBottom  = std::min(height, startRows[last] * mcuHeight),
+                  bandBottom = std::min(height, startRows[to] * mcuHeight);
+
+        std::vector<uint8_t> band;
+        make_band_jpeg(data, index, intervalAt(startRows[from]), intervalAt(startRows[to]),
+                       bandBottom - bandTop, &band);
+        return this->decodeBand(band, dstInfo, SkTAddOffset<void>(dst, dstTop * dstRowBytes),
+                                dstRowBytes, bandTop, dstTop, dstBottom);
+    };
+
+    SkTaskGroup tg(*options.fExecutor);
+    const bool ok = tg.parallel_for(0, SkToInt(bands.size()) - 1, 1, [&](int begin, int end) {
+        for (int b = begin; b < end; b++) {
+            if (!decode(b)) {
+                return false;
+            }
+        }
+        return true;
+    });
+    return ok ? kSuccess : kUnimplemented;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -532,6 +796,12 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    // Restart markers let us decode bands of the image independently.  If this doesn't work
+    // out, fall back to decoding it serially.
+    if (kSuccess == this->decodeRestartIntervals(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
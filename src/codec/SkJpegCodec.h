@@ -14,6 +14,8 @@
 #include "include/private/SkTemplates.h"
 #include "src/codec/SkSwizzler.h"
 
+#include <vector>
+
 class JpegDecoderMgr;
 
 /*
@@ -109,6 +111,14 @@ private:
     bool SK_WARN_UNUSED_RESULT allocateStorage(const SkImageInfo& dstInfo);
     int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
 
+    /*
+     * Parallel decoding of JPEGs with restart markers, see Options::fExecutor.
+     */
+    Result decodeRestartIntervals(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+                                  const Options&);
+    bool decodeBand(const std::vector<uint8_t>& band, const SkImageInfo& dstInfo, void* dst,
+                    size_t dstRowBytes, int bandTop, int dstTop, int dstBottom) const;
+
     /*
      * Scanline decoding.
      */
@@ -137,6 +147,7 @@ private:
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
     friend class SkRawCodec;
+    friend class SkJpegCodecTestingAccess;  // for decodeRestartIntervals()
 
     using INHERITED = SkCodec;
 };
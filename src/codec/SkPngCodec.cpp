@@ -133,6 +133,16 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
 
 static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
         SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
+    // If the stream is backed by memory (e.g. an SkData, which may be mmapped), hand libpng
+    // the bytes in place instead of copying them through buffer. libpng only reads them.
+    const uint8_t* base = static_cast<const uint8_t*>(stream->getMemoryBase());
+    if (base && stream->hasPosition()) {
+        const size_t position = stream->getPosition();
+        const size_t bytesRead = stream->skip(length);
+        png_process_data(png_ptr, info_ptr, const_cast<png_bytep>(base + position), bytesRead);
+        return bytesRead == length;
+    }
+
     while (length > 0) {
         const size_t bytesToProcess = std::min(bufferSize, length);
         const size_t bytesRead = stream->read(buffer, bytesToProcess);
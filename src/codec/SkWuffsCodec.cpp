@@ -60,7 +60,36 @@
 #define SK_WUFFS_INITIALIZE_FLAGS WUFFS_INITIALIZE__DEFAULT_OPTIONS
 #endif
 
+// Returns whether b reads straight from s's memory, as set up by make_io_buffer, rather
+// than from a copy of s in a fixed size buffer.
+static bool reads_in_place(const wuffs_base__io_buffer* b, SkStream* s) {
+    return b->data.ptr && b->data.ptr == s->getMemoryBase();
+}
+
+// If s is backed by memory (e.g. an SkData, which may be mmapped), wrap all of it, so Wuffs
+// can read it in place. Otherwise, fill_buffer will copy s into buffer as it's needed.
+static wuffs_base__io_buffer make_io_buffer(SkStream* s, uint8_t* buffer, size_t bufferLen) {
+    const void* base = s->getMemoryBase();
+    if (base && s->hasLength()) {
+        // Wuffs never writes through the data of an io_buffer it reads from. Only
+        // fill_buffer's compact() would, and it isn't called on this one.
+        const size_t len = s->getLength();
+        return wuffs_base__make_io_buffer(
+            wuffs_base__make_slice_u8(static_cast<uint8_t*>(const_cast<void*>(base)), len),
+            wuffs_base__make_io_buffer_meta(len, 0, 0, true));
+    }
+    return wuffs_base__make_io_buffer(wuffs_base__make_slice_u8(buffer, bufferLen),
+                                      wuffs_base__empty_io_buffer_meta());
+}
+
 static bool fill_buffer(wuffs_base__io_buffer* b, SkStream* s) {
+    if (reads_in_place(b, s)) {
+        // All of s is already in b, so this only makes it readable again after a reset.
+        const bool grew = b->meta.wi < b->data.len;
+        b->meta.wi = b->data.len;
+        b->meta.closed = true;
+        return grew;
+    }
     b->compact();
     size_t num_read = s->read(b->data.ptr + b->meta.wi, b->data.len - b->meta.wi);
     b->meta.wi += num_read;
@@ -69,6 +98,13 @@ static bool fill_buffer(wuffs_base__io_buffer* b, SkStream* s) {
 }
 
 static bool seek_buffer(wuffs_base__io_buffer* b, SkStream* s, uint64_t pos) {
+    if (reads_in_place(b, s)) {
+        if (pos > b->data.len) {
+            return false;
+        }
+        b->meta = wuffs_base__make_io_buffer_meta(b->data.len, pos, 0, true);
+        return true;
+    }
     // Try to re-position the io_buffer's meta.ri read-index first, which is
     // cheaper than seeking in the backing SkStream.
     if ((pos >= b->meta.pos) && (pos - b->meta.pos <= b->meta.wi)) {
@@ -365,9 +401,17 @@ SkWuffsCodec::SkWuffsCodec(SkEncodedInfo&&
       fDecoderIsSuspended(false) {
     fFrameHolder.init(this, imgcfg.pixcfg.width(), imgcfg.pixcfg.height());
 
-    // Initialize fIOBuffer's fields, copying any outstanding data from iobuf to
-    // fIOBuffer, as iobuf's backing array may not be valid for the lifetime of
-    // this SkWuffsCodec object, but fIOBuffer's backing array (fBuffer) is.
+    // If iobuf reads from fStream's memory in place, it stays valid for the
+    // lifetime of this SkWuffsCodec object, which owns fStream.
+    if (reads_in_place(&iobuf, fStream.get())) {
+        fIOBuffer = iobuf;
+        return;
+    }
+
+    // Otherwise, initialize fIOBuffer's fields, copying any outstanding data
+    // from iobuf to fIOBuffer, as iobuf's backing array may not be valid for
+    // the lifetime of this SkWuffsCodec object, but fIOBuffer's backing array
+    // (fBuffer) is.
     SkASSERT(iobuf.data.len == SK_WUFFS_CODEC_BUFFER_SIZE);
     memmove(fBuffer, iobuf.data.ptr, iobuf.meta.wi);
     fIOBuffer.data = wuffs_base__make_slice_u8(fBuffer, SK_WUFFS_CODEC_BUFFER_SIZE);
@@ -927,8 +971,7 @@ std::unique_ptr<SkCodec> SkWuffsCodec_MakeFromStream(std::unique_ptr<SkStream> s
 
     uint8_t               buffer[SK_WUFFS_CODEC_BUFFER_SIZE];
     wuffs_base__io_buffer iobuf =
-        wuffs_base__make_io_buffer(wuffs_base__make_slice_u8(buffer, SK_WUFFS_CODEC_BUFFER_SIZE),
-                                   wuffs_base__empty_io_buffer_meta());
+        make_io_buffer(stream.get(), buffer, SK_WUFFS_CODEC_BUFFER_SIZE);
     wuffs_base__image_config imgcfg = wuffs_base__null_image_config();
 
     // Wuffs is primarily a C library, not a C++ one. Furthermore, outside of
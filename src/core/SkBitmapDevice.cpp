@@ -70,6 +70,8 @@ public:
     SkDrawTiler(SkBitmapDevice* dev, const SkRect* bounds) : fDevice(dev) {
         fDone = false;
 
+        dev->addDamage(dev->localToDevice(), bounds);
+
         // we need fDst to be set, and if we're actually drawing, to dirty the genID
         if (!dev->accessPixels(&fRootPixmap)) {
             // NoDrawDevice uses us (why?) so we have to catch this case w/ no pixels
@@ -194,6 +196,8 @@ public:
         }
         fMatrixProvider = dev;
         fRC = &dev->fRCStack.rc();
+
+        dev->addDamage(dev->localToDevice(), nullptr);
     }
 };
 
@@ -323,6 +327,9 @@ bool SkBitmapDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
     }
 
     if (fBitmap.writePixels(pm, x, y)) {
+        if (fDamageTracker) {
+            fDamageTracker->add(SkIRect::MakeXYWH(x, y, pm.width(), pm.height()));
+        }
         fBitmap.notifyPixelsChanged();
         return true;
     }
@@ -333,6 +340,22 @@ bool SkBitmapDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
     return fBitmap.readPixels(pm, x, y);
 }
 
+void SkBitmapDevice::addDamage(const SkMatrix& localToDevice, const SkRect* localBounds) {
+    if (!fDamageTracker) {
+        return;
+    }
+
+    SkIRect devBounds = fRCStack.rc().getBounds();
+    if (localBounds) {
+        // Outset by a pixel for anti-aliasing, as SkCanvas::quickReject() does.
+        SkIRect drawBounds = localToDevice.mapRect(*localBounds).roundOut();
+        if (!devBounds.intersect(drawBounds.makeOutset(1, 1))) {
+            return;
+        }
+    }
+    fDamageTracker->add(devBounds);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkBitmapDevice::drawPaint(const SkPaint& paint) {
@@ -341,7 +364,20 @@ void SkBitmapDevice::drawPaint(const SkPaint& paint) {
 
 void SkBitmapDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
                                 const SkPoint pts[], const SkPaint& paint) {
-    LOOP_TILER( drawPoints(mode, count, pts, paint, nullptr), nullptr)
+    // The tiler doesn't need bounds for points, but damage tracking does.
+    SkRect bounds;
+    const SkRect* boundsPtr = nullptr;
+    if (fDamageTracker && bounds.setBoundsCheck(pts, count)) {
+        // Points are always stroked, whatever the paint's style; bound them as SkCanvas does.
+        SkPaint strokePaint = paint;
+        strokePaint.setStyle(SkPaint::kStroke_Style);
+        Bounder bounder(bounds, strokePaint);
+        if (bounder.hasBounds()) {
+            bounds = bounder.fBounds;
+            boundsPtr = &bounds;
+        }
+    }
+    LOOP_TILER( drawPoints(mode, count, pts, paint, nullptr), boundsPtr)
 }
 
 void SkBitmapDevice::drawRect(const SkRect& r, const SkPaint& paint) {
@@ -368,7 +404,7 @@ void SkBitmapDevice::drawPath(const SkPath& path,
                               const SkPaint& paint,
                               bool pathIsMutable) {
     const SkRect* bounds = nullptr;
-    if (SkDrawTiler::NeedsTiling(this) && !path.isInverseFillType()) {
+    if ((SkDrawTiler::NeedsTiling(this) || fDamageTracker) && !path.isInverseFillType()) {
         bounds = &path.getBounds();
     }
     SkDrawTiler tiler(this, bounds ? Bounder(*bounds, paint).bounds() : nullptr);
@@ -385,7 +421,7 @@ void SkBitmapDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
                                 const SkPaint& paint) {
     const SkRect* bounds = dstOrNull;
     SkRect storage;
-    if (!bounds && SkDrawTiler::NeedsTiling(this)) {
+    if (!bounds && (SkDrawTiler::NeedsTiling(this) || fDamageTracker)) {
         matrix.mapRect(&storage, SkRect::MakeIWH(bitmap.width(), bitmap.height()));
         Bounder b(storage, paint);
         if (b.hasBounds()) {
@@ -525,7 +561,9 @@ void SkBitmapDevice::onDrawGlyphRunList(SkCanvas* canvas,
                                         const SkGlyphRunList& glyphRunList,
                                         const SkPaint& paint) {
     SkASSERT(!glyphRunList.hasRSXForm());
-    LOOP_TILER( drawGlyphRunList(canvas, &fGlyphPainter, glyphRunList, paint), nullptr )
+    // Only damage tracking needs the bounds of glyphs.
+    LOOP_TILER( drawGlyphRunList(canvas, &fGlyphPainter, glyphRunList, paint),
+                fDamageTracker ? Bounder(glyphRunList.sourceBounds(), paint).bounds() : nullptr )
 }
 
 void SkBitmapDevice::drawVertices(const SkVertices* vertices,
@@ -580,6 +618,9 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src,
 
     SkBitmap resultBM;
     if (src->getROPixels(&resultBM)) {
+        const SkRect bounds = SkRect::Make(resultBM.bounds());
+        this->addDamage(localToDevice, &bounds);
+
         SkDraw draw;
         SkMatrixProvider matrixProvider(localToDevice);
         if (!this->accessPixels(&draw.fDst)) {
@@ -15,11 +15,14 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSize.h"
+#include "src/core/SkDamageTracker.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkGlyphRunPainter.h"
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRasterClipStack.h"
 
+#include <memory>
+
 class SkImageFilterCache;
 class SkMatrix;
 class SkPaint;
@@ -150,11 +153,19 @@ private:
 
     SkImageFilterCache* getImageFilterCache() override;
 
+    // Marks the pixels a draw may touch as damaged, if damage is being tracked. localBounds are
+    // the draw's conservative bounds, including the paint's outset; without them the draw may
+    // touch anything inside the clip.
+    void addDamage(const SkMatrix& localToDevice, const SkRect* localBounds);
+
     SkBitmap    fBitmap;
     void*       fRasterHandle = nullptr;
     SkRasterClipStack  fRCStack;
     SkGlyphRunListPainter fGlyphPainter;
 
+    // Only set for the base device of a raster SkSurface that tracks damage.
+    std::unique_ptr<SkDamageTracker> fDamageTracker;
+
 
     using INHERITED = SkBaseDevice;
 };
@@ -27,6 +27,8 @@
 #include "src/core/SkXfermodeInterpretation.h"
 #include "src/shaders/SkShaderBase.h"
 
+#include <algorithm>
+
 // Hacks for testing.
 bool gUseSkVMBlitter{false};
 bool gSkForceRasterPipelineBlitter{false};
@@ -122,6 +124,30 @@ void SkBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
     }
 }
 
+void SkBlitter::blitSpans(const Span spans[], int count) {
+    // blitAntiH() may split runs in place (see SkAlphaRuns::Break), so partially covered spans
+    // go out in chunks small enough to give every pixel its own runs[] and aa[] entry.
+    constexpr int kChunk = 64;
+    int16_t runs[kChunk + 1];
+    SkAlpha aa[kChunk];
+
+    for (int i = 0; i < count; ++i) {
+        const Span& span = spans[i];
+        SkASSERT(span.fWidth > 0);
+        if (span.fAlpha == 0xFF) {
+            this->blitH(span.fX, span.fY, span.fWidth);
+        } else if (span.fAlpha != 0) {
+            for (int x = span.fX, stop = span.fX + span.fWidth; x < stop; x += kChunk) {
+                int n = std::min(kChunk, stop - x);
+                runs[0] = SkToS16(n);
+                runs[n] = 0;
+                aa[0]   = span.fAlpha;
+                this->blitAntiH(x, span.fY, aa, runs);
+            }
+        }
+    }
+}
+
 void SkBlitter::blitRect(int x, int y, int width, int height) {
     SkASSERT(width > 0);
     while (--height >= 0) {
@@ -298,6 +324,8 @@ void SkNullBlitter::blitAntiH(int x, int y, const SkAlpha antialias[],
 
 void SkNullBlitter::blitV(int x, int y, int height, SkAlpha alpha) {}
 
+void SkNullBlitter::blitSpans(const Span[], int count) {}
+
 void SkNullBlitter::blitRect(int x, int y, int width, int height) {}
 
 void SkNullBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {}
@@ -391,6 +419,21 @@ void SkRectClipBlitter::blitAntiH(int left, int y, const SkAlpha aa[],
     fBlitter->blitAntiH(x0, y, aa, runs);
 }
 
+void SkRectClipBlitter::blitSpans(const Span spans[], int count) {
+    SkSpanBatcher batcher(fBlitter);
+    for (int i = 0; i < count; ++i) {
+        const Span& span = spans[i];
+        if (!y_in_rect(span.fY, fClipRect)) {
+            continue;
+        }
+        int left  = std::max(span.fX, fClipRect.fLeft),
+            right = std::min(span.fX + span.fWidth, fClipRect.fRight);
+        if (left < right) {
+            batcher.add(left, span.fY, right - left, span.fAlpha);
+        }
+    }
+}
+
 void SkRectClipBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
     SkASSERT(height > 0);
 
@@ -518,6 +561,19 @@ void SkRgnClipBlitter::blitAntiH(int x, int y, const SkAlpha aa[],
     }
 }
 
+void SkRgnClipBlitter::blitSpans(const Span spans[], int count) {
+    SkSpanBatcher batcher(fBlitter);
+    for (int i = 0; i < count; ++i) {
+        const Span& span = spans[i];
+        SkRegion::Spanerator iter(*fRgn, span.fY, span.fX, span.fX + span.fWidth);
+        int left, right;
+        while (iter.next(&left, &right)) {
+            SkASSERT(left < right);
+            batcher.add(left, span.fY, right - left, span.fAlpha);
+        }
+    }
+}
+
 void SkRgnClipBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
     SkIRect    bounds;
     bounds.setXYWH(x, y, 1, height);
@@ -847,6 +903,14 @@ void SkRectClipCheckBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const i
     fBlitter->blitAntiH(x, y, aa, runs);
 }
 
+void SkRectClipCheckBlitter::blitSpans(const Span spans[], int count) {
+    for (int i = 0; i < count; ++i) {
+        SkASSERT(fClipRect.contains(SkIRect::MakeXYWH(spans[i].fX, spans[i].fY,
+                                                      spans[i].fWidth, 1)));
+    }
+    fBlitter->blitSpans(spans, count);
+}
+
 void SkRectClipCheckBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
     SkASSERT(fClipRect.contains(SkIRect::MakeXYWH(x, y, 1, height)));
     fBlitter->blitV(x, y, height, alpha);
@@ -53,6 +53,19 @@ public:
     /// Blit a vertical run of pixels with a constant alpha value.
     virtual void blitV(int x, int y, int height, SkAlpha alpha);
 
+    /// A horizontal run of width pixels at (x, y), all with the same alpha.
+    struct Span {
+        int     fY;
+        int     fX;
+        int     fWidth;
+        SkAlpha fAlpha;
+    };
+
+    /// Blit count spans in order. Scan converters that produce one short run per edge pair
+    /// collect them with SkSpanBatcher so that they make one virtual call per batch rather than
+    /// one per span. The default calls blitH() for opaque spans and blitAntiH() for the rest.
+    virtual void blitSpans(const Span spans[], int count);
+
     /// Blit a solid rectangle one or more pixels wide.
     virtual void blitRect(int x, int y, int width, int height);
 
@@ -159,6 +172,42 @@ protected:
     SkAutoMalloc fBlitMemory;
 };
 
+/** Collects spans for SkBlitter::blitSpans(), passing them on whenever the buffer fills up, on
+    flush(), and when it goes out of scope. Anything else drawn through the same blitter must be
+    preceded by a flush() so that blits still arrive in order.
+*/
+class SkSpanBatcher {
+public:
+    explicit SkSpanBatcher(SkBlitter* blitter) : fBlitter(blitter) {}
+    ~SkSpanBatcher() { this->flush(); }
+
+    SkSpanBatcher(const SkSpanBatcher&) = delete;
+    SkSpanBatcher& operator=(const SkSpanBatcher&) = delete;
+
+    void add(int x, int y, int width, SkAlpha alpha = 0xFF) {
+        SkASSERT(width > 0);
+        if (fCount == kMaxSpans) {
+            this->flush();
+        }
+        fSpans[fCount++] = {y, x, width, alpha};
+    }
+
+    void flush() {
+        if (fCount > 0) {
+            fBlitter->blitSpans(fSpans, fCount);
+            fCount = 0;
+        }
+    }
+
+private:
+    // Enough to cover a few rows of a complex path while staying cheap to keep on the stack.
+    static constexpr int kMaxSpans = 64;
+
+    SkBlitter*      fBlitter;
+    int             fCount = 0;
+    SkBlitter::Span fSpans[kMaxSpans];
+};
+
 /** This blitter silently never draws anything.
 */
 class SkNullBlitter : public SkBlitter {
@@ -166,6 +215,7 @@ public:
     void blitH(int x, int y, int width) override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t runs[]) override;
     void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitSpans(const Span[], int count) override;
     void blitRect(int x, int y, int width, int height) override;
     void blitMask(const SkMask&, const SkIRect& clip) override;
     const SkPixmap* justAnOpaqueColor(uint32_t* value) override;
@@ -187,6 +237,7 @@ public:
     void blitH(int x, int y, int width) override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t runs[]) override;
     void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitSpans(const Span[], int count) override;
     void blitRect(int x, int y, int width, int height) override;
     void blitAntiRect(int x, int y, int width, int height,
                       SkAlpha leftAlpha, SkAlpha rightAlpha) override;
@@ -221,6 +272,7 @@ public:
     void blitH(int x, int y, int width) override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t runs[]) override;
     void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitSpans(const Span[], int count) override;
     void blitRect(int x, int y, int width, int height) override;
     void blitAntiRect(int x, int y, int width, int height,
                       SkAlpha leftAlpha, SkAlpha rightAlpha) override;
@@ -253,6 +305,7 @@ public:
     void blitH(int x, int y, int width) override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t runs[]) override;
     void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitSpans(const Span[], int count) override;
     void blitRect(int x, int y, int width, int height) override;
     void blitAntiRect(int x, int y, int width, int height,
                               SkAlpha leftAlpha, SkAlpha rightAlpha) override;
@@ -46,7 +46,7 @@
 
 class SkBlurMaskFilterImpl : public SkMaskFilterBase {
 public:
-    SkBlurMaskFilterImpl(SkScalar sigma, SkBlurStyle, bool respectCTM);
+    SkBlurMaskFilterImpl(SkScalar sigma, SkBlurStyle, bool respectCTM, SkBlurQuality);
 
     // overrides from SkMaskFilter
     SkMask::Format getFormat() const override;
@@ -100,9 +100,14 @@ private:
     // a request like 10,000)
     static const SkScalar kMAX_BLUR_SIGMA;
 
-    SkScalar    fSigma;
-    SkBlurStyle fBlurStyle;
-    bool        fRespectCTM;
+    // Serialized alongside ignoreCTM since kBlurMaskFilterQuality. Bit 1 was used by older
+    // pictures, so skip it.
+    static constexpr uint32_t kFastApproximate_Flag = 1 << 2;
+
+    SkScalar      fSigma;
+    SkBlurStyle   fBlurStyle;
+    bool          fRespectCTM;
+    SkBlurQuality fQuality;
 
     SkBlurMaskFilterImpl(SkReadBuffer&);
     void flatten(SkWriteBuffer&) const override;
@@ -112,6 +117,8 @@ private:
         return std::min(xformedSigma, kMAX_BLUR_SIGMA);
     }
 
+    SkBlurQuality quality() const { return fQuality; }
+
     friend class SkBlurMaskFilter;
 
     using INHERITED = SkMaskFilter;
@@ -122,10 +129,12 @@ const SkScalar SkBlurMaskFilterImpl::kMAX_BLUR_SIGMA = SkIntToScalar(128);
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SkBlurMaskFilterImpl::SkBlurMaskFilterImpl(SkScalar sigma, SkBlurStyle style, bool respectCTM)
+SkBlurMaskFilterImpl::SkBlurMaskFilterImpl(SkScalar sigma, SkBlurStyle style, bool respectCTM,
+                                           SkBlurQuality quality)
     : fSigma(sigma)
     , fBlurStyle(style)
-    , fRespectCTM(respectCTM) {
+    , fRespectCTM(respectCTM)
+    , fQuality(quality) {
     SkASSERT(fSigma > 0);
     SkASSERT((unsigned)style <= kLastEnum_SkBlurStyle);
 }
@@ -150,7 +159,7 @@ bool SkBlurMaskFilterImpl::filterMask(SkMask* dst, const SkMask& src,
                                       const SkMatrix& matrix,
                                       SkIPoint* margin) const {
     SkScalar sigma = this->computeXformedSigma(matrix);
-    return SkBlurMask::BoxBlur(dst, src, sigma, fBlurStyle, margin);
+    return SkBlurMask::BoxBlur(dst, src, sigma, fBlurStyle, margin, this->quality());
 }
 
 bool SkBlurMaskFilterImpl::filterRectMask(SkMask* dst, const SkRect& r,
@@ -256,29 +265,31 @@ static SkCachedData* copy_mask_to_cacheddata(SkMask* mask) {
 }
 
 static SkCachedData* find_cached_rrect(SkMask* mask, SkScalar sigma, SkBlurStyle style,
-                                       const SkRRect& rrect) {
-    return SkMaskCache::FindAndRef(sigma, style, rrect, mask);
+                                       SkMaskBlurFilter::Quality quality, const SkRRect& rrect) {
+    return SkMaskCache::FindAndRef(sigma, style, quality, rrect, mask);
 }
 
 static SkCachedData* add_cached_rrect(SkMask* mask, SkScalar sigma, SkBlurStyle style,
-                                      const SkRRect& rrect) {
+                                      SkMaskBlurFilter::Quality quality, const SkRRect& rrect) {
     SkCachedData* cache = copy_mask_to_cacheddata(mask);
     if (cache) {
-        SkMaskCache::Add(sigma, style, rrect, *mask, cache);
+        SkMaskCache::Add(sigma, style, quality, rrect, *mask, cache);
     }
     return cache;
 }
 
 static SkCachedData* find_cached_rects(SkMask* mask, SkScalar sigma, SkBlurStyle style,
+                                       SkMaskBlurFilter::Quality quality,
                                        const SkRect rects[], int count) {
-    return SkMaskCache::FindAndRef(sigma, style, rects, count, mask);
+    return SkMaskCache::FindAndRef(sigma, style, quality, rects, count, mask);
 }
 
 static SkCachedData* add_cached_rects(SkMask* mask, SkScalar sigma, SkBlurStyle style,
+                                      SkMaskBlurFilter::Quality quality,
                                       const SkRect rects[], int count) {
     SkCachedData* cache = copy_mask_to_cacheddata(mask);
     if (cache) {
-        SkMaskCache::Add(sigma, style, rects, count, *mask, cache);
+        SkMaskCache::Add(sigma, style, quality, rects, count, *mask, cache);
     }
     return cache;
 }
@@ -361,21 +372,33 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
     const SkScalar stretchSize = SkIntToScalar(3);
 
     const SkScalar totalSmallWidth = leftUnstretched + rightUnstretched + stretchSize;
-    if (totalSmallWidth >= rrect.rect().width()) {
-        // There is no valid piece to stretch.
-        return kUnimplemented_FilterReturn;
-    }
-
     const SkScalar topUnstretched = std::max(UL.fY, UR.fY) + SkIntToScalar(2 * margin.fY);
     const SkScalar bottomUnstretched = std::max(LL.fY, LR.fY) + SkIntToScalar(2 * margin.fY);
-
     const SkScalar totalSmallHeight = topUnstretched + bottomUnstretched + stretchSize;
-    if (totalSmallHeight >= rrect.rect().height()) {
+
+    // An axis too short to have a piece to stretch is blurred at its full length instead, keeping
+    // its fractional phase so the mask lines up with dstM. Only that length then goes into the
+    // cache key, so rrects that differ just along the other axis (a pill-shaped shadow growing
+    // wider, say) still share one cached mask.
+    const SkRect& r = rrect.rect();
+    const bool stretchX = totalSmallWidth  < r.width(),
+               stretchY = totalSmallHeight < r.height();
+    if (!stretchX && !stretchY) {
         // There is no valid piece to stretch.
         return kUnimplemented_FilterReturn;
     }
 
     SkRect smallR = SkRect::MakeWH(totalSmallWidth, totalSmallHeight);
+    if (!stretchX) {
+        const SkScalar dx = SkScalarFloorToScalar(r.fLeft);
+        smallR.fLeft  = r.fLeft  - dx;
+        smallR.fRight = r.fRight - dx;
+    }
+    if (!stretchY) {
+        const SkScalar dy = SkScalarFloorToScalar(r.fTop);
+        smallR.fTop    = r.fTop    - dy;
+        smallR.fBottom = r.fBottom - dy;
+    }
 
     SkRRect smallRR;
     SkVector radii[4];
@@ -386,7 +409,8 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
     smallRR.setRectRadii(smallR, radii);
 
     const SkScalar sigma = this->computeXformedSigma(matrix);
-    SkCachedData* cache = find_cached_rrect(&patch->fMask, sigma, fBlurStyle, smallRR);
+    SkCachedData* cache = find_cached_rrect(&patch->fMask, sigma, fBlurStyle, this->quality(),
+                                            smallRR);
     if (!cache) {
         bool analyticBlurWorked = false;
         if (c_analyticBlurRRect) {
@@ -406,13 +430,29 @@ SkBlurMaskFilterImpl::filterRRectToNine(const SkRRect& rrect, const SkMatrix& ma
                 return kFalse_FilterReturn;
             }
         }
-        cache = add_cached_rrect(&patch->fMask, sigma, fBlurStyle, smallRR);
+        cache = add_cached_rrect(&patch->fMask, sigma, fBlurStyle, this->quality(), smallRR);
+    }
+
+    // An unstretched axis must cover dstM exactly, since none of it will be repeated.
+    if ((!stretchX && patch->fMask.fBounds.width()  != dstM.fBounds.width()) ||
+        (!stretchY && patch->fMask.fBounds.height() != dstM.fBounds.height())) {
+        if (cache) {
+            cache->unref();
+        } else {
+            SkMask::FreeImage(patch->fMask.fImage);
+        }
+        patch->fMask.fImage = nullptr;
+        return kUnimplemented_FilterReturn;
     }
 
     patch->fMask.fBounds.offsetTo(0, 0);
     patch->fOuterRect = dstM.fBounds;
-    patch->fCenter.fX = SkScalarCeilToInt(leftUnstretched) + 1;
-    patch->fCenter.fY = SkScalarCeilToInt(topUnstretched) + 1;
+    // Putting the center past the end of an unstretched axis makes the corner pieces span the
+    // whole mask along it, and leaves nothing in between to stretch.
+    patch->fCenter.fX = stretchX ? SkScalarCeilToInt(leftUnstretched) + 1
+                                 : patch->fMask.fBounds.width();
+    patch->fCenter.fY = stretchY ? SkScalarCeilToInt(topUnstretched) + 1
+                                 : patch->fMask.fBounds.height();
     SkASSERT(nullptr == patch->fCache);
     patch->fCache = cache;  // transfer ownership to patch
     return kTrue_FilterReturn;
@@ -520,7 +560,8 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
     }
 
     const SkScalar sigma = this->computeXformedSigma(matrix);
-    SkCachedData* cache = find_cached_rects(&patch->fMask, sigma, fBlurStyle, smallR, count);
+    SkCachedData* cache = find_cached_rects(&patch->fMask, sigma, fBlurStyle, this->quality(),
+                                            smallR, count);
     if (!cache) {
         if (count > 1 || !c_analyticBlurNinepatch) {
             if (!draw_rects_into_mask(smallR, count, &srcM)) {
@@ -538,7 +579,8 @@ SkBlurMaskFilterImpl::filterRectsToNine(const SkRect rects[], int count,
                 return kFalse_FilterReturn;
             }
         }
-        cache = add_cached_rects(&patch->fMask, sigma, fBlurStyle, smallR, count);
+        cache = add_cached_rects(&patch->fMask, sigma, fBlurStyle, this->quality(),
+                                 smallR, count);
     }
     patch->fMask.fBounds.offsetTo(0, 0);
     patch->fOuterRect = dstM.fBounds;
@@ -563,16 +605,23 @@ sk_sp<SkFlattenable> SkBlurMaskFilterImpl::CreateProc(SkReadBuffer& buffer) {
     const SkScalar sigma = buffer.readScalar();
     SkBlurStyle style = buffer.read32LE(kLastEnum_SkBlurStyle);
 
-    uint32_t flags = buffer.read32LE(0x3);  // historically we only recorded 2 bits
+    // historically we only recorded 2 bits
+    const uint32_t maxFlags =
+            buffer.isVersionLT(SkPicturePriv::kBlurMaskFilterQuality) ? 0x3 : 0x7;
+    uint32_t flags = buffer.read32LE(maxFlags);
     bool respectCTM = !(flags & 1); // historically we stored ignoreCTM in low bit
+    SkBlurQuality quality = (flags & kFastApproximate_Flag) ? SkBlurQuality::kFastApproximate
+                                                            : SkBlurQuality::kExact;
 
-    return SkMaskFilter::MakeBlur((SkBlurStyle)style, sigma, respectCTM);
+    return SkMaskFilter::MakeBlur((SkBlurStyle)style, sigma, respectCTM, quality);
 }
 
 void SkBlurMaskFilterImpl::flatten(SkWriteBuffer& buffer) const {
     buffer.writeScalar(fSigma);
     buffer.writeUInt(fBlurStyle);
-    buffer.writeUInt(!fRespectCTM); // historically we recorded ignoreCTM
+    // historically we recorded ignoreCTM
+    buffer.writeUInt(!fRespectCTM |
+                     (fQuality == SkBlurQuality::kFastApproximate ? kFastApproximate_Flag : 0));
 }
 
 
@@ -1659,9 +1708,10 @@ GrSurfaceProxyView SkBlurMaskFilterImpl::filterMaskGPU(GrRecordingContext* conte
 
 void sk_register_blur_maskfilter_createproc() { SK_REGISTER_FLATTENABLE(SkBlurMaskFilterImpl); }
 
-sk_sp<SkMaskFilter> SkMaskFilter::MakeBlur(SkBlurStyle style, SkScalar sigma, bool respectCTM) {
+sk_sp<SkMaskFilter> SkMaskFilter::MakeBlur(SkBlurStyle style, SkScalar sigma, bool respectCTM,
+                                           SkBlurQuality quality) {
     if (SkScalarIsFinite(sigma) && sigma > 0) {
-        return sk_sp<SkMaskFilter>(new SkBlurMaskFilterImpl(sigma, style, respectCTM));
+        return sk_sp<SkMaskFilter>(new SkBlurMaskFilterImpl(sigma, style, respectCTM, quality));
     }
     return nullptr;
 }
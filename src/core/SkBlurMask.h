@@ -12,6 +12,7 @@
 #include "include/core/SkRRect.h"
 #include "include/core/SkShader.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 
 class SkBlurMask {
 public:
@@ -34,10 +35,14 @@ public:
     // * calculate margin - if src.fImage is null, then this call only calculates the border.
     // * failure          - if src.fImage is not null, failure is signal with dst->fImage being
     //                      null.
+    // * quality          - kFastApproximate trades some accuracy at small sigmas for speed; see
+    //                      SkMaskBlurFilter::Quality. The margin depends on it too.
 
     static bool SK_WARN_UNUSED_RESULT BoxBlur(SkMask* dst, const SkMask& src,
                                               SkScalar sigma, SkBlurStyle style,
-                                              SkIPoint* margin = nullptr);
+                                              SkIPoint* margin = nullptr,
+                                              SkMaskBlurFilter::Quality quality =
+                                                  SkMaskBlurFilter::Quality::kExact);
 
     // the "ground truth" blur does a gaussian convolution; it's slow
     // but useful for comparison purposes.
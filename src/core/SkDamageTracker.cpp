@@ -0,0 +1,70 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkDamageTracker.h"
+
+#include "include/core/SkRegion.h"
+#include "include/private/SkTo.h"
+
+#include <algorithm>
+
+SkDamageTracker::SkDamageTracker(SkISize deviceSize, int tileSize)
+        : fDeviceBounds(SkIRect::MakeSize(deviceSize))
+        , fTileSize(tileSize)
+        , fCols(SkToInt((deviceSize.width()  + (int64_t)tileSize - 1) / tileSize))
+        , fRows(SkToInt((deviceSize.height() + (int64_t)tileSize - 1) / tileSize))
+        , fDirty(fCols * fRows, false) {
+    SkASSERT(tileSize > 0);
+}
+
+void SkDamageTracker::add(const SkIRect& devBounds) {
+    SkIRect r;
+    if (!r.intersect(devBounds, fDeviceBounds)) {
+        return;
+    }
+
+    int left   =  r.fLeft        / fTileSize,
+        top    =  r.fTop         / fTileSize,
+        right  = (r.fRight  - 1) / fTileSize,
+        bottom = (r.fBottom - 1) / fTileSize;
+    for (int y = top; y <= bottom; ++y) {
+        std::fill(fDirty.begin() + y * fCols + left,
+                  fDirty.begin() + y * fCols + right + 1, true);
+    }
+    fEmpty = false;
+}
+
+void SkDamageTracker::takeDamage(SkRegion* damage) {
+    damage->setEmpty();
+    if (fEmpty) {
+        return;
+    }
+
+    // Each run of dirty tiles in a row becomes one rect. SkRegion merges matching runs from
+    // adjacent rows as they're added.
+    for (int y = 0; y < fRows; ++y) {
+        for (int x = 0; x < fCols;) {
+            if (!fDirty[y * fCols + x]) {
+                ++x;
+                continue;
+            }
+            int end = x;
+            while (end < fCols && fDirty[y * fCols + end]) {
+                ++end;
+            }
+            SkIRect tiles = SkIRect::MakeLTRB(x * fTileSize, y * fTileSize,
+                                              end * fTileSize, (y + 1) * fTileSize);
+            if (tiles.intersect(fDeviceBounds)) {
+                damage->op(tiles, SkRegion::kUnion_Op);
+            }
+            x = end;
+        }
+    }
+
+    std::fill(fDirty.begin(), fDirty.end(), false);
+    fEmpty = true;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDamageTracker_DEFINED
+#define SkDamageTracker_DEFINED
+
+#include "include/core/SkRect.h"
+
+#include <vector>
+
+class SkRegion;
+
+// Records which tiles of a device have been drawn to. Marking is cheap enough to do for every
+// draw; the damage is only turned into a region when it's taken, once per frame.
+class SkDamageTracker {
+public:
+    SkDamageTracker(SkISize deviceSize, int tileSize);
+
+    // Marks every tile that devBounds touches. devBounds may extend past the device.
+    void add(const SkIRect& devBounds);
+
+    bool isEmpty() const { return fEmpty; }
+
+    // Sets damage to the tiles marked since the last call, clipped to the device, and unmarks
+    // them all.
+    void takeDamage(SkRegion* damage);
+
+private:
+    const SkIRect     fDeviceBounds;
+    const int         fTileSize;
+    const int         fCols;
+    const int         fRows;
+    std::vector<bool> fDirty;  // fCols * fRows, row by row
+    bool              fEmpty = true;
+};
+
+#endif  // SkDamageTracker_DEFINED
@@ -19,6 +19,7 @@
 #include "include/private/SkColorData.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkMacros.h"
+#include "include/private/SkTArray.h"
 #include "include/private/SkTemplates.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkArenaAlloc.h"
@@ -37,8 +38,10 @@
 #include "src/core/SkScan.h"
 #include "src/core/SkStroke.h"
 #include "src/core/SkTLazy.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkUtils.h"
 
+#include <algorithm>
 #include <utility>
 
 static SkPaint make_paint_with_image(const SkPaint& origPaint, const SkBitmap& bitmap,
@@ -53,7 +56,7 @@ static SkPaint make_paint_with_image(const SkPaint& origPaint, const SkBitmap& b
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SkDraw::SkDraw() {}
+SkDraw::SkDraw() : fThreadedPathFill(gSkUseThreadedPathFill) {}
 
 bool SkDraw::computeConservativeLocalClipBounds(SkRect* localBounds) const {
     if (fRC->isEmpty()) {
@@ -779,6 +782,49 @@ DRAW_PATH:
     this->drawPath(path, paint, nullptr, true);
 }
 
+// Threaded path fills split the rows they cover into bands of at least this many pixels, and
+// fill the bands concurrently.
+static constexpr int kMinPixelsPerPathBand = 64 * 1024;
+static constexpr int kMaxPathBands         = 16;
+
+bool SkDraw::fillDevPathInBands(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
+                                SkBlitter* blitter) const {
+    // Sparse strips fills each row the same way no matter which band it's in, as long as every
+    // band has the same left and right edges. AAA and supersampling chop edges where they cross
+    // the clip, which would shift coverage along the seams between bands.
+    if (!fRC->isRect()) {
+        return false;
+    }
+    SkIRect bounds = fRC->getBounds();
+    if (!devPath.isInverseFillType() && !bounds.intersect(devPath.getBounds().roundOut())) {
+        return false;
+    }
+    const int64_t pixels = (int64_t)bounds.width() * bounds.height();
+    const int bands = (int)std::min<int64_t>({pixels / kMinPixelsPerPathBand,
+                                              kMaxPathBands,
+                                              bounds.height()});
+    if (bands < 2) {
+        return false;
+    }
+    const int rowsPerBand = (bounds.height() + bands - 1) / bands;
+
+    // Blitters keep per-span state, so each band needs its own.
+    SkSTArenaAlloc<kSkBlitterContextSize> alloc;
+    SkSTArray<kMaxPathBands, SkBlitter*> blitters;
+    blitters.push_back(blitter);
+    for (int i = 1; i < bands; i++) {
+        blitters.push_back(SkBlitter::Choose(fDst, *fMatrixProvider, paint, &alloc, drawCoverage,
+                                             fRC->clipShader()));
+    }
+
+    SkTaskGroup().parallel_for(bounds.fTop, bounds.fBottom, rowsPerBand, [&](int top, int bottom) {
+        SkRasterClip band(SkIRect::MakeLTRB(bounds.fLeft, top, bounds.fRight, bottom));
+        SkScan::SparseStripsAntiFillPath(devPath, band,
+                                         blitters[(top - bounds.fTop) / rowsPerBand]);
+    });
+    return true;
+}
+
 void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
                          SkBlitter* customBlitter, bool doFill) const {
     if (SkPathPriv::TooBigForMath(devPath)) {
@@ -801,6 +847,11 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
+    if (doFill && paint.isAntiAlias() && !customBlitter && fThreadedPathFill &&
+        this->fillDevPathInBands(devPath, paint, drawCoverage, blitter)) {
+        return;
+    }
+
     void (*proc)(const SkPath&, const SkRasterClip&, SkBlitter*);
     if (doFill) {
         if (paint.isAntiAlias()) {
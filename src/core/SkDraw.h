@@ -144,6 +144,10 @@ private:
                      bool drawCoverage,
                      SkBlitter* customBlitter,
                      bool doFill) const;
+    bool fillDevPathInBands(const SkPath& devPath,
+                            const SkPaint& paint,
+                            bool drawCoverage,
+                            SkBlitter* blitter) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -158,6 +162,7 @@ public:
     SkPixmap                fDst;
     const SkMatrixProvider* fMatrixProvider{nullptr};  // required
     const SkRasterClip*     fRC{nullptr};              // required
+    bool                    fThreadedPathFill;         // defaults to gSkUseThreadedPathFill
 
 #ifdef SK_DEBUG
     void validate() const;
@@ -10,6 +10,7 @@
 #include "include/private/SkSemaphore.h"
 #include "include/private/SkSpinlock.h"
 #include "include/private/SkTArray.h"
+#include <atomic>
 #include <deque>
 #include <thread>
 
@@ -139,6 +140,265 @@ private:
     bool                  fAllowBorrowing;
 };
 
+// A Chase-Lev work-stealing deque, following "Correct and Efficient Work-Stealing for Weak
+// Memory Models" (Lê, Pop, Cohen, Zappa Nardelli, 2013).  Only the owning thread may push() and
+// pop() at the bottom; any thread may steal() from the top.
+class SkWorkStealingDeque {
+public:
+    using Work = std::function<void(void)>;
+
+    SkWorkStealingDeque() : fTop(0), fBottom(0), fArray(new Array(kInitialCapacity)) {}
+
+    ~SkWorkStealingDeque() {
+        Array* array = fArray.load(std::memory_order_relaxed);
+        for (int64_t i = fTop.load(std::memory_order_relaxed),
+                     b = fBottom.load(std::memory_order_relaxed); i < b; i++) {
+            delete array->get(i);
+        }
+        delete array;
+    }
+
+    void push(Work* work) {
+        int64_t b = fBottom.load(std::memory_order_relaxed);
+        int64_t t = fTop.load(std::memory_order_acquire);
+        Array* array = fArray.load(std::memory_order_relaxed);
+        if (b - t > array->capacity() - 1) {
+            array = this->grow(array, t, b);
+        }
+        array->put(b, work);
+        std::atomic_thread_fence(std::memory_order_release);
+        fBottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    Work* pop() {
+        int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+        Array* array = fArray.load(std::memory_order_relaxed);
+        fBottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = fTop.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty.
+            fBottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Work* work = array->get(b);
+        if (t == b) {
+            // This was the last item, so we must race any thieves for it.
+            if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed)) {
+                work = nullptr;
+            }
+            fBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return work;
+    }
+
+    Work* steal() {
+        int64_t t = fTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = fBottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        Array* array = fArray.load(std::memory_order_acquire);
+        Work* work = array->get(t);
+        if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+            return nullptr;  // We lost the race to pop() or another steal().
+        }
+        return work;
+    }
+
+private:
+    static constexpr int64_t kInitialCapacity = 64;
+
+    class Array {
+    public:
+        explicit Array(int64_t capacity)
+            : fMask(capacity - 1)
+            , fSlots(new std::atomic<Work*>[capacity]) {
+            SkASSERT(SkIsPow2(capacity));
+        }
+
+        int64_t capacity() const { return fMask + 1; }
+
+        Work* get(int64_t i) const { return fSlots[i & fMask].load(std::memory_order_relaxed); }
+        void put(int64_t i, Work* work) { fSlots[i & fMask].store(work, std::memory_order_relaxed); }
+
+    private:
+        const int64_t                          fMask;
+        std::unique_ptr<std::atomic<Work*>[]>  fSlots;
+    };
+
+    Array* grow(Array* array, int64_t t, int64_t b) {
+        auto bigger = new Array(array->capacity() * 2);
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, array->get(i));
+        }
+        // Thieves may still be reading from the old array, so we keep it alive until we're done.
+        fRetired.emplace_back(array);
+        fArray.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    std::atomic<int64_t>               fTop;
+    std::atomic<int64_t>               fBottom;
+    std::atomic<Array*>                fArray;
+    SkTArray<std::unique_ptr<Array>>   fRetired;  // Only touched by the owning thread.
+};
+
+// An SkWorkStealingThreadPool gives each of its threads its own SkWorkStealingDeque.  Work added
+// by one of those threads goes to the bottom of its own deque; all other work goes through a
+// shared injection queue.  Each unit of work signals fWorkAvailable once, and any thread must
+// wait on fWorkAvailable before taking work, so a thread that has waited is guaranteed to find
+// some work in one of the queues.  Idle threads sleep in fWorkAvailable.wait() instead of spinning.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingThreadPool(int threads, bool allowBorrowing)
+        : fWorkers(new Worker[threads])
+        , fWorkerCount(threads)
+        , fAllowBorrowing(allowBorrowing) {
+        for (int i = 0; i < threads; i++) {
+            fWorkers[i].fPool   = this;
+            fWorkers[i].fIndex  = i;
+            fWorkers[i].fRandom = 0x9E3779B9u * (i + 1);
+        }
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, &fWorkers[i]);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Wake each thread so it can notice it's time to shut down.
+        fShutdown.store(true, std::memory_order_release);
+        fWorkAvailable.signal(fThreads.count());
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+        for (Work* work : fInjected) {
+            delete work;
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        auto boxed = new Work(std::move(work));
+        if (Worker* worker = this->currentWorker()) {
+            worker->fDeque.push(boxed);
+        } else {
+            SkAutoMutexExclusive lock(fInjectedLock);
+            fInjected.push_back(boxed);
+            fInjectedCount.fetch_add(1, std::memory_order_release);
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // Our own threads can always borrow: they're waiting on work they may have spawned.
+        Worker* worker = this->currentWorker();
+        if ((fAllowBorrowing || worker) && fWorkAvailable.try_wait()) {
+            Work* work;
+            while (!(work = this->find(worker))) {
+                std::this_thread::yield();
+            }
+            Run(work);
+        }
+    }
+
+private:
+    using Work = SkWorkStealingDeque::Work;
+
+    struct Worker {
+        SkWorkStealingDeque       fDeque;
+        SkWorkStealingThreadPool* fPool   = nullptr;
+        int                       fIndex  = 0;
+        uint32_t                  fRandom = 0;
+    };
+
+    static thread_local Worker* gCurrentWorker;
+
+    Worker* currentWorker() const {
+        Worker* worker = gCurrentWorker;
+        return worker && worker->fPool == this ? worker : nullptr;
+    }
+
+    static void Run(Work* work) {
+        std::unique_ptr<Work> owned(work);
+        (*owned)();
+    }
+
+    // Look for work: our own deque first, then the injection queue, then other threads' deques.
+    Work* find(Worker* self) {
+        if (self) {
+            if (Work* work = self->fDeque.pop()) {
+                return work;
+            }
+        }
+
+        if (fInjectedCount.load(std::memory_order_acquire) > 0) {
+            SkAutoMutexExclusive lock(fInjectedLock);
+            if (!fInjected.empty()) {
+                Work* work = fInjected.front();
+                fInjected.pop_front();
+                fInjectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return work;
+            }
+        }
+
+        int start = 0;
+        if (self) {
+            // xorshift32, to spread thieves across victims.
+            uint32_t x = self->fRandom;
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            self->fRandom = x;
+            start = (int)(x % (uint32_t)fWorkerCount);
+        }
+        for (int i = 0; i < fWorkerCount; i++) {
+            Worker* victim = &fWorkers[(start + i) % fWorkerCount];
+            if (victim == self) {
+                continue;
+            }
+            if (Work* work = victim->fDeque.steal()) {
+                return work;
+            }
+        }
+        return nullptr;
+    }
+
+    static void Loop(Worker* self) {
+        gCurrentWorker = self;
+        SkWorkStealingThreadPool* pool = self->fPool;
+        for (;;) {
+            pool->fWorkAvailable.wait();
+            Work* work;
+            while (!(work = pool->find(self))) {
+                if (pool->fShutdown.load(std::memory_order_acquire)) {
+                    return;
+                }
+                // The work we've been promised is still being pushed, or is being stolen.
+                std::this_thread::yield();
+            }
+            Run(work);
+        }
+    }
+
+    std::unique_ptr<Worker[]> fWorkers;
+    const int                 fWorkerCount;
+    SkTArray<std::thread>     fThreads;
+
+    std::deque<Work*>         fInjected;
+    SkMutex                   fInjectedLock;
+    std::atomic<int>          fInjectedCount{0};
+
+    SkSemaphore               fWorkAvailable;
+    std::atomic<bool>         fShutdown{false};
+    bool                      fAllowBorrowing;
+};
+
+thread_local SkWorkStealingThreadPool::Worker* SkWorkStealingThreadPool::gCurrentWorker = nullptr;
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads, bool allowBorrowing) {
     using WorkList = std::deque<std::function<void(void)>>;
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
@@ -149,3 +409,8 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads, bool all
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
                                                     allowBorrowing);
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads,
+                                                                   bool allowBorrowing) {
+    return std::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores(),
+                                                      allowBorrowing);
+}
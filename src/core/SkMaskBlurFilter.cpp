@@ -18,6 +18,7 @@
 
 #include <cmath>
 #include <climits>
+#include <optional>
 
 namespace {
 static const double kPi = 3.14159265358979323846264338327950288;
@@ -90,150 +91,56 @@ public:
 
     int    border()     const { return fBorder; }
 
-public:
-    class Scan {
-    public:
-        Scan(uint64_t weight, int noChangeCount,
-             uint32_t* buffer0, uint32_t* buffer0End,
-             uint32_t* buffer1, uint32_t* buffer1End,
-             uint32_t* buffer2, uint32_t* buffer2End)
-            : fWeight{weight}
-            , fNoChangeCount{noChangeCount}
-            , fBuffer0{buffer0}
-            , fBuffer0End{buffer0End}
-            , fBuffer1{buffer1}
-            , fBuffer1End{buffer1End}
-            , fBuffer2{buffer2}
-            , fBuffer2End{buffer2End}
-        { }
-
-        template <typename AlphaIter> void blur(const AlphaIter srcBegin, const AlphaIter srcEnd,
-                    uint8_t* dst, int dstStride, uint8_t* dstEnd) const {
-            auto buffer0Cursor = fBuffer0;
-            auto buffer1Cursor = fBuffer1;
-            auto buffer2Cursor = fBuffer2;
-
-            std::memset(fBuffer0, 0x00, (fBuffer2End - fBuffer0) * sizeof(*fBuffer0));
-
-            uint32_t sum0 = 0;
-            uint32_t sum1 = 0;
-            uint32_t sum2 = 0;
-
-            // Consume the source generating pixels.
-            for (AlphaIter src = srcBegin; src < srcEnd; ++src, dst += dstStride) {
-                uint32_t leadingEdge = *src;
-                sum0 += leadingEdge;
-                sum1 += sum0;
-                sum2 += sum1;
-
-                *dst = this->finalScale(sum2);
-
-                sum2 -= *buffer2Cursor;
-                *buffer2Cursor = sum1;
-                buffer2Cursor = (buffer2Cursor + 1) < fBuffer2End ? buffer2Cursor + 1 : fBuffer2;
-
-                sum1 -= *buffer1Cursor;
-                *buffer1Cursor = sum0;
-                buffer1Cursor = (buffer1Cursor + 1) < fBuffer1End ? buffer1Cursor + 1 : fBuffer1;
-
-                sum0 -= *buffer0Cursor;
-                *buffer0Cursor = leadingEdge;
-                buffer0Cursor = (buffer0Cursor + 1) < fBuffer0End ? buffer0Cursor + 1 : fBuffer0;
-            }
-
-            // The leading edge is off the right side of the mask.
-            for (int i = 0; i < fNoChangeCount; i++) {
-                uint32_t leadingEdge = 0;
-                sum0 += leadingEdge;
-                sum1 += sum0;
-                sum2 += sum1;
-
-                *dst = this->finalScale(sum2);
-
-                sum2 -= *buffer2Cursor;
-                *buffer2Cursor = sum1;
-                buffer2Cursor = (buffer2Cursor + 1) < fBuffer2End ? buffer2Cursor + 1 : fBuffer2;
-
-                sum1 -= *buffer1Cursor;
-                *buffer1Cursor = sum0;
-                buffer1Cursor = (buffer1Cursor + 1) < fBuffer1End ? buffer1Cursor + 1 : fBuffer1;
-
-                sum0 -= *buffer0Cursor;
-                *buffer0Cursor = leadingEdge;
-                buffer0Cursor = (buffer0Cursor + 1) < fBuffer0End ? buffer0Cursor + 1 : fBuffer0;
-
-                dst += dstStride;
-            }
-
-            // Starting from the right, fill in the rest of the buffer.
-            std::memset(fBuffer0, 0, (fBuffer2End - fBuffer0) * sizeof(*fBuffer0));
-
-            sum0 = sum1 = sum2 = 0;
-
-            uint8_t* dstCursor = dstEnd;
-            AlphaIter src = srcEnd;
-            while (dstCursor > dst) {
-                dstCursor -= dstStride;
-                uint32_t leadingEdge = *(--src);
-                sum0 += leadingEdge;
-                sum1 += sum0;
-                sum2 += sum1;
-
-                *dstCursor = this->finalScale(sum2);
-
-                sum2 -= *buffer2Cursor;
-                *buffer2Cursor = sum1;
-                buffer2Cursor = (buffer2Cursor + 1) < fBuffer2End ? buffer2Cursor + 1 : fBuffer2;
-
-                sum1 -= *buffer1Cursor;
-                *buffer1Cursor = sum0;
-                buffer1Cursor = (buffer1Cursor + 1) < fBuffer1End ? buffer1Cursor + 1 : fBuffer1;
+    uint64_t fWeight;
+    int      fBorder;
+    int      fSlidingWindow;
+    int      fPass0Size;
+    int      fPass1Size;
+    int      fPass2Size;
+};
 
-                sum0 -= *buffer0Cursor;
-                *buffer0Cursor = leadingEdge;
-                buffer0Cursor = (buffer0Cursor + 1) < fBuffer0End ? buffer0Cursor + 1 : fBuffer0;
+// Everything blur() needs to know about one axis. It only depends on sigma, and masks tend to be
+// blurred with the same few sigmas over and over (text shadows, UI elevations), so recent plans are
+// kept around instead of being rebuilt for every mask.
+struct AxisPlan {
+    explicit AxisPlan(double sigma) : fBox{sigma} {
+        // small_blur() handles sigmas under 2 with a real Gaussian kernel.
+        if (sigma < 2) {
+            SkGaussFilter filter{sigma};
+            fGaussRadius = filter.radius();
+            int i = 0;
+            for (double d : filter) {
+                fGaussFactors[i++] = static_cast<uint16_t>(round(d * (1 << 16)));
             }
         }
+    }
 
-    private:
-        inline static constexpr uint64_t kHalf = static_cast<uint64_t>(1) << 31;
+    PlanGauss fBox;
+    int       fGaussRadius = 0;
+    uint16_t  fGaussFactors[SkGaussFilter::kGaussArrayMax] = {};
+};
 
-        uint8_t finalScale(uint32_t sum) const {
-            return SkTo<uint8_t>((fWeight * sum + kHalf) >> 32);
-        }
+// Each thread keeps its own few most recent plans, so finding one never takes a lock.
+static AxisPlan find_or_make_plan(double sigma) {
+    static constexpr int kMaxCachedPlans = 4;
 
-        uint64_t  fWeight;
-        int       fNoChangeCount;
-        uint32_t* fBuffer0;
-        uint32_t* fBuffer0End;
-        uint32_t* fBuffer1;
-        uint32_t* fBuffer1End;
-        uint32_t* fBuffer2;
-        uint32_t* fBuffer2End;
+    struct Entry {
+        double   fSigma;
+        AxisPlan fPlan;
     };
+    static thread_local std::optional<Entry> gPlans[kMaxCachedPlans];
+    static thread_local int gNextPlan = 0;
 
-    Scan makeBlurScan(int width, uint32_t* buffer) const {
-        uint32_t* buffer0, *buffer0End, *buffer1, *buffer1End, *buffer2, *buffer2End;
-        buffer0 = buffer;
-        buffer0End = buffer1 = buffer0 + fPass0Size;
-        buffer1End = buffer2 = buffer1 + fPass1Size;
-        buffer2End = buffer2 + fPass2Size;
-        int noChangeCount = fSlidingWindow > width ? fSlidingWindow - width : 0;
-
-        return Scan(
-            fWeight, noChangeCount,
-            buffer0, buffer0End,
-            buffer1, buffer1End,
-            buffer2, buffer2End);
+    for (const std::optional<Entry>& entry : gPlans) {
+        if (entry && entry->fSigma == sigma) {
+            return entry->fPlan;
+        }
     }
-
-    uint64_t fWeight;
-    int      fBorder;
-    int      fSlidingWindow;
-    int      fPass0Size;
-    int      fPass1Size;
-    int      fPass2Size;
-};
+    std::optional<Entry>& entry = gPlans[gNextPlan];
+    gNextPlan = (gNextPlan + 1) % kMaxCachedPlans;
+    entry = Entry{sigma, AxisPlan{sigma}};
+    return entry->fPlan;
+}
 
 } // namespace
 
@@ -251,9 +158,10 @@ public:
 //
 //   window = floor(sigma * 3 * sqrt(2 * kPi) / 4)
 //   For window <= 255, the largest value for sigma is 135.
-SkMaskBlurFilter::SkMaskBlurFilter(double sigmaW, double sigmaH)
+SkMaskBlurFilter::SkMaskBlurFilter(double sigmaW, double sigmaH, Quality quality)
     : fSigmaW{SkTPin(sigmaW, 0.0, 135.0)}
     , fSigmaH{SkTPin(sigmaH, 0.0, 135.0)}
+    , fQuality{quality}
 {
     SkASSERT(sigmaW >= 0);
     SkASSERT(sigmaH >= 0);
@@ -592,7 +500,7 @@ static void blur_row(
 
 // BlurX will only be one of the functions blur_x_radius_(1|2|3|4).
 static void blur_x_rect(BlurX blur,
-                        uint16_t* gauss,
+                        const uint16_t* gauss,
                         const uint8_t* src, size_t srcStride, int srcW,
                         uint8_t* dst, size_t dstStride, int dstW, int dstH) {
 
@@ -610,7 +518,7 @@ static void blur_x_rect(BlurX blur,
     }
 }
 
-static void direct_blur_x(int radius, uint16_t* gauss,
+static void direct_blur_x(int radius, const uint16_t* gauss,
                           const uint8_t* src, size_t srcStride, int srcW,
                           uint8_t* dst, size_t dstStride, int dstW, int dstH) {
 
@@ -805,7 +713,7 @@ static void blur_column(
 
 // BlurY will be one of blur_y_radius_(1|2|3|4).
 static void blur_y_rect(ToA8 toA8, const int strideOf8,
-                        BlurY blur, int radius, uint16_t *gauss,
+                        BlurY blur, int radius, const uint16_t *gauss,
                         const uint8_t *src, size_t srcRB, int srcW, int srcH,
                         uint8_t *dst, size_t dstRB) {
 
@@ -835,7 +743,7 @@ static void blur_y_rect(ToA8 toA8, const int strideOf8,
 }
 
 static void direct_blur_y(ToA8 toA8, const int strideOf8,
-                          int radius, uint16_t* gauss,
+                          int radius, const uint16_t* gauss,
                           const uint8_t* src, size_t srcRB, int srcW, int srcH,
                           uint8_t* dst, size_t dstRB) {
 
@@ -869,31 +777,15 @@ static void direct_blur_y(ToA8 toA8, const int strideOf8,
     }
 }
 
-static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMask* dst) {
-    SkASSERT(sigmaX == sigmaY); // TODO
-    SkASSERT(0.01 <= sigmaX && sigmaX < 2);
-    SkASSERT(0.01 <= sigmaY && sigmaY < 2);
-
-    SkGaussFilter filterX{sigmaX},
-                  filterY{sigmaY};
-
-    int radiusX = filterX.radius(),
-        radiusY = filterY.radius();
+static SkIPoint small_blur(const AxisPlan& planX, const AxisPlan& planY,
+                           const SkMask& src, SkMask* dst) {
+    int radiusX = planX.fGaussRadius,
+        radiusY = planY.fGaussRadius;
 
     SkASSERT(radiusX <= 4 && radiusY <= 4);
 
-    auto prepareGauss = [](const SkGaussFilter& filter, uint16_t* factors) {
-        int i = 0;
-        for (double d : filter) {
-            factors[i++] = static_cast<uint16_t>(round(d * (1 << 16)));
-        }
-    };
-
-    uint16_t gaussFactorsX[SkGaussFilter::kGaussArrayMax],
-             gaussFactorsY[SkGaussFilter::kGaussArrayMax];
-
-    prepareGauss(filterX, gaussFactorsX);
-    prepareGauss(filterY, gaussFactorsY);
+    const uint16_t* gaussFactorsX = planX.fGaussFactors;
+    const uint16_t* gaussFactorsY = planY.fGaussFactors;
 
     *dst = SkMask::PrepareDestination(radiusX, radiusY, src);
     if (src.fImage == nullptr) {
@@ -952,19 +844,122 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
-// TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
-// API forces the sigmas to be the same.
-SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
+// Runs the three box passes described by plan over N lines at once, one line per lane. Element i
+// of the source lines is at src + i*srcStep, and element i of the blurred lines is written to
+// dst + i*dstStep. This matches the original scalar scan exactly, so kExact results didn't change
+// when it was vectorized.
+template <int N>
+static void box_blur_lines(const PlanGauss& plan,
+                           const uint8_t* src, int srcLen, size_t srcStep,
+                           uint8_t* dst, int dstLen, size_t dstStep,
+                           SkNx<N, uint32_t>* buffer) {
+    using V = SkNx<N, uint32_t>;
+
+    // A window of 1 leaves the lines as they are. There are no boxes to run.
+    if (plan.fBorder == 0) {
+        SkASSERT(srcLen == dstLen);
+        for (int i = 0; i < srcLen; ++i) {
+            SkNx<N, uint8_t>::Load(src + i * srcStep).store(dst + i * dstStep);
+        }
+        return;
+    }
 
-    if (fSigmaW < 2.0 && fSigmaH < 2.0) {
-        return small_blur(fSigmaW, fSigmaH, src, dst);
+    V* const buffer0    = buffer;
+    V* const buffer0End = buffer0 + plan.fPass0Size;
+    V* const buffer1    = buffer0End;
+    V* const buffer1End = buffer1 + plan.fPass1Size;
+    V* const buffer2    = buffer1End;
+    V* const buffer2End = buffer2 + plan.fPass2Size;
+
+    V* buffer0Cursor = buffer0;
+    V* buffer1Cursor = buffer1;
+    V* buffer2Cursor = buffer2;
+    V sum0 = 0,
+      sum1 = 0,
+      sum2 = 0;
+
+    auto load = [&](int i) {
+        return SkNx_cast<uint32_t>(SkNx<N, uint8_t>::Load(src + i * srcStep));
+    };
+
+    // The scale is (weight * sum + 1/2) >> 32 in 64 bits. Lanes are only 32 bits wide, so that's
+    // the high half of weight * sum, rounded up when the low half is at least 1/2.
+    SkASSERT(plan.fWeight <= std::numeric_limits<uint32_t>::max());
+    const V weight = static_cast<uint32_t>(plan.fWeight);
+    auto store = [&](int i, const V& sum) {
+        V scaled = sum.mulHi(weight) + ((sum * weight) >> 31);
+        SkNx_cast<uint8_t>(scaled).store(dst + i * dstStep);
+    };
+    auto step = [&](V leadingEdge) {
+        sum0 += leadingEdge;
+        sum1 += sum0;
+        sum2 += sum1;
+
+        V result = sum2;
+
+        sum2 -= *buffer2Cursor;
+        *buffer2Cursor = sum1;
+        buffer2Cursor = (buffer2Cursor + 1) < buffer2End ? buffer2Cursor + 1 : buffer2;
+
+        sum1 -= *buffer1Cursor;
+        *buffer1Cursor = sum0;
+        buffer1Cursor = (buffer1Cursor + 1) < buffer1End ? buffer1Cursor + 1 : buffer1;
+
+        sum0 -= *buffer0Cursor;
+        *buffer0Cursor = leadingEdge;
+        buffer0Cursor = (buffer0Cursor + 1) < buffer0End ? buffer0Cursor + 1 : buffer0;
+
+        return result;
+    };
+
+    std::fill(buffer0, buffer2End, V(0));
+
+    // Consume the source generating pixels.
+    int d = 0;
+    for (int i = 0; i < srcLen; ++i, ++d) {
+        store(d, step(load(i)));
+    }
+
+    // The leading edge is off the right side of the mask.
+    int noChangeCount = plan.fSlidingWindow > srcLen ? plan.fSlidingWindow - srcLen : 0;
+    for (int i = 0; i < noChangeCount; ++i, ++d) {
+        store(d, step(V(0)));
     }
 
-    // 1024 is a place holder guess until more analysis can be done.
-    SkSTArenaAlloc<1024> alloc;
+    // Starting from the right, fill in the rest of the buffer.
+    std::fill(buffer0, buffer2End, V(0));
+    sum0 = sum1 = sum2 = 0;
+
+    for (int dstCursor = dstLen, i = srcLen; dstCursor > d;) {
+        store(--dstCursor, step(load(--i)));
+    }
+}
+
+// Converts a row of any mask format to A8.
+static void row_to_a8(const SkMask& src, const uint8_t* row, int width, uint8_t* a8) {
+    ToA8* toA8;
+    int strideOf8;
+    switch (src.fFormat) {
+        case SkMask::kBW_Format:     toA8 = bw_to_a8;     strideOf8 =  1; break;
+        case SkMask::kARGB32_Format: toA8 = argb32_to_a8; strideOf8 = 32; break;
+        case SkMask::kLCD16_Format:  toA8 = lcd_to_a8;    strideOf8 = 16; break;
+        case SkMask::kA8_Format:
+            memcpy(a8, row, width);
+            return;
+        default:
+            SK_ABORT("Unhandled format.");
+    }
+    for (int x = 0; x < width; x += 8) {
+        toA8(a8 + x, row + (x / 8) * strideOf8, std::min(8, width - x));
+    }
+}
 
-    PlanGauss planW(fSigmaW);
-    PlanGauss planH(fSigmaH);
+static SkIPoint box_blur(const PlanGauss& planW, const PlanGauss& planH,
+                         const SkMask& src, SkMask* dst) {
+    // Lines blurred at a time. Both passes vectorize across lines rather than along them, because
+    // each step of the running sums depends on the step before it.
+    static constexpr int N = 4;
+    using V = SkNx<N, uint32_t>;
 
     int borderW = planW.border(),
         borderH = planH.border();
@@ -985,72 +980,75 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
         dstH = dst->fBounds.height();
     SkASSERT(srcW >= 0 && srcH >= 0 && dstW >= 0 && dstH >= 0);
 
-    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
-    auto buffer = alloc.makeArrayDefault<uint32_t>(bufferSize);
-
-    // Blur both directions.
-    int tmpW = srcH,
-        tmpH = dstW;
-
     // Make sure not to overflow the multiply for the tmp buffer size.
-    if (tmpH > std::numeric_limits<int>::max() / tmpW) {
+    if (srcH > 0 && dstW > std::numeric_limits<int>::max() / srcH) {
         return {0, 0};
     }
-    auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
-    // Blur horizontally, and transpose.
-    const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
-    switch (src.fFormat) {
-        case SkMask::kBW_Format: {
-            const uint8_t* bwStart = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
-            auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kA8_Format: {
-            const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kARGB32_Format: {
-            const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
-            auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+    SkSTArenaAlloc<4096> alloc;
+    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
+    auto buffer  = alloc.makeArrayDefault<V>(bufferSize);
+    auto buffer1 = reinterpret_cast<SkNx<1, uint32_t>*>(buffer);
+
+    // The horizontally blurred rows, srcH rows of dstW each.
+    auto tmp = alloc.makeArrayDefault<uint8_t>(srcH * dstW);
+
+    // Blur horizontally, N rows at a time. The rows are interleaved first so that each lane of the
+    // blur sees one row.
+    auto a8   = alloc.makeArrayDefault<uint8_t>(srcW);
+    auto srcN = alloc.makeArrayDefault<uint8_t>(srcW * N);
+    auto dstN = alloc.makeArrayDefault<uint8_t>(dstW * N);
+    int y = 0;
+    for (; y + N <= srcH; y += N) {
+        for (int r = 0; r < N; ++r) {
+            row_to_a8(src, src.fImage + (y + r) * src.fRowBytes, srcW, a8);
+            for (int x = 0; x < srcW; ++x) {
+                srcN[x * N + r] = a8[x];
             }
-        } break;
-        case SkMask::kLCD16_Format: {
-            const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
-            auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+        }
+        box_blur_lines<N>(planW, srcN, srcW, N, dstN, dstW, N, buffer);
+        for (int r = 0; r < N; ++r) {
+            uint8_t* tmpRow = tmp + (y + r) * dstW;
+            for (int x = 0; x < dstW; ++x) {
+                tmpRow[x] = dstN[x * N + r];
             }
-        } break;
-        default:
-            SK_ABORT("Unhandled format.");
+        }
+    }
+    for (; y < srcH; ++y) {
+        row_to_a8(src, src.fImage + y * src.fRowBytes, srcW, a8);
+        box_blur_lines<1>(planW, a8, srcW, 1, tmp + y * dstW, dstW, 1, buffer1);
     }
 
-    // Blur vertically (scan in memory order because of the transposition),
-    // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->fImage[y];
-
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
+    // Blur vertically, N columns at a time. These are already adjacent in tmp.
+    int x = 0;
+    for (; x + N <= dstW; x += N) {
+        box_blur_lines<N>(planH, tmp + x, srcH, dstW, dst->fImage + x, dstH, dst->fRowBytes,
+                          buffer);
+    }
+    for (; x < dstW; ++x) {
+        box_blur_lines<1>(planH, tmp + x, srcH, dstW, dst->fImage + x, dstH, dst->fRowBytes,
+                          buffer1);
     }
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
 }
+
+// TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
+// API forces the sigmas to be the same.
+SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
+    const AxisPlan planW = find_or_make_plan(fSigmaW),
+                   planH = find_or_make_plan(fSigmaH);
+
+    // The spec switches from the Gaussian kernel to the boxes at a sigma of 2. Below about 1.2
+    // the Gaussian kernel is narrow enough to be as fast as the boxes, so even the fast mode keeps
+    // it there.
+    auto boxesAt = [this](double sigma) {
+        return sigma >= (fQuality == Quality::kFastApproximate ? 1.2 : 2.0);
+    };
+    bool useBoxes = boxesAt(fSigmaW) || boxesAt(fSigmaH);
+
+    if (!useBoxes) {
+        return small_blur(planW, planH, src, dst);
+    }
+    return box_blur(planW.fBox, planH.fBox, src, dst);
+}
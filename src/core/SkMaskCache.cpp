@@ -20,17 +20,20 @@ static unsigned gRRectBlurKeyNamespaceLabel;
 
 struct RRectBlurKey : public SkResourceCache::Key {
 public:
-    RRectBlurKey(SkScalar sigma, const SkRRect& rrect, SkBlurStyle style)
+    RRectBlurKey(SkScalar sigma, const SkRRect& rrect, SkBlurStyle style,
+                 SkMaskBlurFilter::Quality quality)
         : fSigma(sigma)
         , fStyle(style)
+        , fQuality(static_cast<int32_t>(quality))
         , fRRect(rrect)
     {
         this->init(&gRRectBlurKeyNamespaceLabel, 0,
-                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fRRect));
+                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fQuality) + sizeof(fRRect));
     }
 
     SkScalar   fSigma;
     int32_t    fStyle;
+    int32_t    fQuality;
     SkRRect    fRRect;
 };
 
@@ -73,9 +76,10 @@ struct RRectBlurRec : public SkResourceCache::Rec {
 } // namespace
 
 SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style,
-                                  const SkRRect& rrect, SkMask* mask, SkResourceCache* localCache) {
+                                      SkMaskBlurFilter::Quality quality, const SkRRect& rrect,
+                                      SkMask* mask, SkResourceCache* localCache) {
     MaskValue result;
-    RRectBlurKey key(sigma, rrect, style);
+    RRectBlurKey key(sigma, rrect, style, quality);
     if (!CHECK_LOCAL(localCache, find, Find, key, RRectBlurRec::Visitor, &result)) {
         return nullptr;
     }
@@ -85,10 +89,10 @@ SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style,
     return result.fData;
 }
 
-void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style,
+void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkMaskBlurFilter::Quality quality,
                       const SkRRect& rrect, const SkMask& mask, SkCachedData* data,
                       SkResourceCache* localCache) {
-    RRectBlurKey key(sigma, rrect, style);
+    RRectBlurKey key(sigma, rrect, style, quality);
     return CHECK_LOCAL(localCache, add, Add, new RRectBlurRec(key, mask, data));
 }
 
@@ -99,9 +103,11 @@ static unsigned gRectsBlurKeyNamespaceLabel;
 
 struct RectsBlurKey : public SkResourceCache::Key {
 public:
-    RectsBlurKey(SkScalar sigma, SkBlurStyle style, const SkRect rects[], int count)
+    RectsBlurKey(SkScalar sigma, SkBlurStyle style, SkMaskBlurFilter::Quality quality,
+                 const SkRect rects[], int count)
         : fSigma(sigma)
         , fStyle(style)
+        , fQuality(static_cast<int32_t>(quality))
     {
         SkASSERT(1 == count || 2 == count);
         SkIRect ir;
@@ -117,11 +123,12 @@ public:
         fSizes[3] = SkSize{rects[0].x() - ir.x(), rects[0].y() - ir.y()};
 
         this->init(&gRectsBlurKeyNamespaceLabel, 0,
-                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fSizes));
+                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fQuality) + sizeof(fSizes));
     }
 
     SkScalar    fSigma;
     int32_t     fStyle;
+    int32_t     fQuality;
     SkSize      fSizes[4];
 };
 
@@ -164,10 +171,11 @@ struct RectsBlurRec : public SkResourceCache::Rec {
 } // namespace
 
 SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style,
+                                      SkMaskBlurFilter::Quality quality,
                                       const SkRect rects[], int count, SkMask* mask,
                                       SkResourceCache* localCache) {
     MaskValue result;
-    RectsBlurKey key(sigma, style, rects, count);
+    RectsBlurKey key(sigma, style, quality, rects, count);
     if (!CHECK_LOCAL(localCache, find, Find, key, RectsBlurRec::Visitor, &result)) {
         return nullptr;
     }
@@ -177,9 +185,9 @@ SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style,
     return result.fData;
 }
 
-void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style,
+void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkMaskBlurFilter::Quality quality,
                       const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                       SkResourceCache* localCache) {
-    RectsBlurKey key(sigma, style, rects, count);
+    RectsBlurKey key(sigma, style, quality, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
@@ -13,6 +13,7 @@
 #include "include/core/SkRect.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 #include "src/core/SkResourceCache.h"
 
 class SkMaskCache {
@@ -22,21 +23,25 @@ public:
      * already point to that memory.
      *
      * On failure, return nullptr.
+     *
+     * Masks blurred with different qualities are cached separately.
      */
     static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style,
+                                    SkMaskBlurFilter::Quality quality,
                                     const SkRRect& rrect, SkMask* mask,
                                     SkResourceCache* localCache = nullptr);
     static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style,
+                                    SkMaskBlurFilter::Quality quality,
                                     const SkRect rects[], int count, SkMask* mask,
                                     SkResourceCache* localCache = nullptr);
 
     /**
      * Add a mask and its pixel-data to the cache.
      */
-    static void Add(SkScalar sigma, SkBlurStyle style,
+    static void Add(SkScalar sigma, SkBlurStyle style, SkMaskBlurFilter::Quality quality,
                     const SkRRect& rrect, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
-    static void Add(SkScalar sigma, SkBlurStyle style,
+    static void Add(SkScalar sigma, SkBlurStyle style, SkMaskBlurFilter::Quality quality,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
 };
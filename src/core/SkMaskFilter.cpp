@@ -258,6 +258,14 @@ bool SkMaskFilterBase::filterPath(const SkPath& devPath, const SkMatrix& matrix,
         }
     }
 
+    // Round rects, the usual shape of a shadow, share drawRRect()'s cached nine-patches.
+    SkRRect rrect;
+    if (0 == rectCount && SkStrokeRec::kFill_InitStyle == style &&
+            !devPath.isInverseFillType() && devPath.isRRect(&rrect) &&
+            this->filterRRect(rrect, matrix, clip, blitter)) {
+        return true;
+    }
+
     SkMask  srcM, dstM;
 
 #if defined(SK_BUILD_FOR_FUZZER)
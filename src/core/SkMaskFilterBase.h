@@ -188,7 +188,8 @@ protected:
 
         SkMask      fMask;      // fBounds must have [0,0] in its top-left
         SkIRect     fOuterRect; // width/height must be >= fMask.fBounds'
-        SkIPoint    fCenter;    // identifies center row/col for stretching
+        SkIPoint    fCenter;    // identifies center row/col for stretching; one past the end
+                                // of fMask along an axis means that axis isn't stretched
         SkCachedData* fCache;
     };
 
@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkHalf.h"
@@ -16,6 +17,8 @@
 #include "src/core/SkMathPriv.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkTaskGroup.h"
 #include <new>
 
 //
@@ -400,8 +403,16 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return SkTo<int32_t>(size);
 }
 
+// Roughly how many bytes of a level we build per task.
+static constexpr size_t kMinBandBytes = 64 * 1024;
+
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
                           bool computeContents) {
+    return Build(src, fact, computeContents, BuildOptions());
+}
+
+SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
+                          bool computeContents, const BuildOptions& options) {
     typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
     FilterProc* proc_1_2 = nullptr;
@@ -427,6 +438,9 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
             proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+            if (options.fAllowOpts) {
+                proc_2_2 = SkOpts::downsample_2_2_8888;
+            }
             break;
         case kRGB_565_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
@@ -459,6 +473,9 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
             proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
+            if (options.fAllowOpts) {
+                proc_2_2 = SkOpts::downsample_2_2_A8;
+            }
             break;
         case kRGBA_F16Norm_SkColorType:
         case kRGBA_F16_SkColorType:
@@ -470,6 +487,9 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_3_1 = downsample_3_1<ColorTypeFilter_RGBA_F16>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_RGBA_F16>;
             proc_3_3 = downsample_3_3<ColorTypeFilter_RGBA_F16>;
+            if (options.fAllowOpts) {
+                proc_2_2 = SkOpts::downsample_2_2_F16;
+            }
             break;
         case kR8G8_unorm_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_88>;
@@ -599,6 +619,8 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
     // large as 8 (for F16 pixels). See the comment on SkMipmap::Level.
     SkASSERT(SkIsAlign8((uintptr_t)addr));
 
+    SkTaskGroup tasks(options.fExecutor ? *options.fExecutor : SkExecutor::GetDefault());
+
     for (int i = 0; i < countLevels; ++i) {
         FilterProc* proc;
         if (height & 1) {
@@ -643,15 +665,20 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (computeContents) {
-            const void* srcBasePtr = srcPM.addr();
-            void* dstBasePtr = dstPM.writable_addr();
-
-            const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
-            }
+            const char* srcBasePtr = (const char*)srcPM.addr();
+            char* dstBasePtr = (char*)dstPM.writable_addr();
+
+            const size_t srcRB = srcPM.rowBytes(),
+                         dstRB = dstPM.rowBytes();
+            // Each dst row only reads its own src rows, so bands of rows can be built in any
+            // order. Keep bands big enough that small levels stay on this thread.
+            const int rowsPerBand = std::max(1, (int)(kMinBandBytes / dstRB));
+            tasks.parallel_for(0, height, rowsPerBand, [&](int y0, int y1) {
+                for (int y = y0; y < y1; y++) {
+                    // jump two rows of src per row of dst
+                    proc(dstBasePtr + y * dstRB, srcBasePtr + y * srcRB * 2, srcRB, width);
+                }
+            });
         }
         srcPM = dstPM;
         addr += height * rowBytes;
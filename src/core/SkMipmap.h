@@ -18,6 +18,7 @@
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -37,6 +38,18 @@ public:
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
                            bool computeContents = true);
 
+    struct BuildOptions {
+        // The rows of each level are split across this executor. If null, we use
+        // SkExecutor::GetDefault().
+        SkExecutor* fExecutor = nullptr;
+
+        // If false, we only use the portable downsamplers, never the SkOpts ones.
+        // This is mostly useful to compare the two in tests and benchmarks.
+        bool fAllowOpts = true;
+    };
+    static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc, bool computeContents,
+                           const BuildOptions&);
+
     static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
     // Determines how many levels a SkMipmap will have without creating that mipmap.
@@ -43,6 +43,8 @@
 #include "src/opts/SkBlitMask_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
 #include "src/opts/SkChecksum_opts.h"
+#include "src/opts/SkMipmap_opts.h"
+#include "src/opts/SkMorphology_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -70,6 +72,13 @@ namespace SkOpts {
     DEFINE_DEFAULT(gray_to_RGB1);
     DEFINE_DEFAULT(grayA_to_RGBA);
     DEFINE_DEFAULT(grayA_to_rgbA);
+    DEFINE_DEFAULT(RGB16_to_RGB1);
+    DEFINE_DEFAULT(RGB16_to_BGR1);
+    DEFINE_DEFAULT(RGBA16_to_RGBA);
+    DEFINE_DEFAULT(RGBA16_to_BGRA);
+    DEFINE_DEFAULT(RGBA16_to_rgbA);
+    DEFINE_DEFAULT(RGBA16_to_bgrA);
+    DEFINE_DEFAULT(index_to_8888);
     DEFINE_DEFAULT(inverted_CMYK_to_RGB1);
     DEFINE_DEFAULT(inverted_CMYK_to_BGR1);
 
@@ -83,6 +92,19 @@ namespace SkOpts {
 
     DEFINE_DEFAULT(cubic_solver);
 
+    DEFINE_DEFAULT(downsample_2_2_8888);
+    DEFINE_DEFAULT(downsample_2_2_F16);
+    DEFINE_DEFAULT(downsample_2_2_A8);
+
+    DEFINE_DEFAULT(dilate_x_8888);
+    DEFINE_DEFAULT(dilate_y_8888);
+    DEFINE_DEFAULT(erode_x_8888);
+    DEFINE_DEFAULT(erode_y_8888);
+    DEFINE_DEFAULT(dilate_x_A8);
+    DEFINE_DEFAULT(dilate_y_A8);
+    DEFINE_DEFAULT(erode_x_A8);
+    DEFINE_DEFAULT(erode_y_A8);
+
     DEFINE_DEFAULT(hash_fn);
 
     DEFINE_DEFAULT(S32_alpha_D32_filter_DX);
@@ -105,6 +127,14 @@ namespace SkOpts {
         = SK_OPTS_NS::lowp::start_pipeline;
 #undef M
 
+#define M(st, ...) (StageFn)SK_OPTS_NS::st,
+    StageFn fused_stages_highp[] = { SK_RASTER_PIPELINE_FUSED_STAGES(M) };
+#undef M
+
+#define M(st, ...) (StageFn)SK_OPTS_NS::lowp::st,
+    StageFn fused_stages_lowp[] = { SK_RASTER_PIPELINE_FUSED_STAGES(M) };
+#undef M
+
     // Each Init_foo() is defined in src/opts/SkOpts_foo.cpp.
     void Init_ssse3();
     void Init_sse42();
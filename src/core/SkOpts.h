@@ -47,7 +47,16 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. strip 16-bit components to 8 + an opaque alpha
+                           RGB16_to_BGR1,   // i.e. strip, swap RB and insert an opaque alpha
+                           RGBA16_to_RGBA,  // i.e. strip 16-bit components to 8
+                           RGBA16_to_BGRA,  // i.e. strip and swap RB
+                           RGBA16_to_rgbA,  // i.e. strip and premultiply
+                           RGBA16_to_bgrA;  // i.e. strip, swap RB and premultiply
+
+    typedef void (*Swizzle_8888_index)(uint32_t*, const uint8_t*, int, const uint32_t table[]);
+    extern Swizzle_8888_index index_to_8888;  // i.e. look up each 8-bit index in a color table
 
     extern void (*memset16)(uint16_t[], uint16_t, int);
     extern void SK_SPI(*memset32)(uint32_t[], uint32_t, int);
@@ -59,6 +68,21 @@ namespace SkOpts {
 
     extern float (*cubic_solver)(float, float, float, float);
 
+    // Box filter two rows of src into one row of count dst pixels, for SkMipmap.
+    typedef void (*Downsample)(void* dst, const void* src, size_t srcRB, int count);
+    extern Downsample downsample_2_2_8888,
+                      downsample_2_2_F16,
+                      downsample_2_2_A8;
+
+    // Dilate or erode count lines of src into dst, for SkMorphologyImageFilter.
+    // See src/opts/SkMorphology_opts.h.
+    typedef void (*Morph8888)(const uint32_t* src, uint32_t* dst, int radius,
+                              int width, int height, int srcStride, int dstStride);
+    typedef void (*MorphA8)(const uint8_t* src, uint8_t* dst, int radius,
+                            int width, int height, int srcStride, int dstStride);
+    extern Morph8888 dilate_x_8888, dilate_y_8888, erode_x_8888, erode_y_8888;
+    extern MorphA8   dilate_x_A8,   dilate_y_A8,   erode_x_A8,   erode_y_A8;
+
     static inline uint32_t hash(const void* data, size_t bytes, uint32_t seed=0) {
         return hash_fn(data, bytes, seed);
     }
@@ -80,6 +104,11 @@ namespace SkOpts {
     extern void (*start_pipeline_lowp )(size_t,size_t,size_t,size_t, void**);
 #undef M
 
+#define M(st, ...) +1
+    extern StageFn fused_stages_highp[SK_RASTER_PIPELINE_FUSED_STAGES(M)];
+    extern StageFn fused_stages_lowp [SK_RASTER_PIPELINE_FUSED_STAGES(M)];
+#undef M
+
     extern void (*interpret_skvm)(const skvm::InterpreterInstruction insts[], int ninsts,
                                   int nregs, int loop, const int strides[],
                                   skvm::TraceHook* traceHooks[], int nTraceHooks,
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkPackedBVH.h"
+
+#include "include/private/SkVx.h"
+#include "src/core/SkMathPriv.h"
+
+#include <limits>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE1
+    #include <immintrin.h>
+#endif
+
+// Tests N children's bounds l,t,r,b against query = {ql,qt,qr,qb}, and returns a mask with bit k
+// set if child k intersects it. Both are sorted, so SkRect::Intersects()'s
+// max(l, ql) < min(r, qr) reduces to l < qr && ql < r, and likewise vertically.
+template <int N>
+static uint32_t intersect_mask(const float l[], const float t[], const float r[], const float b[],
+                               const skvx::Vec<4, float>& query) {
+    static_assert(N % 4 == 0 && N <= 32);
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE1
+    const __m128 ql = _mm_set1_ps(query[0]),
+                 qt = _mm_set1_ps(query[1]),
+                 qr = _mm_set1_ps(query[2]),
+                 qb = _mm_set1_ps(query[3]);
+    uint32_t mask = 0;
+    for (int k = 0; k < N; k += 4) {
+        __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(l + k), qr),
+                                           _mm_cmplt_ps(ql, _mm_loadu_ps(r + k))),
+                                _mm_and_ps(_mm_cmplt_ps(_mm_loadu_ps(t + k), qb),
+                                           _mm_cmplt_ps(qt, _mm_loadu_ps(b + k))));
+        mask |= (uint32_t)_mm_movemask_ps(hit) << k;
+    }
+    return mask;
+#else
+    using F = skvx::Vec<N, float>;
+    const auto hit = (F::Load(l) < query[2]) & (query[0] < F::Load(r)) &
+                     (F::Load(t) < query[3]) & (query[1] < F::Load(b));
+    uint32_t mask = 0;
+    for (int k = 0; k < N; k++) {
+        mask |= (uint32_t)(hit[k] & 1) << k;
+    }
+    return mask;
+#endif
+}
+
+void SkPackedBVH::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(0 == fCount);
+
+    struct Branch {
+        SkRect  fBounds;
+        int32_t fIndex;  // An op index at the bottom level, then a Node index.
+    };
+    std::vector<Branch> branches;
+    branches.reserve(N);
+    for (int i = 0; i < N; i++) {
+        if (!boundsArray[i].isEmpty()) {
+            branches.push_back({boundsArray[i], i});
+        }
+    }
+
+    fCount = (int)branches.size();
+    if (0 == fCount) {
+        return;
+    }
+
+    size_t nodes = 0;
+    for (size_t n = branches.size(); ; n = (n + kWidth - 1) / kWidth) {
+        nodes += (n + kWidth - 1) / kWidth;
+        if (n <= kWidth) {
+            break;
+        }
+    }
+    fNodes.reserve(nodes);
+
+    // Pack each run of kWidth branches into a Node, which becomes a branch of the level above,
+    // until one Node holds everything.
+    const float inf = std::numeric_limits<float>::infinity();
+    do {
+        const int parents = ((int)branches.size() + kWidth - 1) / kWidth;
+        for (int p = 0; p < parents; p++) {
+            Node& node = fNodes.emplace_back();
+            SkRect bounds = SkRect::MakeEmpty();
+            for (int k = 0; k < kWidth; k++) {
+                const size_t b = (size_t)p * kWidth + k;
+                if (b < branches.size()) {
+                    const SkRect& r = branches[b].fBounds;
+                    node.fLeft[k]   = r.fLeft;
+                    node.fTop[k]    = r.fTop;
+                    node.fRight[k]  = r.fRight;
+                    node.fBottom[k] = r.fBottom;
+                    node.fChild[k]  = branches[b].fIndex;
+                    bounds.join(r);
+                } else {
+                    node.fLeft[k] = node.fTop[k]    = +inf;
+                    node.fRight[k] = node.fBottom[k] = -inf;
+                    node.fChild[k] = -1;
+                }
+            }
+            // p <= p*kWidth, so we only overwrite branches we've already packed.
+            branches[p] = {bounds, (int32_t)fNodes.size() - 1};
+        }
+        branches.resize(parents);
+
+        if (0 == fDepth) {
+            fLeafCount = (int)fNodes.size();
+        }
+        fDepth++;
+    } while (branches.size() > 1);
+
+    SkASSERT(fNodes.size() == nodes);
+    fBounds = branches[0].fBounds;
+}
+
+void SkPackedBVH::search(const SkRect& query, std::vector<int>* results) const {
+    if (0 == fCount || !SkRect::Intersects(fBounds, query)) {
+        return;
+    }
+
+    // SkRect::Intersects() ignores NaN edges of the query, which is the same as making them
+    // infinite. Having passed the test above, the query is otherwise not empty.
+    const float inf = std::numeric_limits<float>::infinity();
+    auto edge = [](float v, float nanValue) { return v == v ? v : nanValue; };
+
+    const skvx::Vec<4, float> q = {edge(query.fLeft,   -inf),
+                                   edge(query.fTop,    -inf),
+                                   edge(query.fRight,  +inf),
+                                   edge(query.fBottom, +inf)};
+
+    // Each level of a depth-first walk leaves at most kWidth-1 siblings waiting on the stack.
+    // A 32-bit count of ops needs fewer than 12 levels.
+    int32_t stack[12 * (kWidth - 1) + 1];
+    SkASSERT(fDepth <= 12);
+    int depth = 0;
+    stack[depth++] = (int32_t)fNodes.size() - 1;
+
+    while (depth > 0) {
+        const int32_t index = stack[--depth];
+        const Node& node = fNodes[index];
+
+        uint32_t mask = intersect_mask<kWidth>(node.fLeft, node.fTop, node.fRight, node.fBottom, q);
+
+        if (index < fLeafCount) {
+            while (mask) {
+                results->push_back(node.fChild[SkCTZ(mask)]);
+                mask &= mask - 1;
+            }
+        } else {
+            // Push in reverse so we visit children, and so return ops, in order.
+            while (mask) {
+                int k = 31 - SkCLZ(mask);
+                stack[depth++] = node.fChild[k];
+                mask ^= 1u << k;
+            }
+        }
+    }
+}
+
+size_t SkPackedBVH::bytesUsed() const {
+    return sizeof(SkPackedBVH) + fNodes.capacity() * sizeof(Node);
+}
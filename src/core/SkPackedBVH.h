@@ -0,0 +1,61 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPackedBVH_DEFINED
+#define SkPackedBVH_DEFINED
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkRect.h"
+
+#include <vector>
+
+/**
+ * A bounding volume hierarchy laid out for fast queries. Like SkRTree it is bulk-loaded bottom-up
+ * from the bounds in the order they are given, but every node holds the bounds of its kWidth
+ * children as four contiguous float arrays, so a query tests all of them with a few SIMD
+ * compares. All nodes live in one array, leaves first, and search() walks it with an explicit
+ * stack rather than recursion.
+ *
+ * search() returns exactly what SkRTree::search() returns, in the same (ascending) order.
+ */
+class SkPackedBVH : public SkBBoxHierarchy {
+public:
+    SkPackedBVH() = default;
+
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, std::vector<int>* results) const override;
+    size_t bytesUsed() const override;
+
+    // Methods and constants below here are only public for tests.
+
+    // Return the depth of the tree structure.
+    int getDepth() const { return fDepth; }
+    // Insertion count (not overall node count, which may be greater).
+    int getCount() const { return fCount; }
+
+    static constexpr int kWidth = 8;
+
+private:
+    // Unused slots have inverted bounds, which never intersect a query.
+    struct Node {
+        float   fLeft  [kWidth],
+                fTop   [kWidth],
+                fRight [kWidth],
+                fBottom[kWidth];
+        int32_t fChild [kWidth];  // An op index in leaves, otherwise the index of a child Node.
+    };
+
+    // This is the count of data elements (rather than total nodes in the tree)
+    int fCount = 0;
+    int fDepth = 0;
+    // Nodes [0, fLeafCount) are leaves. The root is the last node.
+    int fLeafCount = 0;
+    SkRect fBounds = SkRect::MakeEmpty();
+    std::vector<Node> fNodes;
+};
+
+#endif
@@ -100,6 +100,8 @@ public:
     // V88: Add blender to ComposeShader and BlendImageFilter
     // V89: Deprecated SkClipOps are no longer supported
     // V90: Private API for backdrop scale factor in SaveLayerRec
+    // V91: Add raw image shaders
+    // V92: Blur mask filters record their SkBlurQuality
 
     enum Version {
         kPictureShaderFilterParam_Version   = 82,
@@ -112,10 +114,11 @@ public:
         kNoExpandingClipOps                 = 89,
         kBackdropScaleFactor                = 90,
         kRawImageShaders                    = 91,
+        kBlurMaskFilterQuality              = 92,
 
         // Only SKPs within the min/current picture version range (inclusive) can be read.
         kMin_Version     = kPictureShaderFilterParam_Version,
-        kCurrent_Version = kRawImageShaders
+        kCurrent_Version = kBlurMaskFilterQuality
     };
 };
 
@@ -14,8 +14,22 @@
 #include "src/core/SkRasterPipeline.h"
 
 #include <algorithm>
+#include <atomic>
 
 bool gForceHighPrecisionRasterPipeline;
+bool gDisableRasterPipelineFusion;
+bool gCountRasterPipelineFusion;
+
+static std::atomic<int64_t> gFusionPipelines{0},
+                            gFusionStages{0},
+                            gFusionFused[SkRasterPipeline::kNumFusedStages];
+
+// This initializer is in class scope, so the stages can go unqualified.
+const SkRasterPipeline::FusedRun SkRasterPipeline::kFusedRuns[] = {
+#define M(stage, count, ...) {count, {__VA_ARGS__}},
+    SK_RASTER_PIPELINE_FUSED_STAGES(M)
+#undef M
+};
 
 SkRasterPipeline::SkRasterPipeline(SkArenaAlloc* alloc) : fAlloc(alloc) {
     this->reset();
@@ -365,49 +379,109 @@ void SkRasterPipeline::append_gamut_clamp_if_normalized(const SkImageInfo& info)
     }
 }
 
-SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) const {
-    if (!gForceHighPrecisionRasterPipeline) {
-        // We'll try to build a lowp pipeline, but if that fails fallback to a highp float pipeline.
-        void** reset_point = ip;
-
-        // Stages are stored backwards in fStages, so we reverse here, back to front.
-        *--ip = (void*)SkOpts::just_return_lowp;
-        for (const StageList* st = fStages; st; st = st->prev) {
-            if (auto fn = SkOpts::stages_lowp[st->stage]) {
-                if (st->ctx) {
-                    *--ip = st->ctx;
-                }
-                *--ip = (void*)fn;
-            } else {
-                ip = reset_point;
+void** SkRasterPipeline::fill_program(void** ip, const StageList* const stages[], int count,
+                                      StageFn justReturn, const StageFn stageFns[],
+                                      const StageFn fusedFns[], int fusedCounts[]) {
+    *--ip = (void*)justReturn;
+    for (int i = count - 1; i >= 0;) {
+        // Look for a fused stage for a run of stages ending at stages[i].
+        int fused = -1;
+        for (int f = 0; f < kNumFusedStages && fusedFns; f++) {
+            const FusedRun& run = kFusedRuns[f];
+            if (run.count > i + 1 || !fusedFns[f]) {
+                continue;
+            }
+            const StageList* const* first = stages + i + 1 - run.count;
+            int j = 0;
+            while (j < run.count && first[j]->stage == run.stages[j]) {
+                j++;
+            }
+            if (j == run.count) {
+                fused = f;
                 break;
             }
         }
-        if (ip != reset_point) {
-            return SkOpts::start_pipeline_lowp;
+
+        // A fused stage reads the contexts of each stage in its run, in order.
+        const int runLength = fused < 0 ? 1 : kFusedRuns[fused].count;
+        for (int j = i; j > i - runLength; j--) {
+            if (stages[j]->ctx) {
+                *--ip = stages[j]->ctx;
+            }
+        }
+        if (fused >= 0) {
+            *--ip = (void*)fusedFns[fused];
+            fusedCounts[fused]++;
+        } else if (auto fn = stageFns[stages[i]->stage]) {
+            *--ip = (void*)fn;
+        } else {
+            return nullptr;
         }
+        i -= runLength;
     }
+    return ip;
+}
 
-    *--ip = (void*)SkOpts::just_return_highp;
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void*** ip,
+                                                                   int fusedCounts[]) const {
+    // Stages are stored backwards in fStages; put them in order so we can spot runs to fuse.
+    SkAutoSTMalloc<32, const StageList*> stages(fNumStages);
+    int i = fNumStages;
     for (const StageList* st = fStages; st; st = st->prev) {
-        if (st->ctx) {
-            *--ip = st->ctx;
+        stages[--i] = st;
+    }
+
+    const bool fuse = !gDisableRasterPipelineFusion;
+    std::fill(fusedCounts, fusedCounts + kNumFusedStages, 0);
+
+    if (!gForceHighPrecisionRasterPipeline) {
+        // We'll try to build a lowp pipeline, but if that fails fallback to a highp float pipeline.
+        if (void** program = fill_program(*ip, stages.get(), fNumStages,
+                                          SkOpts::just_return_lowp, SkOpts::stages_lowp,
+                                          fuse ? SkOpts::fused_stages_lowp : nullptr,
+                                          fusedCounts)) {
+            *ip = program;
+            return SkOpts::start_pipeline_lowp;
         }
-        *--ip = (void*)SkOpts::stages_highp[st->stage];
+        std::fill(fusedCounts, fusedCounts + kNumFusedStages, 0);
     }
+
+    *ip = fill_program(*ip, stages.get(), fNumStages,
+                       SkOpts::just_return_highp, SkOpts::stages_highp,
+                       fuse ? SkOpts::fused_stages_highp : nullptr,
+                       fusedCounts);
+    SkASSERT(*ip);
     return SkOpts::start_pipeline_highp;
 }
 
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void*** ip) const {
+    int fusedCounts[kNumFusedStages];
+    auto start_pipeline = this->build_pipeline(ip, fusedCounts);
+
+    if (gCountRasterPipelineFusion) {
+        gFusionPipelines.fetch_add(1, std::memory_order_relaxed);
+        gFusionStages.fetch_add(fNumStages, std::memory_order_relaxed);
+        for (int f = 0; f < kNumFusedStages; f++) {
+            if (fusedCounts[f]) {
+                gFusionFused[f].fetch_add(fusedCounts[f], std::memory_order_relaxed);
+            }
+        }
+    }
+    return start_pipeline;
+}
+
 void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h) const {
     if (this->empty()) {
         return;
     }
 
     // Best to not use fAlloc here... we can't bound how often run() will be called.
-    SkAutoSTMalloc<64, void*> program(fSlotsNeeded);
+    SkAutoSTMalloc<64, void*> storage(fSlotsNeeded);
 
-    auto start_pipeline = this->build_pipeline(program.get() + fSlotsNeeded);
-    start_pipeline(x,y,x+w,y+h, program.get());
+    // Fused stages take fewer slots, so the program may start after storage.get().
+    void** program = storage.get() + fSlotsNeeded;
+    auto start_pipeline = this->build_pipeline(&program);
+    start_pipeline(x,y,x+w,y+h, program);
 }
 
 std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile() const {
@@ -415,10 +489,59 @@ std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile()
         return [](size_t, size_t, size_t, size_t) {};
     }
 
-    void** program = fAlloc->makeArray<void*>(fSlotsNeeded);
+    void** program = fAlloc->makeArray<void*>(fSlotsNeeded) + fSlotsNeeded;
 
-    auto start_pipeline = this->build_pipeline(program + fSlotsNeeded);
+    auto start_pipeline = this->build_pipeline(&program);
     return [=](size_t x, size_t y, size_t w, size_t h) {
         start_pipeline(x,y,x+w,y+h, program);
     };
 }
+
+void SkRasterPipeline::getFusedRuns(int fusedRuns[kNumFusedStages]) const {
+    if (this->empty()) {
+        std::fill(fusedRuns, fusedRuns + kNumFusedStages, 0);
+        return;
+    }
+
+    SkAutoSTMalloc<64, void*> storage(fSlotsNeeded);
+    void** program = storage.get() + fSlotsNeeded;
+    this->build_pipeline(&program, fusedRuns);
+}
+
+SkRasterPipeline::FusionStats SkRasterPipeline::GetFusionStats() {
+    FusionStats stats;
+    stats.pipelines = gFusionPipelines.load(std::memory_order_relaxed);
+    stats.stages    = gFusionStages   .load(std::memory_order_relaxed);
+    for (int f = 0; f < kNumFusedStages; f++) {
+        stats.fused[f] = gFusionFused[f].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+int64_t SkRasterPipeline::FusionStats::stagesSaved() const {
+    int64_t saved = 0;
+    for (int f = 0; f < kNumFusedStages; f++) {
+        saved += fused[f] * (kFusedRuns[f].count - 1);
+    }
+    return saved;
+}
+
+void SkRasterPipeline::FusionStats::dump() const {
+    SkDebugf("SkRasterPipeline fusion: %lld pipelines, %lld stages, %lld fused away\n",
+             (long long)pipelines, (long long)stages, (long long)this->stagesSaved());
+    for (int f = 0; f < kNumFusedStages; f++) {
+        if (fused[f]) {
+            SkDebugf("\t%-40s %lld\n", FusedStageName((FusedStage)f), (long long)fused[f]);
+        }
+    }
+}
+
+const char* SkRasterPipeline::FusedStageName(FusedStage stage) {
+    switch (stage) {
+    #define M(st, ...) case st: return #st;
+        SK_RASTER_PIPELINE_FUSED_STAGES(M)
+    #undef M
+        case kNumFusedStages: break;
+    }
+    SkUNREACHABLE;
+}
@@ -112,6 +112,28 @@ struct skcms_TransferFunction;
     M(emboss)                                                      \
     M(swizzle)
 
+// Runs of stages common enough to be worth fusing, as M(fused_stage, count, stages...).
+// When a pipeline is built, each run of stages matching one of these is replaced by a single
+// fused stage that inlines all their work, saving the indirect calls between them. Runs are
+// matched back to front, and the first run listed that ends at a stage wins, so list longer
+// runs before the shorter runs they end with.
+#define SK_RASTER_PIPELINE_FUSED_STAGES(M)                                                \
+    M(seed_shader_matrix_scale_translate, 2, seed_shader, matrix_scale_translate)         \
+    M(seed_shader_matrix_2x3,             2, seed_shader, matrix_2x3)                     \
+    M(load_8888_swap_rb,                  2, load_8888, swap_rb)                          \
+    M(load_8888_dst_swap_rb_dst_srcover,  3, load_8888_dst, swap_rb_dst, srcover)         \
+    M(load_8888_dst_srcover,              2, load_8888_dst, srcover)                      \
+    M(load_8888_dst_swap_rb_dst,          2, load_8888_dst, swap_rb_dst)                  \
+    M(lerp_u8_swap_rb_store_8888,         3, lerp_u8, swap_rb, store_8888)                \
+    M(lerp_u8_store_8888,                 2, lerp_u8, store_8888)                         \
+    M(load_8888_dst_srcover_store_8888,   3, load_8888_dst, srcover, store_8888)          \
+    M(srcover_swap_rb_store_8888,         3, srcover, swap_rb, store_8888)                \
+    M(srcover_store_8888,                 2, srcover, store_8888)                         \
+    M(swap_rb_store_8888,                 2, swap_rb, store_8888)
+
+// The longest run of stages we fuse.
+static const int SkRasterPipeline_kMaxFusedRun = 4;
+
 // The largest number of pixels we handle at a time.
 static const int SkRasterPipeline_kMaxStride = 16;
 
@@ -216,6 +238,13 @@ public:
         SK_RASTER_PIPELINE_STAGES(M)
     #undef M
     };
+    enum FusedStage {
+    #define M(stage, ...) stage,
+        SK_RASTER_PIPELINE_FUSED_STAGES(M)
+    #undef M
+        kNumFusedStages
+    };
+
     void append(StockStage, void* = nullptr);
     void append(StockStage stage, const void* ctx) { this->append(stage, const_cast<void*>(ctx)); }
     void append(StockStage, uintptr_t ctx);
@@ -260,6 +289,24 @@ public:
 
     bool empty() const { return fStages == nullptr; }
 
+    // Counts how often stage fusion fires, collected while gCountRasterPipelineFusion is set.
+    struct FusionStats {
+        int64_t pipelines;                // Programs built by run() or compile().
+        int64_t stages;                   // Stages in those pipelines, before fusion.
+        int64_t fused[kNumFusedStages];   // Runs replaced by each fused stage.
+
+        // Stage calls saved per pixel, summed over every program built.
+        int64_t stagesSaved() const;
+        void dump() const;
+    };
+    static FusionStats GetFusionStats();
+
+    // Fills fusedRuns with how many runs each fused stage replaces in the program run() and
+    // compile() build for this pipeline. Unlike FusionStats, this ignores every other pipeline.
+    void getFusedRuns(int fusedRuns[kNumFusedStages]) const;
+
+    static const char* FusedStageName(FusedStage);
+
 private:
     struct StageList {
         StageList* prev;
@@ -267,8 +314,24 @@ private:
         void*      ctx;
     };
 
+    struct FusedRun {
+        int        count;
+        StockStage stages[SkRasterPipeline_kMaxFusedRun];
+    };
+    static const FusedRun kFusedRuns[kNumFusedStages];
+
     using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
-    StartPipelineFn build_pipeline(void**) const;
+    // Fills the program back to front from *ip, leaving *ip pointing at its first slot.
+    // The first form adds to FusionStats; the second reports this program's fused runs instead.
+    StartPipelineFn build_pipeline(void*** ip) const;
+    StartPipelineFn build_pipeline(void*** ip, int fusedCounts[]) const;
+
+    // Fills the program for stages[0..count) using one set of stage functions, fusing runs where
+    // fusedFns has a stage for them. Returns nullptr if some stage has no function in stageFns.
+    using StageFn = void(*)(void);
+    static void** fill_program(void** ip, const StageList* const stages[], int count,
+                               StageFn justReturn, const StageFn stageFns[],
+                               const StageFn fusedFns[], int fusedCounts[]);
 
     void unchecked_append(StockStage, void*);
 
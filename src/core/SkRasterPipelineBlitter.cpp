@@ -48,9 +48,11 @@ public:
     void blitMask  (const SkMask&, const SkIRect& clip)             override;
     void blitRect  (int x, int y, int width, int height)            override;
     void blitV     (int x, int y, int height, SkAlpha alpha)        override;
+    void blitSpans (const Span[], int count)                        override;
 
 private:
     void blitRectWithTrace(int x, int y, int w, int h, bool trace);
+    void buildBlitAntiH();
     void append_load_dst      (SkRasterPipeline*) const;
     void append_store         (SkRasterPipeline*) const;
 
@@ -389,25 +391,29 @@ void SkRasterPipelineBlitter::blitRectWithTrace(int x, int y, int w, int h, bool
     fBlitRect(x,y,w,h);
 }
 
+void SkRasterPipelineBlitter::buildBlitAntiH() {
+    SkRasterPipeline p(fAlloc);
+    p.extend(fColorPipeline);
+    p.append_gamut_clamp_if_normalized(fDst.info());
+    if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
+        p.append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
+        this->append_clip_scale(&p);
+        this->append_load_dst(&p);
+        SkBlendMode_AppendStages(fBlend, &p);
+    } else {
+        this->append_load_dst(&p);
+        SkBlendMode_AppendStages(fBlend, &p);
+        p.append(SkRasterPipeline::lerp_1_float, &fCurrentCoverage);
+        this->append_clip_lerp(&p);
+    }
+
+    this->append_store(&p);
+    fBlitAntiH = p.compile();
+}
+
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
     if (!fBlitAntiH) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
-            this->append_clip_scale(&p);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_1_float, &fCurrentCoverage);
-            this->append_clip_lerp(&p);
-        }
-
-        this->append_store(&p);
-        fBlitAntiH = p.compile();
+        this->buildBlitAntiH();
     }
 
     SK_BLITTER_TRACE_STEP(blitAntiH, true, /*scanlines=*/1ul, /*pixels=*/0ul);
@@ -426,6 +432,23 @@ void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const
     }
 }
 
+void SkRasterPipelineBlitter::blitSpans(const Span spans[], int count) {
+    SK_BLITTER_TRACE_STEP(blitSpans, true, /*scanlines=*/count, /*pixels=*/0ul);
+    for (int i = 0; i < count; ++i) {
+        const Span& span = spans[i];
+        switch (span.fAlpha) {
+            case 0x00: break;
+            case 0xff: this->blitRectWithTrace(span.fX, span.fY, span.fWidth, 1, false); break;
+            default:
+                if (!fBlitAntiH) {
+                    this->buildBlitAntiH();
+                }
+                fCurrentCoverage = span.fAlpha * (1/255.0f);
+                fBlitAntiH(span.fX, span.fY, span.fWidth, 1);
+        }
+    }
+}
+
 void SkRasterPipelineBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
     SkIRect clip = {x,y, x+2,y+1};
     uint8_t coverage[] = { (uint8_t)a0, (uint8_t)a1 };
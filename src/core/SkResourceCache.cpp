@@ -9,12 +9,14 @@
 
 #include "include/core/SkTraceMemoryDump.h"
 #include "include/private/SkMutex.h"
+#include "include/private/SkOnce.h"
 #include "include/private/SkTo.h"
 #include "src/core/SkDiscardableMemory.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMessageBus.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkSharedMutex.h"
 
 #include <stddef.h>
 #include <stdlib.h>
@@ -75,13 +77,280 @@ namespace {
 class SkResourceCache::Hash :
     public SkTHashTable<SkResourceCache::Rec*, SkResourceCache::Key, HashTraits> {};
 
+static void make_size_str(size_t size, SkString* str) {
+    const char suffix[] = { 'b', 'k', 'm', 'g', 't', 0 };
+    int i = 0;
+    while (suffix[i] && (size > 1024)) {
+        i += 1;
+        size >>= 10;
+    }
+    str->printf("%zu%c", size, suffix[i]);
+}
+
+static bool gDumpCacheTransactions;
+
+// Bumped after every PostPurgeSharedID(), so caches only poll their inbox (and take its lock)
+// when there might be something in it.
+static std::atomic<uint32_t> gPurgeSharedIDPostCount{0};
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Each shard has its own reader/writer lock, hash table and LRU list. find() only takes the lock
+// shared, so it can't reorder the list; instead it marks the Rec it found as recently used. When
+// purging walks up from the tail, it gives each marked Rec a second chance: it clears the mark and
+// moves the Rec back to the head rather than removing it. This batches the LRU updates into the
+// purge, and approximates the order the list would have had if every hit had moved its Rec.
+struct SkResourceCache::Shard {
+    ~Shard() {
+        Rec* rec = fHead;
+        while (rec) {
+            Rec* next = rec->fNext;
+            delete rec;
+            rec = next;
+        }
+    }
+
+    Rec* find(const Key& key) const SK_REQUIRES_SHARED(fLock) {
+        Rec** found = fHash.find(key);
+        return found ? *found : nullptr;
+    }
+
+    void add(Rec* rec) SK_REQUIRES(fLock) {
+        this->validate();
+
+        rec->fPrev = nullptr;
+        rec->fNext = fHead;
+        if (fHead) {
+            fHead->fPrev = rec;
+        }
+        fHead = rec;
+        if (!fTail) {
+            fTail = rec;
+        }
+        fHash.set(rec);
+        fBytesUsed += rec->bytesUsed();
+        fCount += 1;
+        fCache->account(rec, true);
+
+        this->validate();
+
+        if (gDumpCacheTransactions) {
+            SkString bytesStr, totalStr;
+            make_size_str(rec->bytesUsed(), &bytesStr);
+            make_size_str(fCache->getTotalBytesUsed(), &totalStr);
+            SkDebugf("RC:    add %5s %12p key %08x -- total %5s, count %d\n",
+                     bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(),
+                     fCache->fCount.load(std::memory_order_relaxed));
+        }
+    }
+
+    void remove(Rec* rec) SK_REQUIRES(fLock) {
+        SkASSERT(rec->canBePurged());
+        size_t used = rec->bytesUsed();
+        SkASSERT(used <= fBytesUsed);
+
+        this->release(rec);
+        fHash.remove(rec->getKey());
+
+        fBytesUsed -= used;
+        fCount -= 1;
+        fCache->account(rec, false);
+
+        if (gDumpCacheTransactions) {
+            SkString bytesStr, totalStr;
+            make_size_str(used, &bytesStr);
+            make_size_str(fCache->getTotalBytesUsed(), &totalStr);
+            SkDebugf("RC: remove %5s %12p key %08x -- total %5s, count %d\n",
+                     bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(),
+                     fCache->fCount.load(std::memory_order_relaxed));
+        }
+
+        delete rec;
+    }
+
+    // Remove purgeable Recs (only those in nameSpace, if it's not null) from the tail of the LRU
+    // list until at least bytesNeeded bytes and countNeeded Recs have been freed, or we run out.
+    // Unless forcePurge is set, Recs marked recently used get a second chance first.
+    void purge(void* nameSpace, size_t bytesNeeded, int countNeeded, bool forcePurge,
+               size_t* bytesFreed, int* countFreed) SK_REQUIRES(fLock) {
+        size_t bytes = 0;
+        int    count = 0;
+        // Marks are cleared as Recs move to the head, and nothing can mark them again while we
+        // hold the lock exclusively, so each Rec is visited at most twice.
+        Rec* rec = fTail;
+        while (rec && (forcePurge || bytes < bytesNeeded || count < countNeeded)) {
+            Rec* prev = rec->fPrev;
+            if (!nameSpace || rec->getKey().getNamespace() == nameSpace) {
+                if (!forcePurge && rec->fRecentlyUsed.exchange(false, std::memory_order_relaxed)) {
+                    this->moveToHead(rec);
+                } else if (rec->canBePurged()) {
+                    bytes += rec->bytesUsed();
+                    count += 1;
+                    this->remove(rec);
+                }
+            }
+            rec = prev;
+        }
+        *bytesFreed = bytes;
+        *countFreed = count;
+    }
+
+    void purgeSharedID(uint64_t sharedID) SK_REQUIRES(fLock) {
+        // go backwards, just like purge, just to make the code similar.
+        // could iterate either direction and still be correct.
+        Rec* rec = fTail;
+        while (rec) {
+            Rec* prev = rec->fPrev;
+            if (rec->getKey().getSharedID() == sharedID) {
+                // even though the "src" is now dead, caches could still be in-flight, so
+                // we have to check if it can be removed.
+                if (rec->canBePurged()) {
+                    this->remove(rec);
+                }
+            }
+            rec = prev;
+        }
+    }
+
+    void visitAll(Visitor visitor, void* context) const SK_REQUIRES_SHARED(fLock) {
+        const Rec* rec = fTail;
+        while (rec) {
+            visitor(*rec, context);
+            rec = rec->fPrev;
+        }
+    }
+
+    // Counts the bytes nameSpace uses in all the shards, and calls fn(bytes) before releasing
+    // their locks, so no Rec can be added or removed in between. That's more than the analysis
+    // can follow through the loops.
+    template <typename Fn>
+    static void WithNamespaceBytesUsed(Shard shards[], void* nameSpace, Fn&& fn)
+            SK_NO_THREAD_SAFETY_ANALYSIS {
+        for (int i = 0; i < kShardCount; ++i) {
+            shards[i].fLock.acquire();
+        }
+        size_t used = 0;
+        for (int i = 0; i < kShardCount; ++i) {
+            for (const Rec* rec = shards[i].fHead; rec; rec = rec->fNext) {
+                if (rec->getKey().getNamespace() == nameSpace) {
+                    used += rec->bytesUsed();
+                }
+            }
+        }
+        fn(used);
+        for (int i = 0; i < kShardCount; ++i) {
+            shards[i].fLock.release();
+        }
+    }
+
+#ifdef SK_DEBUG
+    void validate() const SK_REQUIRES_SHARED(fLock);
+#else
+    void validate() const {}
+#endif
+
+    mutable SkSharedMutex fLock;
+    Rec*   fHead      SK_GUARDED_BY(fLock) = nullptr;
+    Rec*   fTail      SK_GUARDED_BY(fLock) = nullptr;
+    Hash   fHash      SK_GUARDED_BY(fLock);
+    size_t fBytesUsed SK_GUARDED_BY(fLock) = 0;
+    int    fCount     SK_GUARDED_BY(fLock) = 0;
+
+    SkResourceCache* fCache = nullptr;
+
+private:
+    void release(Rec* rec) SK_REQUIRES(fLock) {
+        Rec* prev = rec->fPrev;
+        Rec* next = rec->fNext;
+
+        if (!prev) {
+            SkASSERT(fHead == rec);
+            fHead = next;
+        } else {
+            prev->fNext = next;
+        }
+
+        if (!next) {
+            fTail = prev;
+        } else {
+            next->fPrev = prev;
+        }
+
+        rec->fNext = rec->fPrev = nullptr;
+    }
+
+    void moveToHead(Rec* rec) SK_REQUIRES(fLock) {
+        if (fHead == rec) {
+            return;
+        }
+
+        SkASSERT(fHead);
+        SkASSERT(fTail);
+
+        this->validate();
+
+        this->release(rec);
+
+        fHead->fPrev = rec;
+        rec->fNext = fHead;
+        fHead = rec;
+
+        this->validate();
+    }
+};
+
+#ifdef SK_DEBUG
+void SkResourceCache::Shard::validate() const {
+    if (nullptr == fHead) {
+        SkASSERT(nullptr == fTail);
+        SkASSERT(0 == fBytesUsed);
+        return;
+    }
+
+    if (fHead == fTail) {
+        SkASSERT(nullptr == fHead->fPrev);
+        SkASSERT(nullptr == fHead->fNext);
+        SkASSERT(fHead->bytesUsed() == fBytesUsed);
+        return;
+    }
+
+    SkASSERT(nullptr == fHead->fPrev);
+    SkASSERT(fHead->fNext);
+    SkASSERT(nullptr == fTail->fNext);
+    SkASSERT(fTail->fPrev);
+
+    size_t used = 0;
+    int count = 0;
+    const Rec* rec = fHead;
+    while (rec) {
+        count += 1;
+        used += rec->bytesUsed();
+        SkASSERT(used <= fBytesUsed);
+        rec = rec->fNext;
+    }
+    SkASSERT(fCount == count);
+
+    rec = fTail;
+    while (rec) {
+        SkASSERT(count > 0);
+        count -= 1;
+        SkASSERT(used >= rec->bytesUsed());
+        used -= rec->bytesUsed();
+        rec = rec->fPrev;
+    }
+
+    SkASSERT(0 == count);
+    SkASSERT(0 == used);
+}
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkResourceCache::init() {
-    fHead = nullptr;
-    fTail = nullptr;
-    fHash = new Hash;
+    fShards.reset(new Shard[kShardCount]);
+    for (int i = 0; i < kShardCount; ++i) {
+        fShards[i].fCache = this;
+    }
     fTotalBytesUsed = 0;
     fCount = 0;
     fSingleAllocationByteLimit = 0;
@@ -103,14 +372,44 @@ SkResourceCache::SkResourceCache(size_t byteLimit)
     fTotalByteLimit = byteLimit;
 }
 
-SkResourceCache::~SkResourceCache() {
-    Rec* rec = fHead;
-    while (rec) {
-        Rec* next = rec->fNext;
-        delete rec;
-        rec = next;
+SkResourceCache::~SkResourceCache() = default;
+
+int SkResourceCache::ShardIndexFor(const Key& key) {
+    // SkTHashTable indexes with the low bits of the hash, so pick shards with the top.
+    return key.hash() >> (32 - kShardBits);
+}
+
+SkResourceCache::Shard& SkResourceCache::shardFor(const Key& key) const {
+    return fShards[ShardIndexFor(key)];
+}
+
+SkResourceCache::NamespaceBudget* SkResourceCache::budgetFor(void* nameSpace) const {
+    const int count = fNamespaceBudgetCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        if (fNamespaceBudgets[i].fNamespace.load(std::memory_order_relaxed) == nameSpace) {
+            return const_cast<NamespaceBudget*>(&fNamespaceBudgets[i]);
+        }
+    }
+    return nullptr;
+}
+
+void SkResourceCache::account(const Rec* rec, bool added) {
+    const size_t used = rec->bytesUsed();
+    NamespaceBudget* budget = this->budgetFor(rec->getKey().getNamespace());
+    if (added) {
+        fTotalBytesUsed.fetch_add(used, std::memory_order_relaxed);
+        fCount.fetch_add(1, std::memory_order_relaxed);
+        if (budget) {
+            budget->fBytesUsed.fetch_add(used, std::memory_order_relaxed);
+        }
+    } else {
+        SkASSERT(used <= fTotalBytesUsed.load(std::memory_order_relaxed));
+        fTotalBytesUsed.fetch_sub(used, std::memory_order_relaxed);
+        fCount.fetch_sub(1, std::memory_order_relaxed);
+        if (budget) {
+            budget->fBytesUsed.fetch_sub(used, std::memory_order_relaxed);
+        }
     }
-    delete fHash;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -118,90 +417,78 @@ SkResourceCache::~SkResourceCache() {
 bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     this->checkMessages();
 
-    if (auto found = fHash->find(key)) {
-        Rec* rec = *found;
+    Shard& shard = this->shardFor(key);
+    Rec* stale;
+    {
+        SkAutoSharedMutexShared lock(shard.fLock);
+        Rec* rec = shard.find(key);
+        if (!rec) {
+            return false;
+        }
         if (visitor(*rec, context)) {
-            this->moveToHead(rec);  // for our LRU
+            // for our LRU; avoid dirtying the cache line when the Rec is already marked.
+            if (!rec->fRecentlyUsed.load(std::memory_order_relaxed)) {
+                rec->fRecentlyUsed.store(true, std::memory_order_relaxed);
+            }
             return true;
-        } else {
-            this->remove(rec);  // stale
-            return false;
         }
+        stale = rec;
     }
-    return false;
-}
 
-static void make_size_str(size_t size, SkString* str) {
-    const char suffix[] = { 'b', 'k', 'm', 'g', 't', 0 };
-    int i = 0;
-    while (suffix[i] && (size > 1024)) {
-        i += 1;
-        size >>= 10;
+    // Another thread may have replaced or removed the stale Rec while we swapped locks.
+    SkAutoSharedMutexExclusive lock(shard.fLock);
+    if (shard.find(key) == stale && stale->canBePurged()) {
+        shard.remove(stale);
     }
-    str->printf("%zu%c", size, suffix[i]);
+    return false;
 }
 
-static bool gDumpCacheTransactions;
-
 void SkResourceCache::add(Rec* rec, void* payload) {
     this->checkMessages();
 
     SkASSERT(rec);
-    // See if we already have this key (racy inserts, etc.)
-    if (Rec** preexisting = fHash->find(rec->getKey())) {
-        Rec* prev = *preexisting;
-        if (prev->canBePurged()) {
-            // if it can be purged, the install may fail, so we have to remove it
-            this->remove(prev);
-        } else {
-            // if it cannot be purged, we reuse it and delete the new one
-            prev->postAddInstall(payload);
-            delete rec;
-            return;
+    void* nameSpace = rec->getKey().getNamespace();
+    Shard& shard = this->shardFor(rec->getKey());
+    {
+        SkAutoSharedMutexExclusive lock(shard.fLock);
+        // See if we already have this key (racy inserts, etc.)
+        if (Rec* prev = shard.find(rec->getKey())) {
+            if (prev->canBePurged()) {
+                // if it can be purged, the install may fail, so we have to remove it
+                shard.remove(prev);
+            } else {
+                // if it cannot be purged, we reuse it and delete the new one
+                prev->postAddInstall(payload);
+                delete rec;
+                return;
+            }
         }
-    }
-
-    this->addToHead(rec);
-    fHash->set(rec);
-    rec->postAddInstall(payload);
 
-    if (gDumpCacheTransactions) {
-        SkString bytesStr, totalStr;
-        make_size_str(rec->bytesUsed(), &bytesStr);
-        make_size_str(fTotalBytesUsed, &totalStr);
-        SkDebugf("RC:    add %5s %12p key %08x -- total %5s, count %d\n",
-                 bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(), fCount);
+        shard.add(rec);
+        rec->postAddInstall(payload);
+        // Once we unlock, rec may be purged by another thread at any time.
     }
 
     // since the new rec may push us over-budget, we perform a purge check now
+    if (NamespaceBudget* budget = this->budgetFor(nameSpace)) {
+        size_t limit = budget->fByteLimit.load(std::memory_order_relaxed);
+        if (limit && budget->fBytesUsed.load(std::memory_order_relaxed) > limit) {
+            this->purge(nameSpace, false);
+        }
+    }
     this->purgeAsNeeded();
 }
 
-void SkResourceCache::remove(Rec* rec) {
-    SkASSERT(rec->canBePurged());
-    size_t used = rec->bytesUsed();
-    SkASSERT(used <= fTotalBytesUsed);
-
-    this->release(rec);
-    fHash->remove(rec->getKey());
-
-    fTotalBytesUsed -= used;
-    fCount -= 1;
-
-    //SkDebugf("-RC count [%3d] bytes %d\n", fCount, fTotalBytesUsed);
-
-    if (gDumpCacheTransactions) {
-        SkString bytesStr, totalStr;
-        make_size_str(used, &bytesStr);
-        make_size_str(fTotalBytesUsed, &totalStr);
-        SkDebugf("RC: remove %5s %12p key %08x -- total %5s, count %d\n",
-                 bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(), fCount);
+bool SkResourceCache::overBudget(void* nameSpace, size_t* bytesNeeded, int* countNeeded) const {
+    if (nameSpace) {
+        NamespaceBudget* budget = this->budgetFor(nameSpace);
+        size_t limit = budget ? budget->fByteLimit.load(std::memory_order_relaxed) : 0,
+               used  = budget ? budget->fBytesUsed.load(std::memory_order_relaxed) : 0;
+        *bytesNeeded = (limit && used > limit) ? used - limit : 0;
+        *countNeeded = 0;
+        return *bytesNeeded > 0;
     }
 
-    delete rec;
-}
-
-void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     size_t byteLimit;
     int    countLimit;
 
@@ -210,20 +497,61 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
         byteLimit = UINT32_MAX;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
-        byteLimit = fTotalByteLimit;
+        byteLimit = this->getTotalByteLimit();
     }
 
-    Rec* rec = fTail;
-    while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
-            break;
+    // Purge until we are strictly under both limits.
+    size_t used  = this->getTotalBytesUsed();
+    int    count = fCount.load(std::memory_order_relaxed);
+    *bytesNeeded = used  >= byteLimit  ? used  - byteLimit  + 1 : 0;
+    *countNeeded = count >= countLimit ? count - countLimit + 1 : 0;
+    return *bytesNeeded > 0 || *countNeeded > 0;
+}
+
+void SkResourceCache::purgeAsNeeded(bool forcePurge) {
+    size_t bytesNeeded;
+    int    countNeeded;
+    if (forcePurge || this->overBudget(nullptr, &bytesNeeded, &countNeeded)) {
+        this->purge(nullptr, forcePurge);
+    }
+}
+
+void SkResourceCache::purge(void* nameSpace, bool forcePurge) {
+    SkAutoMutexExclusive purgeLock(fPurgeLock);
+
+    for (;;) {
+        size_t bytesNeeded = SIZE_MAX;
+        int    countNeeded = SK_MaxS32;
+        // Re-check, another thread may have purged while we waited for the lock.
+        if (!forcePurge && !this->overBudget(nameSpace, &bytesNeeded, &countNeeded)) {
+            return;
         }
 
-        Rec* prev = rec->fPrev;
-        if (rec->canBePurged()) {
-            this->remove(rec);
+        // Take an even slice from the tail of each shard, to approximate one global LRU list.
+        size_t bytesSlice = forcePurge ? SIZE_MAX : (bytesNeeded + kShardCount - 1) / kShardCount;
+        int    countSlice = forcePurge ? SK_MaxS32 : (countNeeded + kShardCount - 1) / kShardCount;
+
+        int countFreed = 0;
+        for (int i = 0; i < kShardCount; ++i) {
+            // Stop as soon as we're under budget. We start where the last pass stopped, so small
+            // purges don't always come out of the same shards.
+            if (!forcePurge && i > 0 && !this->overBudget(nameSpace, &bytesNeeded, &countNeeded)) {
+                return;
+            }
+            Shard& shard = fShards[fNextPurgeShard];
+            fNextPurgeShard = (fNextPurgeShard + 1) % kShardCount;
+            SkAutoSharedMutexExclusive lock(shard.fLock);
+            size_t shardBytesFreed;
+            int    shardCountFreed;
+            shard.purge(nameSpace, bytesSlice, countSlice, forcePurge,
+                        &shardBytesFreed, &shardCountFreed);
+            countFreed += shardCountFreed;
+        }
+
+        // A shard only frees less than its slice when it has nothing left to purge.
+        if (forcePurge || 0 == countFreed) {
+            return;
         }
-        rec = prev;
     }
 }
 
@@ -241,28 +569,16 @@ void SkResourceCache::purgeSharedID(uint64_t sharedID) {
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
     gPurgeCallCounter += 1;
-    bool found = false;
+    int countBefore = fCount.load();
 #endif
-    // go backwards, just like purgeAsNeeded, just to make the code similar.
-    // could iterate either direction and still be correct.
-    Rec* rec = fTail;
-    while (rec) {
-        Rec* prev = rec->fPrev;
-        if (rec->getKey().getSharedID() == sharedID) {
-            // even though the "src" is now dead, caches could still be in-flight, so
-            // we have to check if it can be removed.
-            if (rec->canBePurged()) {
-                this->remove(rec);
-            }
-#ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
-            found = true;
-#endif
-        }
-        rec = prev;
+    for (int i = 0; i < kShardCount; ++i) {
+        Shard& shard = fShards[i];
+        SkAutoSharedMutexExclusive lock(shard.fLock);
+        shard.purgeSharedID(sharedID);
     }
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
-    if (found) {
+    if (fCount.load() != countBefore) {
         gPurgeHitCounter += 1;
     }
 
@@ -272,177 +588,122 @@ void SkResourceCache::purgeSharedID(uint64_t sharedID) {
 }
 
 void SkResourceCache::visitAll(Visitor visitor, void* context) {
-    // go backwards, just like purgeAsNeeded, just to make the code similar.
-    // could iterate either direction and still be correct.
-    Rec* rec = fTail;
-    while (rec) {
-        visitor(*rec, context);
-        rec = rec->fPrev;
+    for (int i = 0; i < kShardCount; ++i) {
+        const Shard& shard = fShards[i];
+        SkAutoSharedMutexShared lock(shard.fLock);
+        shard.visitAll(visitor, context);
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
-    size_t prevLimit = fTotalByteLimit;
-    fTotalByteLimit = newLimit;
+    size_t prevLimit = fTotalByteLimit.exchange(newLimit);
     if (newLimit < prevLimit) {
         this->purgeAsNeeded();
     }
     return prevLimit;
 }
 
-SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
-    this->checkMessages();
-
-    if (fDiscardableFactory) {
-        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
-        return dm ? new SkCachedData(bytes, dm) : nullptr;
-    } else {
-        return new SkCachedData(sk_malloc_throw(bytes), bytes);
-    }
-}
-
-///////////////////////////////////////////////////////////////////////////////
-
-void SkResourceCache::release(Rec* rec) {
-    Rec* prev = rec->fPrev;
-    Rec* next = rec->fNext;
+size_t SkResourceCache::setNamespaceByteLimit(void* nameSpace, size_t newLimit) {
+    SkASSERT(nameSpace);
 
-    if (!prev) {
-        SkASSERT(fHead == rec);
-        fHead = next;
-    } else {
-        prev->fNext = next;
+    size_t prevLimit;
+    {
+        SkAutoMutexExclusive purgeLock(fPurgeLock);
+        NamespaceBudget* budget = this->budgetFor(nameSpace);
+        if (!budget) {
+            if (0 == newLimit) {
+                return 0;
+            }
+            const int index = fNamespaceBudgetCount.load(std::memory_order_relaxed);
+            if (index == kMaxNamespaceBudgets) {
+                SkDEBUGFAIL("Too many namespace budgets.");
+                return 0;
+            }
+            budget = &fNamespaceBudgets[index];
+
+            // Start counting with what the namespace already holds. The budget must be visible
+            // to account() before any of those Recs can be removed.
+            Shard::WithNamespaceBytesUsed(fShards.get(), nameSpace, [&](size_t used) {
+                budget->fNamespace.store(nameSpace, std::memory_order_relaxed);
+                budget->fBytesUsed.store(used, std::memory_order_relaxed);
+                fNamespaceBudgetCount.store(index + 1, std::memory_order_release);
+            });
+        }
+        prevLimit = budget->fByteLimit.exchange(newLimit);
     }
 
-    if (!next) {
-        fTail = prev;
-    } else {
-        next->fPrev = prev;
+    if (newLimit) {
+        this->purge(nameSpace, false);
     }
-
-    rec->fNext = rec->fPrev = nullptr;
+    return prevLimit;
 }
 
-void SkResourceCache::moveToHead(Rec* rec) {
-    if (fHead == rec) {
-        return;
-    }
-
-    SkASSERT(fHead);
-    SkASSERT(fTail);
-
-    this->validate();
-
-    this->release(rec);
-
-    fHead->fPrev = rec;
-    rec->fNext = fHead;
-    fHead = rec;
-
-    this->validate();
+size_t SkResourceCache::getNamespaceBytesUsed(void* nameSpace) const {
+    NamespaceBudget* budget = this->budgetFor(nameSpace);
+    return budget ? budget->fBytesUsed.load(std::memory_order_relaxed) : 0;
 }
 
-void SkResourceCache::addToHead(Rec* rec) {
-    this->validate();
+SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
+    this->checkMessages();
 
-    rec->fPrev = nullptr;
-    rec->fNext = fHead;
-    if (fHead) {
-        fHead->fPrev = rec;
-    }
-    fHead = rec;
-    if (!fTail) {
-        fTail = rec;
+    if (fDiscardableFactory) {
+        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
+        return dm ? new SkCachedData(bytes, dm) : nullptr;
+    } else {
+        return new SkCachedData(sk_malloc_throw(bytes), bytes);
     }
-    fTotalBytesUsed += rec->bytesUsed();
-    fCount += 1;
-
-    this->validate();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void SkResourceCache::dump() const {
 #ifdef SK_DEBUG
-void SkResourceCache::validate() const {
-    if (nullptr == fHead) {
-        SkASSERT(nullptr == fTail);
-        SkASSERT(0 == fTotalBytesUsed);
-        return;
-    }
-
-    if (fHead == fTail) {
-        SkASSERT(nullptr == fHead->fPrev);
-        SkASSERT(nullptr == fHead->fNext);
-        SkASSERT(fHead->bytesUsed() == fTotalBytesUsed);
-        return;
-    }
-
-    SkASSERT(nullptr == fHead->fPrev);
-    SkASSERT(fHead->fNext);
-    SkASSERT(nullptr == fTail->fNext);
-    SkASSERT(fTail->fPrev);
-
-    size_t used = 0;
-    int count = 0;
-    const Rec* rec = fHead;
-    while (rec) {
-        count += 1;
-        used += rec->bytesUsed();
-        SkASSERT(used <= fTotalBytesUsed);
-        rec = rec->fNext;
-    }
-    SkASSERT(fCount == count);
-
-    rec = fTail;
-    while (rec) {
-        SkASSERT(count > 0);
-        count -= 1;
-        SkASSERT(used >= rec->bytesUsed());
-        used -= rec->bytesUsed();
-        rec = rec->fPrev;
+    for (int i = 0; i < kShardCount; ++i) {
+        const Shard& shard = fShards[i];
+        SkAutoSharedMutexShared lock(shard.fLock);
+        shard.validate();
     }
-
-    SkASSERT(0 == count);
-    SkASSERT(0 == used);
-}
 #endif
 
-void SkResourceCache::dump() const {
-    this->validate();
-
     SkDebugf("SkResourceCache: count=%d bytes=%zu %s\n",
-             fCount, fTotalBytesUsed, fDiscardableFactory ? "discardable" : "malloc");
+             fCount.load(), this->getTotalBytesUsed(),
+             fDiscardableFactory ? "discardable" : "malloc");
 }
 
 size_t SkResourceCache::setSingleAllocationByteLimit(size_t newLimit) {
-    size_t oldLimit = fSingleAllocationByteLimit;
-    fSingleAllocationByteLimit = newLimit;
-    return oldLimit;
+    return fSingleAllocationByteLimit.exchange(newLimit);
 }
 
 size_t SkResourceCache::getSingleAllocationByteLimit() const {
-    return fSingleAllocationByteLimit;
+    return fSingleAllocationByteLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkResourceCache::getEffectiveSingleAllocationByteLimit() const {
     // fSingleAllocationByteLimit == 0 means the caller is asking for our default
-    size_t limit = fSingleAllocationByteLimit;
+    size_t limit = this->getSingleAllocationByteLimit();
 
     // if we're not discardable (i.e. we are fixed-budget) then cap the single-limit
     // to our budget.
     if (nullptr == fDiscardableFactory) {
+        size_t totalLimit = this->getTotalByteLimit();
         if (0 == limit) {
-            limit = fTotalByteLimit;
+            limit = totalLimit;
         } else {
-            limit = std::min(limit, fTotalByteLimit);
+            limit = std::min(limit, totalLimit);
         }
     }
     return limit;
 }
 
 void SkResourceCache::checkMessages() {
+    // Polling takes the inbox's lock, so skip it unless something was posted since we last did.
+    uint32_t postCount = gPurgeSharedIDPostCount.load(std::memory_order_acquire);
+    if (fLastPurgeSharedIDPostCount.exchange(postCount, std::memory_order_relaxed) == postCount) {
+        return;
+    }
+
     SkTArray<PurgeSharedIDMessage> msgs;
     fPurgeSharedIDInbox.poll(&msgs);
     for (int i = 0; i < msgs.count(); ++i) {
@@ -452,99 +713,88 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static SkResourceCache* gResourceCache = nullptr;
-static SkMutex& resource_cache_mutex() {
-    static SkMutex& mutex = *(new SkMutex);
-    return mutex;
-}
-
-/** Must hold resource_cache_mutex() when calling. */
+// The cache is thread-safe itself, so the static methods only need to create it once.
 static SkResourceCache* get_cache() {
-    // resource_cache_mutex() is always held when this is called, so we don't need to be fancy in here.
-    resource_cache_mutex().assertHeld();
-    if (nullptr == gResourceCache) {
+    static SkOnce once;
+    static SkResourceCache* gResourceCache;
+    once([] {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
         gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
 #else
         gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #endif
-    }
+    });
     return gResourceCache;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getTotalBytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getTotalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->setTotalByteLimit(newLimit);
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->discardableFactory();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->dump();
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->setSingleAllocationByteLimit(size);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getEffectiveSingleAllocationByteLimit();
 }
 
+size_t SkResourceCache::SetNamespaceByteLimit(void* nameSpace, size_t newLimit) {
+    return get_cache()->setNamespaceByteLimit(nameSpace, newLimit);
+}
+
+size_t SkResourceCache::GetNamespaceBytesUsed(void* nameSpace) {
+    return get_cache()->getNamespaceBytesUsed(nameSpace);
+}
+
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->purgeAll();
 }
 
 void SkResourceCache::CheckMessages() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->checkMessages();
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->add(rec, payload);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->visitAll(visitor, context);
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
     if (sharedID) {
         SkMessageBus<PurgeSharedIDMessage, uint32_t>::Post(PurgeSharedIDMessage(sharedID));
+        gPurgeSharedIDPostCount.fetch_add(1, std::memory_order_release);
     }
 }
 
@@ -10,8 +10,12 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/private/SkTDArray.h"
+#include "include/private/SkMutex.h"
 #include "src/core/SkMessageBus.h"
 
+#include <atomic>
+#include <memory>
+
 class SkCachedData;
 class SkDiscardableMemory;
 class SkTraceMemoryDump;
@@ -19,9 +23,9 @@ class SkTraceMemoryDump;
 /**
  *  Cache object for bitmaps (with possible scale in X Y as part of the key).
  *
- *  Multiple caches can be instantiated, but each instance is not implicitly
- *  thread-safe, so if a given instance is to be shared across threads, the
- *  caller must manage the access itself (e.g. via a mutex).
+ *  Multiple caches can be instantiated, and each instance is thread-safe. Recs are spread over
+ *  independently locked shards by the hash of their key. Lookups only take their shard's lock
+ *  shared, so threads finding Recs (even the same Rec) don't serialize on each other.
  *
  *  As a convenience, a global instance is also defined, which can be safely
  *  access across threads via the static methods (e.g. FindAndLock, etc.).
@@ -105,6 +109,8 @@ public:
     private:
         Rec*    fNext;
         Rec*    fPrev;
+        // Set by find() instead of reordering the LRU list; see SkResourceCache::Shard.
+        std::atomic<bool> fRecentlyUsed{false};
 
         friend class SkResourceCache;
     };
@@ -126,6 +132,9 @@ public:
      *  The return value determines what the cache will do with the Rec. If the function returns
      *  true, then the Rec is considered "valid". If false is returned, the Rec will be considered
      *  "stale" and will be purged from the cache.
+     *
+     *  The visitor may be called on the same Rec from several threads at once, so it must only
+     *  read the Rec, or synchronize any changes it makes itself.
      */
     typedef bool (*FindVisitor)(const Rec&, void* context);
 
@@ -164,6 +173,9 @@ public:
     static size_t GetSingleAllocationByteLimit();
     static size_t GetEffectiveSingleAllocationByteLimit();
 
+    static size_t SetNamespaceByteLimit(void* nameSpace, size_t newLimit);
+    static size_t GetNamespaceBytesUsed(void* nameSpace);
+
     static void PurgeAll();
     static void CheckMessages();
 
@@ -221,8 +233,8 @@ public:
     void add(Rec*, void* payload = nullptr);
     void visitAll(Visitor, void* context);
 
-    size_t getTotalBytesUsed() const { return fTotalBytesUsed; }
-    size_t getTotalByteLimit() const { return fTotalByteLimit; }
+    size_t getTotalBytesUsed() const { return fTotalBytesUsed.load(std::memory_order_relaxed); }
+    size_t getTotalByteLimit() const { return fTotalByteLimit.load(std::memory_order_relaxed); }
 
     /**
      *  This is respected by SkBitmapProcState::possiblyScaleImage.
@@ -242,10 +254,22 @@ public:
      */
     size_t setTotalByteLimit(size_t newLimit);
 
+    /**
+     *  Caps the bytes used by Recs whose keys are in nameSpace, on top of the total budget, so
+     *  one kind of Rec can't push all the others out. When an add() takes the namespace over its
+     *  limit, its least recently used Recs are purged. 0 means no limit. Returns the previous
+     *  limit. At most kMaxNamespaceBudgets namespaces can be given a limit.
+     */
+    size_t setNamespaceByteLimit(void* nameSpace, size_t newLimit);
+    // Only tracked for namespaces that have been given a limit; returns 0 for others.
+    size_t getNamespaceBytesUsed(void* nameSpace) const;
+
+    static constexpr int kMaxNamespaceBudgets = 8;
+
     void purgeSharedID(uint64_t sharedID);
 
     void purgeAll() {
-        this->purgeAsNeeded(true);
+        this->purge(nullptr, true);
     }
 
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
@@ -257,37 +281,54 @@ public:
      */
     void dump() const;
 
+    // Which of the independently locked shards key lives in. Recs in the same shard are purged in
+    // LRU order; across shards it is only approximate. Exposed for tests.
+    static int ShardIndexFor(const Key& key);
+
 private:
-    Rec*    fHead;
-    Rec*    fTail;
+    static constexpr int kShardBits  = 4;
+    static constexpr int kShardCount = 1 << kShardBits;
 
     class Hash;
-    Hash*   fHash;
+    struct Shard;
+    std::unique_ptr<Shard[]> fShards;
+
+    struct NamespaceBudget {
+        std::atomic<void*>  fNamespace{nullptr};
+        std::atomic<size_t> fByteLimit{0};
+        std::atomic<size_t> fBytesUsed{0};
+    };
+    // Slots [0, fNamespaceBudgetCount) are in use. They are only added, never removed.
+    NamespaceBudget  fNamespaceBudgets[kMaxNamespaceBudgets];
+    std::atomic<int> fNamespaceBudgetCount{0};
 
     DiscardableFactory  fDiscardableFactory;
 
-    size_t  fTotalBytesUsed;
-    size_t  fTotalByteLimit;
-    size_t  fSingleAllocationByteLimit;
-    int     fCount;
+    std::atomic<size_t> fTotalBytesUsed;
+    std::atomic<size_t> fTotalByteLimit;
+    std::atomic<size_t> fSingleAllocationByteLimit;
+    std::atomic<int>    fCount;
+
+    // Only one thread purges at a time, so purges don't overshoot by each freeing the excess.
+    SkMutex fPurgeLock;
+    int     fNextPurgeShard SK_GUARDED_BY(fPurgeLock) = 0;
 
     SkMessageBus<PurgeSharedIDMessage, uint32_t>::Inbox fPurgeSharedIDInbox;
+    std::atomic<uint32_t> fLastPurgeSharedIDPostCount{0};
+
+    Shard& shardFor(const Key&) const;
+    NamespaceBudget* budgetFor(void* nameSpace) const;
+
+    // Updates the totals (and the namespace budget) when a Rec enters or leaves a shard.
+    void account(const Rec*, bool added);
 
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
-
-    // linklist management
-    void moveToHead(Rec*);
-    void addToHead(Rec*);
-    void release(Rec*);
-    void remove(Rec*);
+    // Purges Recs (only those in nameSpace, if it's not null) until back under budget, or
+    // every purgeable Rec if forcePurge is set.
+    void purge(void* nameSpace, bool forcePurge);
+    bool overBudget(void* nameSpace, size_t* bytesNeeded, int* countNeeded) const;
 
     void init();    // called by constructors
-
-#ifdef SK_DEBUG
-    void validate() const;
-#else
-    void validate() const {}
-#endif
 };
 #endif
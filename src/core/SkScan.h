@@ -25,6 +25,12 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+extern std::atomic<bool> gSkUseSparseStrips;
+
+// Fills anti-aliased paths covering at least two bands of a rect clip on multiple threads.
+// Those fills always use sparse strips instead of AAA or supersampling, so turning this on
+// changes how large paths rasterize, not just how fast.
+extern std::atomic<bool> gSkUseThreadedPathFill;
 
 class AdditiveBlitter;
 
@@ -56,6 +62,12 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    /**
+     *  Like AntiFillPath(), but always uses the sparse strips scan converter. Its coverage in
+     *  each row doesn't depend on the top and bottom of the clip, so filling a path in separate
+     *  horizontal bands of a rect clip draws exactly what filling it all at once would.
+     */
+    static void SparseStripsAntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -84,7 +96,8 @@ private:
     static void FillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
-    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE);
+    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE,
+                             bool forceSparseStrips = false);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -95,6 +108,8 @@ private:
                             const SkIRect& clipBounds, bool forceRLE);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+    static void SparseStripsFillPath(const SkPath& path, SkBlitter* blitter,
+                                     const SkIRect& pathIR, const SkIRect& clipBounds);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
@@ -117,6 +117,8 @@ public:
     /// Blits a row of pixels, with location and width specified
     /// in supersampled coordinates.
     void blitH(int x, int y, int width) override;
+    /// Blits rows of pixels, all solid, in supersampled coordinates.
+    void blitSpans(const Span spans[], int count) override;
     /// Blits a rectangle of pixels, with location and size specified
     /// in supersampled coordinates.
     void blitRect(int x, int y, int width, int height) override;
@@ -198,6 +200,14 @@ static inline int coverage_to_exact_alpha(int aa) {
     return alpha - (alpha >> 8);
 }
 
+void SuperBlitter::blitSpans(const Span spans[], int count) {
+    // Coverage comes from how many supersampled rows each span covers, so spans are all solid.
+    for (int i = 0; i < count; ++i) {
+        SkASSERT(spans[i].fAlpha == 0xFF);
+        this->SuperBlitter::blitH(spans[i].fX, spans[i].fY, spans[i].fWidth);
+    }
+}
+
 void SuperBlitter::blitH(int x, int y, int width) {
     SkASSERT(width > 0);
 
@@ -401,6 +411,7 @@ public:
     }
 
     void blitH(int x, int y, int width) override;
+    void blitSpans(const Span spans[], int count) override;
 
     static bool CanHandleRect(const SkIRect& bounds) {
 #ifdef FORCE_RLE
@@ -525,6 +536,13 @@ static void add_aa_span(uint8_t* alpha, U8CPU startAlpha, int middleCount,
     saturated_add(alpha, stopAlpha);
 }
 
+void MaskSuperBlitter::blitSpans(const Span spans[], int count) {
+    for (int i = 0; i < count; ++i) {
+        SkASSERT(spans[i].fAlpha == 0xFF);
+        this->MaskSuperBlitter::blitH(spans[i].fX, spans[i].fY, spans[i].fWidth);
+    }
+}
+
 void MaskSuperBlitter::blitH(int x, int y, int width) {
     int iy = (y >> SHIFT);
 
@@ -712,12 +730,13 @@ static int rect_overflows_short_shift(SkIRect rect, int shift) {
 }
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, bool forceSparseStrips) {
     if (origClip.isEmpty()) {
         return;
     }
 
     const bool isInverse = path.isInverseFillType();
+    const bool sparseStrips = forceSparseStrips || gSkUseSparseStrips;
     SkIRect ir = safeRoundOut(path.getBounds());
     if (ir.isEmpty()) {
         if (isInverse) {
@@ -728,7 +747,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
     // If the intersection of the path bounds and the clip bounds
     // will overflow 32767 when << by SHIFT, we can't supersample,
-    // so draw without antialiasing.
+    // so draw without antialiasing. (Sparse strips doesn't supersample.)
     SkIRect clippedIR;
     if (isInverse) {
        // If the path is an inverse fill, it's going to fill the entire
@@ -739,7 +758,7 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
            return;
        }
     }
-    if (rect_overflows_short_shift(clippedIR, SHIFT)) {
+    if (!sparseStrips && rect_overflows_short_shift(clippedIR, SHIFT)) {
         SkScan::FillPath(path, origClip, blitter);
         return;
     }
@@ -785,7 +804,9 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     SkScalar avgLength, complexity;
     compute_complexity(path, avgLength, complexity);
 
-    if (ShouldUseAAA(path, avgLength, complexity)) {
+    if (sparseStrips) {
+        SkScan::SparseStripsFillPath(path, blitter, ir, clipRgn->getBounds());
+    } else if (ShouldUseAAA(path, avgLength, complexity)) {
         // Do not use AAA if path is too complicated:
         // there won't be any speedup or significant visual improvement.
         SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
@@ -835,3 +856,21 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitte
         AntiFillPath(path, tmp, &aaBlitter, true); // SkAAClipBlitter can blitMask, why forceRLE?
     }
 }
+
+void SkScan::SparseStripsAntiFillPath(const SkPath& path, const SkRasterClip& clip,
+                                      SkBlitter* blitter) {
+    if (clip.isEmpty() || !path.isFinite()) {
+        return;
+    }
+
+    if (clip.isBW()) {
+        AntiFillPath(path, clip.bwRgn(), blitter, false, true);
+    } else {
+        SkRegion        tmp;
+        SkAAClipBlitter aaBlitter;
+
+        tmp.setRect(clip.getBounds());
+        aaBlitter.init(blitter, &clip.aaRgn());
+        AntiFillPath(path, tmp, &aaBlitter, true, true);
+    }
+}
@@ -104,6 +104,7 @@ static void walk_edges(SkEdge* prevHead, SkPathFillType fillType,
 
     int curr_y = start_y;
     int windingMask = SkPathFillType_IsEvenOdd(fillType) ? 1 : -1;
+    SkSpanBatcher spans(blitter);
 
     for (;;) {
         int     w = 0;
@@ -132,7 +133,7 @@ static void walk_edges(SkEdge* prevHead, SkPathFillType fillType,
                 int width = x - left;
                 SkASSERT(width >= 0);
                 if (width > 0) {
-                    blitter->blitH(left, curr_y, width);
+                    spans.add(left, curr_y, width);
                 }
             }
 
@@ -172,11 +173,12 @@ static void walk_edges(SkEdge* prevHead, SkPathFillType fillType,
         if ((w & windingMask) != 0) { // was our right-edge culled away?
             int width = rightClip - left;
             if (width > 0) {
-                blitter->blitH(left, curr_y, width);
+                spans.add(left, curr_y, width);
             }
         }
 
         if (proc) {
+            spans.flush();
             proc(blitter, curr_y, PREPOST_END);    // post-proc
         }
 
@@ -231,6 +233,8 @@ static void walk_simple_edges(SkEdge* prevHead, SkBlitter* blitter, int start_y,
     int local_top = std::max(leftE->fFirstY, riteE->fFirstY);
     ASSERT_RETURN(local_top >= start_y);
 
+    SkSpanBatcher spans(blitter);
+
     while (local_top < stop_y) {
         SkASSERT(leftE->fFirstY <= stop_y);
         SkASSERT(riteE->fFirstY <= stop_y);
@@ -254,6 +258,7 @@ static void walk_simple_edges(SkEdge* prevHead, SkBlitter* blitter, int start_y,
             }
             if (L < R) {
                 count += 1;
+                spans.flush();
                 blitter->blitRect(L, local_top, R - L, count);
             }
             local_top = local_bot + 1;
@@ -265,7 +270,7 @@ static void walk_simple_edges(SkEdge* prevHead, SkBlitter* blitter, int start_y,
                     std::swap(L, R);
                 }
                 if (L < R) {
-                    blitter->blitH(L, local_top, R - L);
+                    spans.add(L, local_top, R - L);
                 }
                 // Either/both of these might overflow, since we perform this step even if
                 // (later) we determine that we are done with the edge, and so the computed
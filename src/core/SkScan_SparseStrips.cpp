@@ -0,0 +1,427 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkPath.h"
+#include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkScan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+#include <vector>
+
+/*
+  Sparse strips scan conversion.
+
+  AAA and supersampling walk a sorted edge list one scanline (or sub-scanline) at a time. Here we
+  instead flatten the path into lines and, for each line, add the exact signed area it covers in
+  every pixel it crosses to a float accumulation buffer. A running sum along each row then gives
+  the winding number of every pixel, with fractional values along the edges, and the coverage is
+  |winding| clamped to 1 (nonzero) or folded into [0,1] (even-odd). Since the areas are exact,
+  coverage is correct for any number of overlapping edges in a pixel, and the cost depends only on
+  the number of pixels the lines cross rather than on how they're ordered.
+
+  The buffer only holds a strip of kStripHeight rows, split into tiles of kTileWidth pixels, and
+  we track which tiles of each row any line touched. The buffer is zero in untouched tiles, so
+  their coverage is just the sum carried in from the left: we emit each span of them as a single
+  run without reading the buffer, and only the touched tiles need their prefix sum resolved and
+  their accumulators cleared afterward. That keeps large solid interiors, and the empty space
+  around a path, cheap no matter how big the path is.
+*/
+
+namespace {
+
+constexpr int kStripHeight = 4;
+constexpr int kTileWidth   = 16;
+
+// Curves are flattened to lines no further than this from the curve, in pixels.
+constexpr float kFlattenTolerance = 1 / 16.0f;
+constexpr int   kMaxFlattenSegments = 1 << 10;
+
+// A line spanning fTop < y < fBottom, where x = fX0 + (y - fY0) * fDxDy relative to the left of
+// the fill. Lines keep the extent and slope they had in the path, clipped only where they leave
+// the fill to the left or right, so the coverage of each row never depends on which other rows
+// we fill. That's what lets callers fill a path in independent horizontal bands.
+struct Line {
+    float fTop, fBottom;
+    float fX0, fY0, fDxDy;
+    float fDir;         // +1 if the path went down along this line, -1 if it went up.
+};
+
+class SparseStripsFiller {
+public:
+    // Fills rows [top, bottom) and columns [left, left + width) of the device.
+    SparseStripsFiller(int left, int top, int right, int bottom)
+        : fLeft(left)
+        , fTop(top)
+        , fBottom(bottom)
+        , fWidth(right - left)
+        , fTilesPerRow((fWidth + 1) / kTileWidth + 1)  // Room for lines at x == fWidth.
+        , fStride(fTilesPerRow * kTileWidth)
+        , fAccum(kStripHeight * fStride)
+        , fTouched(kStripHeight * fTilesPerRow)
+        , fAlpha(fWidth + 1)
+        , fRuns(fWidth + 1) {
+        memset(fAccum.get(), 0, kStripHeight * fStride * sizeof(float));
+        memset(fTouched.get(), 0, kStripHeight * fTilesPerRow);
+    }
+
+    void addPath(const SkPath& path);
+    void fill(SkBlitter* blitter, SkPathFillType fillType);
+
+private:
+    void addLine(SkPoint p0, SkPoint p1);
+    void addQuad(const SkPoint pts[3]);
+    void addCubic(const SkPoint pts[4]);
+    bool cullCurve(const SkPoint pts[], int count);
+    void accumulate(const Line& line, int stripTop, int stripBottom);
+    void resolveRow(SkBlitter* blitter, int y, int row, SkPathFillType fillType);
+
+    const int fLeft, fTop, fBottom, fWidth;
+    const int fTilesPerRow, fStride;
+
+    std::vector<Line>       fLines;
+    SkAutoTMalloc<float>    fAccum;
+    SkAutoTMalloc<uint8_t>  fTouched;
+    SkAutoTMalloc<SkAlpha>  fAlpha;
+    SkAutoTMalloc<int16_t>  fRuns;
+};
+
+void SparseStripsFiller::addPath(const SkPath& path) {
+    SkAutoConicToQuads quadder;
+    SkPathEdgeIter iter(path);
+    while (auto e = iter.next()) {
+        switch (e.fEdge) {
+            case SkPathEdgeIter::Edge::kLine:
+                this->addLine(e.fPts[0], e.fPts[1]);
+                break;
+            case SkPathEdgeIter::Edge::kQuad:
+                this->addQuad(e.fPts);
+                break;
+            case SkPathEdgeIter::Edge::kConic: {
+                const SkPoint* quadPts = quadder.computeQuads(e.fPts, iter.conicWeight(),
+                                                              kFlattenTolerance);
+                for (int i = 0; i < quadder.countQuads(); i++) {
+                    this->addQuad(quadPts);
+                    quadPts += 2;
+                }
+            } break;
+            case SkPathEdgeIter::Edge::kCubic:
+                this->addCubic(e.fPts);
+                break;
+        }
+    }
+}
+
+// Curves entirely above, below, or right of the fill contribute nothing, and ones entirely left
+// of it only contribute their winding, which a line between their end points carries just as well.
+// Either way there's no need to flatten them.
+bool SparseStripsFiller::cullCurve(const SkPoint pts[], int count) {
+    SkRect bounds;
+    bounds.setBounds(pts, count);
+    if (bounds.fBottom <= fTop || bounds.fTop >= fBottom || bounds.fLeft >= fLeft + fWidth) {
+        return true;
+    }
+    if (bounds.fRight <= fLeft) {
+        this->addLine(pts[0], pts[count - 1]);
+        return true;
+    }
+    return false;
+}
+
+void SparseStripsFiller::addQuad(const SkPoint pts[3]) {
+    if (this->cullCurve(pts, 3)) {
+        return;
+    }
+    // A quad is within tol of n lines when |p0 - 2p1 + p2| / (4n^2) <= tol.
+    float dd = (pts[0] - pts[1] - pts[1] + pts[2]).length();
+    int n = SkTPin((int)std::ceil(std::sqrt(dd / (4 * kFlattenTolerance))),
+                   1, kMaxFlattenSegments);
+    SkPoint prev = pts[0];
+    for (int i = 1; i < n; i++) {
+        SkPoint next = SkEvalQuadAt(pts, (float)i / n);
+        this->addLine(prev, next);
+        prev = next;
+    }
+    this->addLine(prev, pts[2]);
+}
+
+void SparseStripsFiller::addCubic(const SkPoint pts[4]) {
+    if (this->cullCurve(pts, 4)) {
+        return;
+    }
+    // A cubic is within tol of n lines when 3*max|second differences| / (4n^2) <= tol.
+    float dd = std::max((pts[0] - pts[1] - pts[1] + pts[2]).length(),
+                        (pts[1] - pts[2] - pts[2] + pts[3]).length());
+    int n = SkTPin((int)std::ceil(std::sqrt(3 * dd / (4 * kFlattenTolerance))),
+                   1, kMaxFlattenSegments);
+    SkPoint prev = pts[0];
+    for (int i = 1; i < n; i++) {
+        SkPoint next;
+        SkEvalCubicAt(pts, (float)i / n, &next, nullptr, nullptr);
+        this->addLine(prev, next);
+        prev = next;
+    }
+    this->addLine(prev, pts[3]);
+}
+
+void SparseStripsFiller::addLine(SkPoint p0, SkPoint p1) {
+    if (p0.fY == p1.fY) {
+        return;
+    }
+    float dir = 1;
+    if (p0.fY > p1.fY) {
+        std::swap(p0, p1);
+        dir = -1;
+    }
+    if (p1.fY <= fTop || p0.fY >= fBottom) {
+        return;
+    }
+    p0.fX -= fLeft;
+    p1.fX -= fLeft;
+
+    const float w = (float)fWidth;
+    if (p0.fX >= w && p1.fX >= w) {
+        return;
+    }
+    const float dxdy = (p1.fX - p0.fX) / (p1.fY - p0.fY);
+    auto xAtY = [&](float y) { return p0.fX + (y - p0.fY) * dxdy; };
+
+    // Split the line where it crosses x = 0 and x = w. Pieces right of w can't affect the pixels
+    // we fill, and pieces left of 0 only matter for their winding, so they become vertical lines
+    // at x = 0.
+    float ys[4] = { p0.fY, p1.fY, p1.fY, p1.fY };
+    int n = 1;
+    for (float edge : {0.0f, w}) {
+        if ((p0.fX < edge) != (p1.fX < edge)) {
+            float y = p0.fY + (edge - p0.fX) * (p1.fY - p0.fY) / (p1.fX - p0.fX);
+            ys[n++] = SkTPin(y, p0.fY, p1.fY);
+        }
+    }
+    ys[n] = p1.fY;
+    std::sort(ys + 1, ys + n);
+
+    for (int i = 0; i < n; i++) {
+        const float ya = ys[i],
+                    yb = ys[i + 1];
+        if (ya >= yb) {
+            continue;
+        }
+        const float xm = xAtY(0.5f * (ya + yb));
+        if (xm >= w) {
+            continue;
+        }
+        if (xm <= 0) {
+            fLines.push_back({ya, yb, 0, 0, 0, dir});
+        } else {
+            fLines.push_back({ya, yb, p0.fX, p0.fY, dxdy, dir});
+        }
+    }
+}
+
+// Adds the signed area line covers in each pixel of rows [stripTop, stripBottom). The area a
+// line covers in a row is split between the pixels it crosses and the pixel just right of it,
+// so that the running sum along the row reaches the line's full height right after it.
+void SparseStripsFiller::accumulate(const Line& line, int stripTop, int stripBottom) {
+    const float w = (float)fWidth;
+    auto xAtY = [&](float y) { return SkTPin(line.fX0 + (y - line.fY0) * line.fDxDy, 0.0f, w); };
+
+    const int yStart = (int)std::floor(std::max(line.fTop,    (float)stripTop)),
+              yEnd   = (int)std::ceil (std::min(line.fBottom, (float)stripBottom));
+    for (int y = yStart; y < yEnd; y++) {
+        const float ya = std::max((float)y, line.fTop),
+                    yb = std::min((float)(y + 1), line.fBottom);
+        if (ya >= yb) {
+            continue;
+        }
+        const float xa = xAtY(ya),
+                    xb = xAtY(yb);
+        const float d = (yb - ya) * line.fDir;
+
+        float*   acc     = fAccum.get()   + (y - stripTop) * fStride;
+        uint8_t* touched = fTouched.get() + (y - stripTop) * fTilesPerRow;
+
+        const float x0 = std::min(xa, xb),
+                    x1 = std::max(xa, xb);
+        const float x0floor = std::floor(x0),
+                    x1ceil  = std::ceil (x1);
+        const int x0i = (int)x0floor,
+                  x1i = (int)x1ceil;
+        int last;
+        if (x1i <= x0i + 1) {
+            // The line stays within one pixel in this row.
+            const float xm = 0.5f * (xa + xb) - x0floor;
+            acc[x0i    ] += d - d * xm;
+            acc[x0i + 1] += d * xm;
+            last = x0i + 1;
+        } else {
+            // The area under the line grows quadratically across the first and last pixels it
+            // crosses, and linearly across the ones in between.
+            const float s   = 1 / (x1 - x0),
+                        x0f = x0 - x0floor,
+                        x1f = x1 - x1ceil + 1,
+                        a0  = 0.5f * s * (1 - x0f) * (1 - x0f),
+                        am  = 0.5f * s * x1f * x1f;
+            acc[x0i] += d * a0;
+            if (x1i == x0i + 2) {
+                acc[x0i + 1] += d * (1 - a0 - am);
+            } else {
+                const float a1 = s * (1.5f - x0f);
+                acc[x0i + 1] += d * (a1 - a0);
+                for (int x = x0i + 2; x < x1i - 1; x++) {
+                    acc[x] += d * s;
+                }
+                const float a2 = a1 + (float)(x1i - x0i - 3) * s;
+                acc[x1i - 1] += d * (1 - a2 - am);
+            }
+            acc[x1i] += d * am;
+            last = x1i;
+        }
+        for (int t = x0i / kTileWidth; t <= last / kTileWidth; t++) {
+            touched[t] = 1;
+        }
+    }
+}
+
+template <int N>
+static skvx::Vec<N,uint8_t> to_alpha(skvx::Vec<N,float> winding, SkPathFillType fillType) {
+    using F = skvx::Vec<N,float>;
+    F w = skvx::max(winding, -winding);
+    F coverage = SkPathFillType_IsEvenOdd(fillType)
+               ? skvx::abs(w - 2.0f * skvx::floor(0.5f * w + 0.5f))
+               : skvx::min(w, 1.0f);
+    if (SkPathFillType_IsInverse(fillType)) {
+        coverage = 1.0f - coverage;
+    }
+    return skvx::cast<uint8_t>(coverage * 255.0f + 0.5f);
+}
+
+void SparseStripsFiller::resolveRow(SkBlitter* blitter, int y, int row, SkPathFillType fillType) {
+    using F4 = skvx::Vec<4,float>;
+
+    float*   acc     = fAccum.get()   + row * fStride;
+    uint8_t* touched = fTouched.get() + row * fTilesPerRow;
+    SkAlpha* alpha   = fAlpha.get();
+    int16_t* runs    = fRuns.get();
+
+    float carry = 0;
+    int   solidStart = -1;      // Start of the run of untouched tiles we're extending, if any.
+    bool  anyCoverage = false;
+    for (int x = 0; x < fWidth; x += kTileWidth) {
+        const int t = x / kTileWidth,
+                  n = std::min(kTileWidth, fWidth - x);
+        if (!touched[t]) {
+            SkAlpha a = to_alpha<1>(carry, fillType)[0];
+            if (solidStart >= 0 && alpha[solidStart] == a) {
+                runs[solidStart] += n;
+            } else {
+                solidStart = x;
+                alpha[x] = a;
+                runs[x] = n;
+            }
+            anyCoverage |= a != 0;
+            continue;
+        }
+        solidStart = -1;
+
+        // Prefix sum the tile four floats at a time, shifting each vector in on itself.
+        float sums[kTileWidth];
+        for (int i = 0; i < kTileWidth; i += 4) {
+            F4 v = F4::Load(acc + x + i);
+            v += skvx::shuffle<0,0,1,2>(v) * F4{0, 1, 1, 1};
+            v += skvx::shuffle<0,0,0,1>(v) * F4{0, 0, 1, 1};
+            v += carry;
+            v.store(sums + i);
+            carry = v[3];
+        }
+        uint8_t alphas[kTileWidth];
+        for (int i = 0; i < kTileWidth; i += 8) {
+            to_alpha<8>(skvx::Vec<8,float>::Load(sums + i), fillType).store(alphas + i);
+        }
+        for (int i = 0; i < n; i++) {
+            alpha[x + i] = alphas[i];
+            runs [x + i] = 1;
+            anyCoverage |= alphas[i] != 0;
+        }
+
+        memset(acc + x, 0, kTileWidth * sizeof(float));
+        touched[t] = 0;
+    }
+    // Lines at x == fWidth may land in a spare tile past the end of the row.
+    for (int t = (fWidth + kTileWidth - 1) / kTileWidth; t < fTilesPerRow; t++) {
+        if (touched[t]) {
+            memset(acc + t * kTileWidth, 0, kTileWidth * sizeof(float));
+            touched[t] = 0;
+        }
+    }
+
+    if (!anyCoverage) {
+        return;
+    }
+    if (runs[0] == fWidth && alpha[0] == 0xFF) {
+        blitter->blitH(fLeft, y, fWidth);
+        return;
+    }
+    runs[fWidth] = 0;
+    blitter->blitAntiH(fLeft, y, alpha, runs);
+}
+
+void SparseStripsFiller::fill(SkBlitter* blitter, SkPathFillType fillType) {
+    // A stable sort keeps the order we add up overlapping lines in, and so the exact coverage,
+    // the same however many rows we fill.
+    std::stable_sort(fLines.begin(), fLines.end(), [](const Line& a, const Line& b) {
+        return a.fTop < b.fTop;
+    });
+
+    std::vector<const Line*> active;
+    size_t next = 0;
+    for (int stripTop = fTop; stripTop < fBottom; stripTop += kStripHeight) {
+        const int stripBottom = std::min(stripTop + kStripHeight, fBottom);
+
+        active.erase(std::remove_if(active.begin(), active.end(), [=](const Line* line) {
+            return line->fBottom <= stripTop;
+        }), active.end());
+        while (next < fLines.size() && fLines[next].fTop < stripBottom) {
+            active.push_back(&fLines[next++]);
+        }
+
+        for (const Line* line : active) {
+            this->accumulate(*line, stripTop, stripBottom);
+        }
+        for (int y = stripTop; y < stripBottom; y++) {
+            this->resolveRow(blitter, y, y - stripTop, fillType);
+        }
+    }
+}
+
+}  // namespace
+
+void SkScan::SparseStripsFillPath(const SkPath&  path,
+                                  SkBlitter*     blitter,
+                                  const SkIRect& ir,
+                                  const SkIRect& clipBounds) {
+    // Our caller blits the rows above and below ir for inverse fills, but within those rows we
+    // have to fill the whole width of the clip.
+    SkIRect bounds;
+    if (path.isInverseFillType()) {
+        bounds = clipBounds;
+        if (!bounds.intersect({clipBounds.fLeft, ir.fTop, clipBounds.fRight, ir.fBottom})) {
+            return;
+        }
+    } else if (!bounds.intersect(ir, clipBounds)) {
+        return;
+    }
+
+    SparseStripsFiller filler(bounds.fLeft, bounds.fTop, bounds.fRight, bounds.fBottom);
+    filler.addPath(path);
+    filler.fill(blitter, path.getFillType());
+}
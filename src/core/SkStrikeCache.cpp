@@ -34,10 +34,14 @@ SkStrikeCache* SkStrikeCache::GlobalStrikeCache() {
 }
 
 auto SkStrikeCache::findOrCreateStrike(const SkStrikeSpec& strikeSpec) -> sk_sp<SkStrike> {
-    SkAutoMutexExclusive ac(fLock);
-    sk_sp<SkStrike> strike = this->internalFindStrikeOrNull(strikeSpec.descriptor());
-    if (strike == nullptr) {
-        strike = this->internalCreateStrike(strikeSpec);
+    sk_sp<SkStrike> strike;
+    {
+        Shard& shard = this->shardFor(strikeSpec.descriptor());
+        SkAutoMutexExclusive ac(shard.fLock);
+        strike = shard.findStrikeOrNull(strikeSpec.descriptor());
+        if (strike == nullptr) {
+            strike = this->internalCreateStrike(shard, strikeSpec);
+        }
     }
     this->internalPurge();
     return strike;
@@ -117,13 +121,17 @@ void SkStrikeCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 }
 
 sk_sp<SkStrike> SkStrikeCache::findStrike(const SkDescriptor& desc) {
-    SkAutoMutexExclusive ac(fLock);
-    sk_sp<SkStrike> result = this->internalFindStrikeOrNull(desc);
+    sk_sp<SkStrike> result;
+    {
+        Shard& shard = this->shardFor(desc);
+        SkAutoMutexExclusive ac(shard.fLock);
+        result = shard.findStrikeOrNull(desc);
+    }
     this->internalPurge();
     return result;
 }
 
-auto SkStrikeCache::internalFindStrikeOrNull(const SkDescriptor& desc) -> sk_sp<SkStrike> {
+auto SkStrikeCache::Shard::findStrikeOrNull(const SkDescriptor& desc) -> sk_sp<SkStrike> {
 
     // Check head because it is likely the strike we are looking for.
     if (fHead != nullptr && fHead->getDescriptor() == desc) { return sk_ref_sp(fHead); }
@@ -153,53 +161,49 @@ sk_sp<SkStrike> SkStrikeCache::createStrike(
         const SkStrikeSpec& strikeSpec,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) {
-    SkAutoMutexExclusive ac(fLock);
-    return this->internalCreateStrike(strikeSpec, maybeMetrics, std::move(pinner));
+    Shard& shard = this->shardFor(strikeSpec.descriptor());
+    SkAutoMutexExclusive ac(shard.fLock);
+    return this->internalCreateStrike(shard, strikeSpec, maybeMetrics, std::move(pinner));
 }
 
 auto SkStrikeCache::internalCreateStrike(
+        Shard& shard,
         const SkStrikeSpec& strikeSpec,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) -> sk_sp<SkStrike> {
     std::unique_ptr<SkScalerContext> scaler = strikeSpec.createScalerContext();
     auto strike =
         sk_make_sp<SkStrike>(this, strikeSpec, std::move(scaler), maybeMetrics, std::move(pinner));
-    this->internalAttachToHead(strike);
+    shard.attachToHead(strike);
+    fCacheCount.fetch_add(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_add(strike->fMemoryUsed, std::memory_order_relaxed);
     return strike;
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoMutexExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->internalPurge(fTotalMemoryUsed.load(std::memory_order_relaxed));
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fTotalMemoryUsed;
+    return fTotalMemoryUsed.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheCount;
+    return fCacheCount.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheCountLimit;
+    return fCacheCountLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
-    SkAutoMutexExclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit, std::memory_order_relaxed);
     this->internalPurge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheSizeLimit;
+    return fCacheSizeLimit.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::setCacheCountLimit(int newCount) {
@@ -207,85 +211,129 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoMutexExclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
+    int prevCount = fCacheCountLimit.exchange(newCount, std::memory_order_relaxed);
     this->internalPurge();
     return prevCount;
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
-    SkAutoMutexExclusive ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoMutexExclusive ac(shard.fLock);
 
-    this->validate();
+        shard.validate();
 
-    for (SkStrike* strike = fHead; strike != nullptr; strike = strike->fNext) {
-        visitor(*strike);
+        for (SkStrike* strike = shard.fHead; strike != nullptr; strike = strike->fNext) {
+            visitor(*strike);
+        }
     }
 }
 
 size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
-    size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
-    }
-    bytesNeeded = std::max(bytesNeeded, minBytesNeeded);
-    if (bytesNeeded) {
-        // no small purges!
-        bytesNeeded = std::max(bytesNeeded, fTotalMemoryUsed >> 2);
-    }
+    // This runs after every lookup, so check the budgets without taking any locks first.
+    auto needs = [&](size_t* bytesNeeded, int* countNeeded) {
+        const size_t totalMemoryUsed = fTotalMemoryUsed.load(std::memory_order_relaxed),
+                     cacheSizeLimit  = fCacheSizeLimit .load(std::memory_order_relaxed);
+        const int    cacheCount      = fCacheCount     .load(std::memory_order_relaxed),
+                     cacheCountLimit = fCacheCountLimit.load(std::memory_order_relaxed);
+
+        *bytesNeeded = 0;
+        if (totalMemoryUsed > cacheSizeLimit) {
+            *bytesNeeded = totalMemoryUsed - cacheSizeLimit;
+        }
+        *bytesNeeded = std::max(*bytesNeeded, minBytesNeeded);
+        if (*bytesNeeded) {
+            // no small purges!
+            *bytesNeeded = std::max(*bytesNeeded, totalMemoryUsed >> 2);
+        }
 
-    int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
-        // no small purges!
-        countNeeded = std::max(countNeeded, fCacheCount >> 2);
-    }
+        *countNeeded = 0;
+        if (cacheCount > cacheCountLimit) {
+            *countNeeded = cacheCount - cacheCountLimit;
+            // no small purges!
+            *countNeeded = std::max(*countNeeded, cacheCount >> 2);
+        }
+        return *bytesNeeded || *countNeeded;
+    };
 
+    size_t bytesNeeded;
+    int    countNeeded;
     // early exit
-    if (!countNeeded && !bytesNeeded) {
+    if (!needs(&bytesNeeded, &countNeeded)) {
+        return 0;
+    }
+
+    SkAutoMutexExclusive purgeLock(fPurgeLock);
+    // Another thread may have purged while we waited for the lock.
+    if (!needs(&bytesNeeded, &countNeeded)) {
         return 0;
     }
 
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
+    // Each shard is in LRU order, with unimportant entries at the tail. We approximate a global
+    // LRU by taking an even slice from the tail of every shard, and repeat until we've freed
+    // enough or only pinned strikes are left.
+    bool freedAny = true;
+    while (freedAny && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
+        freedAny = false;
+        const size_t bytesSlice = bytesFreed < bytesNeeded
+                                ? (bytesNeeded - bytesFreed + kShardCount - 1) / kShardCount : 0;
+        const int    countSlice = countFreed < countNeeded
+                                ? (countNeeded - countFreed + kShardCount - 1) / kShardCount : 0;
+        for (Shard& shard : fShards) {
+            size_t shardBytesFreed = 0;
+            int    shardCountFreed = 0;
+            {
+                SkAutoMutexExclusive ac(shard.fLock);
+                shard.purge(bytesSlice, countSlice, &shardBytesFreed, &shardCountFreed);
+            }
+            fTotalMemoryUsed.fetch_sub(shardBytesFreed, std::memory_order_relaxed);
+            fCacheCount.fetch_sub(shardCountFreed, std::memory_order_relaxed);
+            bytesFreed += shardBytesFreed;
+            countFreed += shardCountFreed;
+            freedAny |= shardCountFreed > 0;
+        }
+    }
+
+#ifdef SPEW_PURGE_STATUS
+    if (countFreed) {
+        SkDebugf("purging %dK from font cache [%d entries]\n",
+                 (int)(bytesFreed >> 10), countFreed);
+    }
+#endif
+
+    return bytesFreed;
+}
+
+void SkStrikeCache::Shard::purge(size_t bytesNeeded, int countNeeded,
+                                 size_t* bytesFreed, int* countFreed) {
     // Start at the tail and proceed backwards deleting; the list is in LRU
     // order, with unimportant entries at the tail.
     SkStrike* strike = fTail;
-    while (strike != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
+    while (strike != nullptr && (*bytesFreed < bytesNeeded || *countFreed < countNeeded)) {
         SkStrike* prev = strike->fPrev;
 
         // Only delete if the strike is not pinned.
         if (strike->fPinner == nullptr || strike->fPinner->canDelete()) {
-            bytesFreed += strike->fMemoryUsed;
-            countFreed += 1;
-            this->internalRemoveStrike(strike);
+            *bytesFreed += strike->fMemoryUsed;
+            *countFreed += 1;
+            this->removeStrike(strike);
         }
         strike = prev;
     }
 
     this->validate();
-
-#ifdef SPEW_PURGE_STATUS
-    if (countFreed) {
-        SkDebugf("purging %dK from font cache [%d entries]\n",
-                 (int)(bytesFreed >> 10), countFreed);
-    }
-#endif
-
-    return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(sk_sp<SkStrike> strike) {
+void SkStrikeCache::Shard::attachToHead(sk_sp<SkStrike> strike) {
     SkASSERT(fStrikeLookup.find(strike->getDescriptor()) == nullptr);
     SkStrike* strikePtr = strike.get();
     fStrikeLookup.set(std::move(strike));
     SkASSERT(nullptr == strikePtr->fPrev && nullptr == strikePtr->fNext);
 
-    fCacheCount += 1;
-    fTotalMemoryUsed += strikePtr->fMemoryUsed;
+    fCount += 1;
+    fMemoryUsed += strikePtr->fMemoryUsed;
 
     if (fHead != nullptr) {
         fHead->fPrev = strikePtr;
@@ -299,10 +347,10 @@ void SkStrikeCache::internalAttachToHead(sk_sp<SkStrike> strike) {
     fHead = strikePtr; // Transfer ownership of strike to the cache list.
 }
 
-void SkStrikeCache::internalRemoveStrike(SkStrike* strike) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fTotalMemoryUsed -= strike->fMemoryUsed;
+void SkStrikeCache::Shard::removeStrike(SkStrike* strike) {
+    SkASSERT(fCount > 0);
+    fCount -= 1;
+    fMemoryUsed -= strike->fMemoryUsed;
 
     if (strike->fPrev) {
         strike->fPrev->fNext = strike->fNext;
@@ -320,7 +368,7 @@ void SkStrikeCache::internalRemoveStrike(SkStrike* strike) {
     fStrikeLookup.remove(strike->getDescriptor());
 }
 
-void SkStrikeCache::validate() const {
+void SkStrikeCache::Shard::validate() const {
 #ifdef SK_DEBUG
     size_t computedBytes = 0;
     int computedCount = 0;
@@ -333,13 +381,13 @@ void SkStrikeCache::validate() const {
         strike = strike->fNext;
     }
 
-    if (fCacheCount != computedCount) {
-        SkDebugf("fCacheCount: %d, computedCount: %d", fCacheCount, computedCount);
-        SK_ABORT("fCacheCount != computedCount");
+    if (fCount != computedCount) {
+        SkDebugf("fCount: %d, computedCount: %d", fCount, computedCount);
+        SK_ABORT("fCount != computedCount");
     }
-    if (fTotalMemoryUsed != computedBytes) {
-        SkDebugf("fTotalMemoryUsed: %zu, computedBytes: %zu", fTotalMemoryUsed, computedBytes);
-        SK_ABORT("fTotalMemoryUsed == computedBytes");
+    if (fMemoryUsed != computedBytes) {
+        SkDebugf("fMemoryUsed: %zu, computedBytes: %zu", fMemoryUsed, computedBytes);
+        SK_ABORT("fMemoryUsed == computedBytes");
     }
 #endif
 }
@@ -352,10 +400,12 @@ void SkStrikeCache::validate() const {
 
 void SkStrike::updateDelta(size_t increase) {
     if (increase != 0) {
-        SkAutoMutexExclusive lock{fStrikeCache->fLock};
+        SkStrikeCache::Shard& shard = fStrikeCache->shardFor(this->getDescriptor());
+        SkAutoMutexExclusive lock{shard.fLock};
         fMemoryUsed += increase;
         if (!fRemoved) {
-            fStrikeCache->fTotalMemoryUsed += increase;
+            shard.fMemoryUsed += increase;
+            fStrikeCache->fTotalMemoryUsed.fetch_add(increase, std::memory_order_relaxed);
         }
     }
 }
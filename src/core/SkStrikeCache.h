@@ -8,6 +8,7 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -171,6 +172,7 @@ public:
 
     const SkStrikeSpec              fStrikeSpec;
     SkStrikeCache* const            fStrikeCache;
+    // fNext, fPrev, fMemoryUsed and fRemoved are guarded by the lock of the strike's shard.
     SkStrike*                       fNext{nullptr};
     SkStrike*                       fPrev{nullptr};
     SkScalerCache                   fScalerCache;
@@ -179,23 +181,25 @@ public:
     bool                            fRemoved{false};
 };  // SkStrike
 
+// Strikes are spread over independently locked shards by the hash of their descriptor, so
+// threads looking up different strikes rarely contend. Each shard keeps its own LRU list; the
+// byte and count budgets apply to the whole cache and are tracked with atomics.
 class SkStrikeCache final : public SkStrikeForGPUCacheInterface {
 public:
     SkStrikeCache() = default;
 
     static SkStrikeCache* GlobalStrikeCache();
 
-    sk_sp<SkStrike> findStrike(const SkDescriptor& desc) SK_EXCLUDES(fLock);
+    sk_sp<SkStrike> findStrike(const SkDescriptor& desc);
 
     sk_sp<SkStrike> createStrike(
             const SkStrikeSpec& strikeSpec,
             SkFontMetrics* maybeMetrics = nullptr,
-            std::unique_ptr<SkStrikePinner> = nullptr) SK_EXCLUDES(fLock);
+            std::unique_ptr<SkStrikePinner> = nullptr);
 
-    sk_sp<SkStrike> findOrCreateStrike(const SkStrikeSpec& strikeSpec) SK_EXCLUDES(fLock);
+    sk_sp<SkStrike> findOrCreateStrike(const SkStrikeSpec& strikeSpec);
 
-    SkScopedStrikeForGPU findOrCreateScopedStrike(
-            const SkStrikeSpec& strikeSpec) override SK_EXCLUDES(fLock);
+    SkScopedStrikeForGPU findOrCreateScopedStrike(const SkStrikeSpec& strikeSpec) override;
 
     static void PurgeAll();
     static void Dump();
@@ -204,55 +208,83 @@ public:
     // SkTraceMemoryDump interface.
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
-    void purgeAll() SK_EXCLUDES(fLock); // does not change budget
+    void purgeAll(); // does not change budget
 
-    int getCacheCountLimit() const SK_EXCLUDES(fLock);
-    int setCacheCountLimit(int limit) SK_EXCLUDES(fLock);
-    int getCacheCountUsed() const SK_EXCLUDES(fLock);
+    int getCacheCountLimit() const;
+    int setCacheCountLimit(int limit);
+    int getCacheCountUsed() const;
 
-    size_t getCacheSizeLimit() const SK_EXCLUDES(fLock);
-    size_t setCacheSizeLimit(size_t limit) SK_EXCLUDES(fLock);
-    size_t getTotalMemoryUsed() const SK_EXCLUDES(fLock);
+    size_t getCacheSizeLimit() const;
+    size_t setCacheSizeLimit(size_t limit);
+    size_t getTotalMemoryUsed() const;
 
 private:
     friend class SkStrike;  // for SkStrike::updateDelta
-    sk_sp<SkStrike> internalFindStrikeOrNull(const SkDescriptor& desc) SK_REQUIRES(fLock);
+
+    static constexpr int kShardBits  = 4;
+    static constexpr int kShardCount = 1 << kShardBits;
+
+    struct Shard {
+        sk_sp<SkStrike> findStrikeOrNull(const SkDescriptor& desc) SK_REQUIRES(fLock);
+
+        // The following methods can only be called when the shard's mutex is already held.
+        void attachToHead(sk_sp<SkStrike> strike) SK_REQUIRES(fLock);
+        void removeStrike(SkStrike* strike) SK_REQUIRES(fLock);
+
+        // Remove unpinned strikes from the tail of this shard's LRU list until at least
+        // bytesNeeded bytes and countNeeded strikes have been freed, or we run out.
+        void purge(size_t bytesNeeded, int countNeeded,
+                   size_t* bytesFreed, int* countFreed) SK_REQUIRES(fLock);
+
+        // A simple accounting of what each glyph cache reports and the shard total.
+        void validate() const SK_REQUIRES(fLock);
+
+        mutable SkMutex fLock;
+        SkStrike* fHead SK_GUARDED_BY(fLock) {nullptr};
+        SkStrike* fTail SK_GUARDED_BY(fLock) {nullptr};
+        struct StrikeTraits {
+            static const SkDescriptor& GetKey(const sk_sp<SkStrike>& strike) {
+                return strike->getDescriptor();
+            }
+            static uint32_t Hash(const SkDescriptor& descriptor) {
+                return descriptor.getChecksum();
+            }
+        };
+        SkTHashTable<sk_sp<SkStrike>, SkDescriptor, StrikeTraits> fStrikeLookup
+                SK_GUARDED_BY(fLock);
+
+        size_t  fMemoryUsed SK_GUARDED_BY(fLock) {0};
+        int32_t fCount      SK_GUARDED_BY(fLock) {0};
+    };
+
+    Shard& shardFor(const SkDescriptor& desc) {
+        // SkTHashTable indexes with the low bits of the checksum, so pick shards with the top.
+        return fShards[desc.getChecksum() >> (32 - kShardBits)];
+    }
+
     sk_sp<SkStrike> internalCreateStrike(
+            Shard& shard,
             const SkStrikeSpec& strikeSpec,
             SkFontMetrics* maybeMetrics = nullptr,
-            std::unique_ptr<SkStrikePinner> = nullptr) SK_REQUIRES(fLock);
-
-    // The following methods can only be called when mutex is already held.
-    void internalRemoveStrike(SkStrike* strike) SK_REQUIRES(fLock);
-    void internalAttachToHead(sk_sp<SkStrike> strike) SK_REQUIRES(fLock);
+            std::unique_ptr<SkStrikePinner> = nullptr) SK_REQUIRES(shard.fLock);
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
     // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0) SK_REQUIRES(fLock);
-
-    // A simple accounting of what each glyph cache reports and the strike cache total.
-    void validate() const SK_REQUIRES(fLock);
-
-    void forEachStrike(std::function<void(const SkStrike&)> visitor) const SK_EXCLUDES(fLock);
-
-    mutable SkMutex fLock;
-    SkStrike* fHead SK_GUARDED_BY(fLock) {nullptr};
-    SkStrike* fTail SK_GUARDED_BY(fLock) {nullptr};
-    struct StrikeTraits {
-        static const SkDescriptor& GetKey(const sk_sp<SkStrike>& strike) {
-            return strike->getDescriptor();
-        }
-        static uint32_t Hash(const SkDescriptor& descriptor) {
-            return descriptor.getChecksum();
-        }
-    };
-    SkTHashTable<sk_sp<SkStrike>, SkDescriptor, StrikeTraits> fStrikeLookup SK_GUARDED_BY(fLock);
+    // Must not be called with any shard's mutex held.
+    size_t internalPurge(size_t minBytesNeeded = 0);
+
+    void forEachStrike(std::function<void(const SkStrike&)> visitor) const;
+
+    Shard fShards[kShardCount];
+
+    // Only one thread purges at a time. Lock order is fPurgeLock, then a single shard's fLock.
+    SkMutex fPurgeLock;
 
-    size_t  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    size_t  fTotalMemoryUsed SK_GUARDED_BY(fLock) {0};
-    int32_t fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t fCacheCount SK_GUARDED_BY(fLock) {0};
+    std::atomic<size_t>  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<size_t>  fTotalMemoryUsed{0};
+    std::atomic<int32_t> fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+    std::atomic<int32_t> fCacheCount{0};
 };
 
 #endif  // SkStrikeCache_DEFINED
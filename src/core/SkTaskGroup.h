@@ -11,8 +11,11 @@
 #include "include/core/SkExecutor.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkNoncopyable.h"
+#include <algorithm>
 #include <atomic>
 #include <functional>
+#include <type_traits>
+#include <vector>
 
 class SkTaskGroup : SkNoncopyable {
 public:
@@ -26,6 +29,21 @@ public:
     // Add a batch of N tasks, all calling fn with different arguments.
     void batch(int N, std::function<void(int)> fn);
 
+    // Split [begin, end) into chunks of at most grain indices, and call fn(chunkBegin, chunkEnd)
+    // once per chunk, on this SkTaskGroup's executor and on the calling thread.
+    // fn is shared by all threads, so it must be safe to call concurrently.
+    // If fn returns bool, returning false cancels all chunks that have not yet started.
+    // Blocks until every started chunk has finished, and returns false if any chunk cancelled.
+    // Unlike batch(), this makes a bounded number of std::functions, however large the range.
+    template <typename Fn>
+    bool parallel_for(int begin, int end, int grain, Fn&& fn);
+
+    // Split [begin, end) into chunks as parallel_for() does, compute fn(chunkBegin, chunkEnd)
+    // for each, and fold the per-chunk results into init with join(T, T) in chunk order.
+    // The result is the same no matter how many threads run it.
+    template <typename T, typename Fn, typename Join>
+    T parallel_reduce(int begin, int end, int grain, T init, Fn&& fn, Join&& join);
+
     // Returns true if all Tasks previously add()ed to this SkTaskGroup have run.
     // It is safe to reuse this SkTaskGroup once done().
     bool done() const;
@@ -41,8 +59,77 @@ public:
     };
 
 private:
+    // parallel_for() never adds more helper tasks than this; chunks are handed out dynamically,
+    // so this only needs to exceed the number of threads an executor might have.
+    static constexpr int kMaxHelpers = 64;
+
     std::atomic<int32_t> fPending;
     SkExecutor&          fExecutor;
 };
 
+template <typename Fn>
+bool SkTaskGroup::parallel_for(int begin, int end, int grain, Fn&& fn) {
+    SkASSERT(grain > 0);
+    if (begin >= end) {
+        return true;
+    }
+    const int64_t chunks = ((int64_t)end - begin + grain - 1) / grain;
+
+    std::atomic<int64_t> next{0};
+    std::atomic<bool>    cancelled{false};
+    auto work = [&] {
+        while (!cancelled.load(std::memory_order_relaxed)) {
+            const int64_t chunk = next.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunks) {
+                break;
+            }
+            const int lo = (int)(begin + chunk * grain),
+                      hi = (int)std::min<int64_t>(end, (int64_t)lo + grain);
+            if constexpr (std::is_same<decltype(fn(lo, hi)), bool>::value) {
+                if (!fn(lo, hi)) {
+                    cancelled.store(true, std::memory_order_relaxed);
+                }
+            } else {
+                fn(lo, hi);
+            }
+        }
+    };
+
+    // Helpers only capture a pointer to work, which fits in std::function without allocating.
+    // We use our own SkTaskGroup so we don't wait on unrelated tasks added to this one.
+    SkTaskGroup helpers(fExecutor);
+    auto* workPtr = &work;
+    for (int64_t i = 0; i < std::min<int64_t>(chunks - 1, kMaxHelpers); i++) {
+        helpers.add([workPtr] { (*workPtr)(); });
+    }
+    work();
+    helpers.wait();
+
+    return !cancelled.load(std::memory_order_relaxed);
+}
+
+template <typename T, typename Fn, typename Join>
+T SkTaskGroup::parallel_reduce(int begin, int end, int grain, T init, Fn&& fn, Join&& join) {
+    SkASSERT(grain > 0);
+    if (begin >= end) {
+        return init;
+    }
+    const int chunks = (int)(((int64_t)end - begin + grain - 1) / grain);
+
+    std::vector<T> partials(chunks, init);
+    this->parallel_for(0, chunks, 1, [&](int c0, int c1) {
+        for (int c = c0; c < c1; c++) {
+            const int lo = (int)(begin + (int64_t)c * grain),
+                      hi = (int)std::min<int64_t>(end, (int64_t)lo + grain);
+            partials[c] = fn(lo, hi);
+        }
+    });
+
+    T result = std::move(init);
+    for (T& partial : partials) {
+        result = join(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
 #endif//SkTaskGroup_DEFINED
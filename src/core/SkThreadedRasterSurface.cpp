@@ -0,0 +1,70 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkThreadedRasterSurface.h"
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPicture.h"
+#include "src/core/SkTiledPicturePlayback.h"
+
+#include <algorithm>
+
+std::unique_ptr<SkThreadedRasterSurface> SkThreadedRasterSurface::Make(const SkBitmap& dst,
+                                                                       const Options& options) {
+    if (dst.drawsNothing() || options.fTileSize.isEmpty()) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkThreadedRasterSurface>(new SkThreadedRasterSurface(dst, options));
+}
+
+SkThreadedRasterSurface::SkThreadedRasterSurface(const SkBitmap& dst, const Options& options)
+        : fBitmap(dst)
+        , fProps(options.fProps)
+        , fExecutor(options.fExecutor ? *options.fExecutor : SkExecutor::GetDefault()) {
+    // Grow the tiles if we'd otherwise have more than SkTiledPicturePlayback::kMaxTiles of them.
+    int64_t tileW = options.fTileSize.width(),
+            tileH = options.fTileSize.height();
+    while (((dst.width()  + tileW - 1) / tileW) *
+           ((dst.height() + tileH - 1) / tileH) > SkTiledPicturePlayback::kMaxTiles) {
+        tileW *= 2;
+        tileH *= 2;
+    }
+    for (int64_t y = 0; y < dst.height(); y += tileH) {
+        for (int64_t x = 0; x < dst.width(); x += tileW) {
+            fTiles.push_back(SkIRect::MakeLTRB((int)x, (int)y,
+                                               (int)std::min<int64_t>(x + tileW, dst.width()),
+                                               (int)std::min<int64_t>(y + tileH, dst.height())));
+        }
+    }
+}
+
+SkCanvas* SkThreadedRasterSurface::beginFrame() {
+    SkASSERT(!fRecording);
+    fRecording = true;
+    SkRTreeFactory factory;
+    return fRecorder.beginRecording(SkRect::Make(fBitmap.bounds()), &factory);
+}
+
+void SkThreadedRasterSurface::endFrame() {
+    SkASSERT(fRecording);
+    fRecording = false;
+    sk_sp<SkPicture> frame = fRecorder.finishRecordingAsPicture();
+    this->drawPicture(frame.get());
+}
+
+void SkThreadedRasterSurface::drawPicture(const SkPicture* picture) {
+    if (!picture) {
+        return;
+    }
+
+    SkTiledPicturePlayback::DrawTiles(picture, fBitmap, SkMatrix::I(), SkMakeSpan(fTiles),
+                                      fProps, fExecutor);
+    fBitmap.notifyPixelsChanged();
+}
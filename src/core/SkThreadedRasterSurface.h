@@ -0,0 +1,94 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedRasterSurface_DEFINED
+#define SkThreadedRasterSurface_DEFINED
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkSurfaceProps.h"
+
+#include <memory>
+#include <vector>
+
+class SkCanvas;
+class SkExecutor;
+class SkPicture;
+
+/**
+ *  A raster target that rasterizes each frame on multiple threads.
+ *
+ *  Draws made to the canvas returned by beginFrame() are recorded into an SkPicture backed by an
+ *  SkRTree, which bins them by their device-space bounds. endFrame() splits the target into a grid
+ *  of tiles and replays the picture once per tile on an SkExecutor with
+ *  SkTiledPicturePlayback::DrawTiles(). Every tile draws through its own SkBitmapDevice, whose
+ *  SkRasterClip is restricted to the tile: the R-Tree culls the draws that miss the tile, and each
+ *  tile only writes its own pixels.
+ *
+ *  A saveLayer with a backdrop filter also reads the pixels around the layer, which may belong to
+ *  other tiles that are still being drawn. Frames containing one are replayed on a single thread.
+ *
+ *  Since each tile shares the target's pixels and device coordinates, shaders, images, blending
+ *  and coverage are evaluated as they would be by a single SkBitmapDevice. Where a tile's clip
+ *  cuts a span, anti-aliased edges and legacy shaders may round differently than they would for
+ *  the whole span, so a frame can differ by one per channel along the seams between tiles.
+ */
+class SkThreadedRasterSurface {
+public:
+    struct Options {
+        // Size of the tiles the frame is split into. Smaller tiles balance better across threads
+        // but replay draws that straddle tile boundaries more often. Tiles are grown if needed to
+        // keep to SkTiledPicturePlayback::kMaxTiles.
+        SkISize fTileSize = {256, 256};
+
+        // Executor the tiles run on. If null, SkExecutor::GetDefault() is used.
+        SkExecutor* fExecutor = nullptr;
+
+        SkSurfaceProps fProps;
+    };
+
+    /**
+     *  Returns a surface that draws into the pixels of dst, or nullptr if dst has no pixels or
+     *  the tile size is empty. The pixels must outlive the returned surface.
+     */
+    static std::unique_ptr<SkThreadedRasterSurface> Make(const SkBitmap& dst, const Options&);
+
+    /**
+     *  Begins recording a frame. The returned canvas is owned by the surface and is valid until
+     *  endFrame() is called.
+     */
+    SkCanvas* beginFrame();
+
+    /**
+     *  Stops recording and rasterizes the frame into the target, blocking until every tile has
+     *  been drawn.
+     */
+    void endFrame();
+
+    /**
+     *  Rasterizes an already recorded picture into the target, tile by tile, or all at once if
+     *  the picture has a saveLayer with a backdrop filter.
+     */
+    void drawPicture(const SkPicture*);
+
+    const SkBitmap& bitmap() const { return fBitmap; }
+    int tileCount() const { return (int)fTiles.size(); }
+
+private:
+    SkThreadedRasterSurface(const SkBitmap&, const Options&);
+
+    SkBitmap             fBitmap;
+    SkSurfaceProps       fProps;
+    SkExecutor&          fExecutor;
+    std::vector<SkIRect> fTiles;
+    SkPictureRecorder    fRecorder;
+    bool                 fRecording = false;
+};
+
+#endif
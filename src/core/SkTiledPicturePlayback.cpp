@@ -0,0 +1,149 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkTiledPicturePlayback.h"
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
+#include "include/utils/SkNoDrawCanvas.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Replays a picture without drawing, looking for saveLayers with a backdrop filter. A backdrop
+// reads the device's pixels around the layer, outside the tile a thread is drawing and possibly
+// while another thread is writing them.
+class BackdropFinder final : public SkNoDrawCanvas {
+public:
+    explicit BackdropFinder(const SkIRect& bounds) : SkNoDrawCanvas(bounds) {}
+
+    bool found() const { return fFound; }
+
+protected:
+    SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+        fFound |= rec.fBackdrop != nullptr;
+        return this->SkNoDrawCanvas::getSaveLayerStrategy(rec);
+    }
+
+    void onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
+                       const SkPaint* paint) override {
+        // SkNoDrawCanvas skips nested pictures; we need to look inside them.
+        this->SkCanvas::onDrawPicture(picture, matrix, paint);
+    }
+
+private:
+    bool fFound = false;
+};
+
+bool reads_backdrop(const SkPicture* picture, const SkIRect& bounds, const SkMatrix& matrix) {
+    BackdropFinder finder(bounds);
+    struct StopWhenFound final : public SkPicture::AbortCallback {
+        explicit StopWhenFound(const BackdropFinder& finder) : fFinder(finder) {}
+        bool abort() override { return fFinder.found(); }
+        const BackdropFinder& fFinder;
+    } stopWhenFound(finder);
+
+    finder.concat(matrix);
+    picture->playback(&finder, &stopWhenFound);
+    return finder.found();
+}
+
+}  // namespace
+
+void SkTiledPicturePlayback::DrawTiles(const SkPicture* picture, const SkBitmap& dst,
+                                       const SkMatrix& matrix, SkSpan<const SkIRect> tiles,
+                                       const SkSurfaceProps& props, SkExecutor& executor) {
+    if (tiles.size() <= 1 || reads_backdrop(picture, dst.bounds(), matrix)) {
+        SkCanvas canvas(dst, props);
+        canvas.concat(matrix);
+        picture->playback(&canvas);
+        return;
+    }
+
+    SkTaskGroup tasks(executor);
+    tasks.batch(SkToInt(tiles.size()), [&](int i) {
+        // Each tile gets its own SkBitmapDevice (and so its own SkRasterClip) over the shared
+        // pixels, in device coordinates. Restricting the clip lets the picture's BBH skip draws
+        // outside the tile.
+        SkCanvas canvas(dst, props);
+        canvas.clipIRect(tiles[i]);
+        canvas.concat(matrix);
+        picture->playback(&canvas);
+    });
+    tasks.wait();
+}
+
+SkISize SkTiledPicturePlayback::Grid(SkISize size, int columns, int rows) {
+    columns = std::min({columns, size.width(), kMaxTiles});
+    rows    = std::min({rows, size.height(), kMaxTiles / std::max(columns, 1)});
+    // 64-bit, so we'd notice if a grid of one tile per pixel slipped through.
+    SkASSERT((int64_t)columns * rows <= kMaxTiles);
+    return {columns, rows};
+}
+
+SkIRect SkTiledPicturePlayback::Tile(SkISize size, int columns, int rows, int column, int row) {
+    const SkISize grid = Grid(size, columns, rows);
+    columns = grid.width();
+    rows    = grid.height();
+    SkASSERT(0 <= column && column < columns);
+    SkASSERT(0 <= row    && row    < rows);
+
+    // 64-bit so huge targets split into many tiles can't overflow.
+    auto edge = [](int length, int count, int i) {
+        return (int)((int64_t)length * i / count);
+    };
+    return SkIRect::MakeLTRB(edge(size.width(),  columns, column),
+                             edge(size.height(), rows,    row),
+                             edge(size.width(),  columns, column + 1),
+                             edge(size.height(), rows,    row + 1));
+}
+
+bool SkTiledPicturePlayback::Draw(const SkPicture* picture, const SkPixmap& dst,
+                                  const SkMatrix& matrix, const Options& options) {
+    SkBitmap bitmap;
+    if (!picture || options.fColumns < 1 || options.fRows < 1 || !bitmap.installPixels(dst) ||
+        bitmap.drawsNothing()) {
+        return false;
+    }
+
+    const SkISize grid = Grid(dst.dimensions(), options.fColumns, options.fRows);
+    std::vector<SkIRect> tiles;
+    tiles.reserve(grid.width() * grid.height());
+    for (int row = 0; row < grid.height(); row++) {
+        for (int column = 0; column < grid.width(); column++) {
+            tiles.push_back(Tile(dst.dimensions(), grid.width(), grid.height(), column, row));
+        }
+    }
+
+    sk_sp<SkPicture> rerecorded;
+    if (options.fBuildBBH && tiles.size() > 1) {
+        // SkMiniPictures hold a single op and have nothing to cull.
+        const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(sk_ref_sp(picture));
+        if (big && !big->bbh()) {
+            SkRTreeFactory factory;
+            SkPictureRecorder recorder;
+            picture->playback(recorder.beginRecording(picture->cullRect(), &factory));
+            rerecorded = recorder.finishRecordingAsPicture();
+            picture = rerecorded.get();
+        }
+    }
+
+    SkExecutor& executor = options.fExecutor ? *options.fExecutor : SkExecutor::GetDefault();
+    DrawTiles(picture, bitmap, matrix, SkMakeSpan(tiles), options.fProps, executor);
+    return true;
+}
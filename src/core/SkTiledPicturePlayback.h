@@ -0,0 +1,88 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTiledPicturePlayback_DEFINED
+#define SkTiledPicturePlayback_DEFINED
+
+#include "include/core/SkRect.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkSpan.h"
+#include "include/core/SkSurfaceProps.h"
+
+class SkBitmap;
+class SkExecutor;
+class SkMatrix;
+class SkPicture;
+class SkPixmap;
+
+/**
+ *  Replays an SkPicture into an N x M grid of tiles concurrently.
+ *
+ *  Each tile is drawn on an SkExecutor through its own canvas over the destination pixels, clipped
+ *  to the tile, so the picture's BBH culls the ops that miss the tile. Tiles cover disjoint pixels
+ *  of the destination, so once every tile has finished the stitched result is already in place:
+ *  no tile is ever copied.
+ *
+ *  A saveLayer with a backdrop filter also reads the pixels around the layer, which may belong to
+ *  other tiles that are still being drawn. Pictures containing one are replayed on one thread.
+ */
+class SkTiledPicturePlayback {
+public:
+    struct Options {
+        // The destination is split into fColumns x fRows tiles of (nearly) equal size.
+        int fColumns = 4;
+        int fRows    = 4;
+
+        // Executor the tiles run on. If null, SkExecutor::GetDefault() is used.
+        SkExecutor* fExecutor = nullptr;
+
+        // If the picture has no BBH to cull with, re-record it into an SkRTree before drawing
+        // more than one tile. Without a BBH every tile replays every op.
+        bool fBuildBBH = true;
+
+        SkSurfaceProps fProps;
+    };
+
+    /**
+     *  Draws picture, transformed by matrix, into dst and blocks until every tile has finished.
+     *  The result matches drawing the picture with a single canvas over dst, except that where
+     *  a tile's clip cuts a span, anti-aliased edges and legacy shaders may round differently,
+     *  by one per channel, along the seams between tiles.
+     *
+     *  Returns false, leaving dst untouched, if there is no picture, dst has no pixels or a
+     *  color type we can't draw into, or the grid is empty.
+     */
+    static bool Draw(const SkPicture*, const SkPixmap& dst, const SkMatrix&, const Options&);
+
+    /**
+     *  Draws picture, transformed by matrix, into dst once per tile, each clipped to its tile,
+     *  and blocks until every tile has finished. The tiles must not overlap, and should cover
+     *  dst: if the picture has to be replayed on one thread, it is drawn into all of dst.
+     *
+     *  This is the replay loop shared by Draw() and SkThreadedRasterSurface.
+     */
+    static void DrawTiles(const SkPicture*, const SkBitmap& dst, const SkMatrix&,
+                          SkSpan<const SkIRect> tiles, const SkSurfaceProps&, SkExecutor&);
+
+    // Grids are clamped to at most this many tiles.
+    static constexpr int kMaxTiles = 1 << 16;
+
+    /**
+     *  Returns the grid actually used for a columns x rows grid over a target of the given size:
+     *  at most one pixel per tile in each direction, and no more than kMaxTiles tiles, dropping
+     *  rows first.
+     */
+    static SkISize Grid(SkISize size, int columns, int rows);
+
+    /**
+     *  Returns tile (column, row) of a columns x rows grid over a target of the given size, where
+     *  column and row index into Grid(size, columns, rows).
+     */
+    static SkIRect Tile(SkISize size, int columns, int rows, int column, int row);
+};
+
+#endif
@@ -629,6 +629,12 @@ namespace skvm {
         std::vector<Instruction> program() const { return fProgram; }
         std::vector<OptimizedInstruction> optimize(viz::Visualizer* visualizer = nullptr) const;
 
+        // What done() passes to Program, for callers that want to keep optimize()'s output,
+        // e.g. to serialize it and rebuild the same Program later.
+        std::vector<int>        strides()    const { return fStrides; }
+        std::vector<TraceHook*> traceHooks() const { return fTraceHooks; }
+        Features                features()   const { return fFeatures; }
+
         // Returns a trace-hook ID which must be passed to the trace opcodes.
         int attachTraceHook(TraceHook*);
 
@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkStream.h"
+#include "include/core/SkTime.h"
 #include "include/private/SkImageInfoPriv.h"
 #include "include/private/SkMacros.h"
+#include "include/private/SkMutex.h"
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkBlenderBase.h"
@@ -22,7 +25,10 @@
 #include "src/core/SkVMBlitter.h"
 #include "src/shaders/SkColorFilterShader.h"
 #include "src/shaders/SkColorShader.h"
+#include "src/utils/SkVMVisualizer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
 
 #define SK_BLITTER_TRACE_IS_SKVM
@@ -533,33 +539,392 @@ SkVMBlitter::SkVMBlitter(const SkPixmap& device,
         , fParams(EffectiveParams(device, sprite, paint, matrices, std::move(clip)))
         , fKey(CacheKey(fParams, &fUniforms, &fAlloc, ok)) {}
 
-SkVMBlitter::~SkVMBlitter() {
-    if (fStoreToCache) {
-        if (SkLRUCache<Key, skvm::Program>* cache = TryAcquireProgramCache()) {
-            auto cache_program = [&](SkTLazy<skvm::Program>& program, Coverage coverage) {
-                if (program.isValid() && !program->hasTraceHooks()) {
-                    cache->insert_or_update(fKey.withCoverage(coverage), std::move(*program));
-                }
-            };
-            for (int c = 0; c < Coverage::kCount; c++) {
-                cache_program(fPrograms[c], static_cast<Coverage>(c));
+SkVMBlitter::~SkVMBlitter() {}
+
+struct SkVMBlitter::CachedProgram {
+    skvm::Program                           program;
+    std::vector<skvm::OptimizedInstruction> instructions;
+    std::vector<int>                        strides;
+    size_t                                  uniformBytes = 0;
+
+    // Programs read by LoadProgramCache() aren't run until a blitter has rebuilt the same
+    // instructions itself.  That skips the JIT, but never trusts the file's contents.
+    mutable std::atomic<bool>               verified{true};
+};
+
+// The process-wide cache of SkVMBlitter programs.  Entries are shared_ptrs so a blitter can keep
+// using a program after another thread has evicted it.
+class SkVMBlitter::ProgramCache {
+public:
+    using Entry = std::shared_ptr<const CachedProgram>;
+
+    // An entry that isn't verified yet still has to be rebuilt, so it counts as a miss.
+    Entry find(const Key& key) {
+        SkAutoMutexExclusive lock(fMutex);
+        if (Entry* entry = fLRU.find(key)) {
+            if ((*entry)->verified) {
+                fHits++;
+            } else {
+                fMisses++;
             }
+            return *entry;
+        }
+        fMisses++;
+        return nullptr;
+    }
+
+    void insert(const Key& key, Entry entry) {
+        SkAutoMutexExclusive lock(fMutex);
+        fLRU.insert_or_update(key, std::move(entry));
+    }
+
+    void addCompileTime(double ms) {
+        SkAutoMutexExclusive lock(fMutex);
+        fCompileMs += ms;
+    }
+
+    void addVerified() {
+        SkAutoMutexExclusive lock(fMutex);
+        fVerified++;
+    }
+
+    ProgramCacheStats stats() {
+        SkAutoMutexExclusive lock(fMutex);
+        return {fHits, fMisses, fCompileMs, fLoaded, fVerified};
+    }
+
+    int save(SkWStream*);
+    int load(SkStream*);
+
+    void purge() {
+        SkAutoMutexExclusive lock(fMutex);
+        fLRU.reset();
+        fHits = fMisses = 0;
+        fCompileMs = 0;
+        fLoaded = fVerified = 0;
+    }
+
+private:
+    static constexpr int kMaxPrograms = 256;
+
+    SkMutex                fMutex;
+    SkLRUCache<Key, Entry> fLRU       SK_GUARDED_BY(fMutex){kMaxPrograms};
+    int                    fHits      SK_GUARDED_BY(fMutex) = 0;
+    int                    fMisses    SK_GUARDED_BY(fMutex) = 0;
+    double                 fCompileMs SK_GUARDED_BY(fMutex) = 0;
+    int                    fLoaded    SK_GUARDED_BY(fMutex) = 0;
+    int                    fVerified  SK_GUARDED_BY(fMutex) = 0;
+};
+
+thread_local SkVMBlitter::ProgramCache* SkVMBlitter::gPrivateProgramCache = nullptr;
+
+SkVMBlitter::ProgramCache& SkVMBlitter::ActiveProgramCache() {
+    if (gPrivateProgramCache) {
+        return *gPrivateProgramCache;
+    }
+    static auto* cache = new ProgramCache;
+    return *cache;
+}
+
+SkVMBlitter::ScopedPrivateProgramCache::ScopedPrivateProgramCache()
+    : fCache(std::make_unique<ProgramCache>())
+    , fPrevious(gPrivateProgramCache) {
+    gPrivateProgramCache = fCache.get();
+}
+
+SkVMBlitter::ScopedPrivateProgramCache::~ScopedPrivateProgramCache() {
+    SkASSERT(gPrivateProgramCache == fCache.get());
+    gPrivateProgramCache = fPrevious;
+}
 
-            ReleaseProgramCache();
+// The serialized cache is a header followed by programs, each written as its Key, its strides,
+// the size of its uniforms, and the optimized instructions it was built from.  Programs are
+// re-JITted when loaded.
+namespace {
+    static constexpr uint32_t kProgramCacheMagic   = SkSetFourByteTag('s', 'k', 'v', 'm');
+    static constexpr uint32_t kProgramCacheVersion = 2;
+
+    #define M(op) +1
+    static constexpr int kNumOps = 0 SKVM_OPS(M);
+    #undef M
+
+    static uint32_t features_bits(const skvm::Features& features) {
+        return (features.fma  ? 1 : 0)
+             | (features.fp16 ? 2 : 0);
+    }
+
+    // How many of x,y,z,w each op reads, or -1 for ops a blitter program never contains.
+    static int num_args(skvm::Op op) {
+        using skvm::Op;
+        switch (op) {
+            case Op::trace_line: case Op::trace_var:
+            case Op::trace_enter: case Op::trace_exit: case Op::trace_scope:
+            case Op::duplicate:
+                return -1;
+
+            case Op::load8: case Op::load16: case Op::load32: case Op::load64: case Op::load128:
+            case Op::index: case Op::uniform32: case Op::array32: case Op::splat:
+                return 0;
+
+            case Op::store8: case Op::store16: case Op::store32:
+            case Op::gather8: case Op::gather16: case Op::gather32:
+            case Op::sqrt_f32:
+            case Op::shl_i32: case Op::shr_i32: case Op::sra_i32:
+            case Op::ceil: case Op::floor: case Op::trunc: case Op::round:
+            case Op::to_fp16: case Op::from_fp16: case Op::to_f32:
+                return 1;
+
+            case Op::fma_f32: case Op::fms_f32: case Op::fnma_f32: case Op::select:
+                return 3;
+
+            case Op::store128:
+                return 4;
+
+            default:
+                return 2;
+        }
+    }
+
+    // Check the immediates the interpreter and JIT use as argument indices and uniform offsets.
+    static bool valid_immediates(const skvm::OptimizedInstruction& inst,
+                                 const std::vector<int>& strides,
+                                 size_t uniformBytes) {
+        using skvm::Op;
+        auto varying_ptr = [&](int ix) {
+            return 0 <= ix && ix < (int)strides.size() && strides[ix] > 0;
+        };
+        auto uniform_offset = [&](int ix, int offset, size_t size) {
+            return 0 <= ix && ix < (int)strides.size() && strides[ix] == 0
+                && 0 <= offset && SkIsAlign4(offset)
+                && (size_t)offset + size <= uniformBytes;
+        };
+        switch (inst.op) {
+            case Op::store8: case Op::store16: case Op::store32: case Op::store64:
+            case Op::store128:
+            case Op::load8: case Op::load16: case Op::load32:
+                return varying_ptr(inst.immA) && inst.immB == 0 && inst.immC == 0;
+            case Op::load64:
+                return varying_ptr(inst.immA) && 0 <= inst.immB && inst.immB < 2
+                                              && inst.immC == 0;
+            case Op::load128:
+                return varying_ptr(inst.immA) && 0 <= inst.immB && inst.immB < 4
+                                              && inst.immC == 0;
+
+            case Op::gather8: case Op::gather16: case Op::gather32:
+                return uniform_offset(inst.immA, inst.immB, sizeof(void*)) && inst.immC == 0;
+            case Op::uniform32:
+                return uniform_offset(inst.immA, inst.immB, sizeof(int)) && inst.immC == 0;
+            case Op::array32:
+                return uniform_offset(inst.immA, inst.immB, sizeof(void*))
+                    && 0 <= inst.immC && SkIsAlign4(inst.immC);
+
+            case Op::splat:
+                return inst.immB == 0 && inst.immC == 0;
+            case Op::shl_i32: case Op::shr_i32: case Op::sra_i32:
+                return 0 <= inst.immA && inst.immA < 32 && inst.immB == 0 && inst.immC == 0;
+
+            default:
+                return inst.immA == 0 && inst.immB == 0 && inst.immC == 0;
+        }
+    }
+
+    static bool same_instructions(const std::vector<skvm::OptimizedInstruction>& a,
+                                  const std::vector<skvm::OptimizedInstruction>& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                          [](const skvm::OptimizedInstruction& x,
+                             const skvm::OptimizedInstruction& y) {
+            return x.op   == y.op   && x.x    == y.x    && x.y    == y.y
+                && x.z    == y.z    && x.w    == y.w
+                && x.immA == y.immA && x.immB == y.immB && x.immC == y.immC
+                && x.death == y.death && x.can_hoist == y.can_hoist;
+        });
+    }
+
+    // Everything the Program constructor trusts: well formed instructions, sensible immediates,
+    // and the same register lifetimes and hoisting finalize() would have computed.
+    static bool valid_program(const std::vector<skvm::OptimizedInstruction>& program,
+                              const std::vector<int>& strides,
+                              size_t uniformBytes) {
+        std::vector<skvm::Instruction> unoptimized;
+        unoptimized.reserve(program.size());
+        for (const skvm::OptimizedInstruction& inst : program) {
+            if (!valid_immediates(inst, strides, uniformBytes)) {
+                return false;
+            }
+            unoptimized.push_back({inst.op, inst.x,inst.y,inst.z,inst.w,
+                                   inst.immA,inst.immB,inst.immC});
         }
+        return same_instructions(program, skvm::finalize(std::move(unoptimized)));
+    }
+}  // namespace
+
+int SkVMBlitter::ProgramCache::save(SkWStream* stream) {
+    std::vector<std::pair<Key, Entry>> entries;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        fLRU.foreach([&](const Key* key, Entry* entry) { entries.emplace_back(*key, *entry); });
     }
+
+    bool ok = stream->write32(kProgramCacheMagic)
+           && stream->write32(kProgramCacheVersion)
+           && stream->write32(features_bits(skvm::Builder{}.features()))
+           && stream->write32(kNumOps)
+           && stream->write32(SkToU32(entries.size()));
+    for (size_t i = 0; ok && i < entries.size(); i++) {
+        const Key& key = entries[i].first;
+        const CachedProgram& cached = *entries[i].second;
+        ok = stream->write(&key.shader,     sizeof(key.shader))
+          && stream->write(&key.clip,       sizeof(key.clip))
+          && stream->write(&key.blender,    sizeof(key.blender))
+          && stream->write(&key.colorSpace, sizeof(key.colorSpace))
+          && stream->write8(key.colorType)
+          && stream->write8(key.alphaType)
+          && stream->write8(key.coverage)
+          && stream->write32(SkToU32(cached.strides.size()));
+        for (int stride : cached.strides) {
+            ok = ok && stream->write32((uint32_t)stride);
+        }
+        ok = ok && stream->write32(SkToU32(cached.uniformBytes))
+                && stream->write32(SkToU32(cached.instructions.size()));
+        for (const skvm::OptimizedInstruction& inst : cached.instructions) {
+            ok = ok && stream->write32((uint32_t)inst.op)
+                    && stream->write32((uint32_t)inst.x)
+                    && stream->write32((uint32_t)inst.y)
+                    && stream->write32((uint32_t)inst.z)
+                    && stream->write32((uint32_t)inst.w)
+                    && stream->write32((uint32_t)inst.immA)
+                    && stream->write32((uint32_t)inst.immB)
+                    && stream->write32((uint32_t)inst.immC)
+                    && stream->write32((uint32_t)inst.death)
+                    && stream->writeBool(inst.can_hoist);
+        }
+    }
+    return ok ? SkToInt(entries.size()) : 0;
 }
 
-SkLRUCache<SkVMBlitter::Key, skvm::Program>* SkVMBlitter::TryAcquireProgramCache() {
-#if defined(SKVM_JIT)
-    thread_local static SkLRUCache<Key, skvm::Program> cache{64};
-    return &cache;
-#else
-    // iOS now supports thread_local since iOS 9.
-    // On the other hand, we'll never be able to JIT there anyway.
-    // It's probably fine to not cache any interpreted programs, anywhere.
-    return nullptr;
-#endif
+int SkVMBlitter::ProgramCache::load(SkStream* stream) {
+    uint32_t magic, version, features, numOps, count;
+    if (!stream->readU32(&magic)    || magic    != kProgramCacheMagic   ||
+        !stream->readU32(&version)  || version  != kProgramCacheVersion ||
+        !stream->readU32(&features) || features != features_bits(skvm::Builder{}.features()) ||
+        !stream->readU32(&numOps)   || numOps   != (uint32_t)kNumOps    ||
+        !stream->readU32(&count)) {
+        return 0;
+    }
+
+    // Read each instruction, checking that its op is one we'd build, that it reads exactly
+    // the arguments that op needs, all earlier values, and that it dies no earlier than itself.
+    auto read_instruction = [stream](skvm::OptimizedInstruction* inst, int index, int count) {
+        int32_t op, args[4];
+        bool canHoist;
+        if (!stream->readS32(&op) ||
+            !stream->readS32(&args[0]) || !stream->readS32(&args[1]) ||
+            !stream->readS32(&args[2]) || !stream->readS32(&args[3]) ||
+            !stream->readS32(&inst->immA) || !stream->readS32(&inst->immB) ||
+            !stream->readS32(&inst->immC) || !stream->readS32(&inst->death) ||
+            !stream->readBool(&canHoist)) {
+            return false;
+        }
+        if (op < 0 || op >= kNumOps) {
+            return false;
+        }
+        const int numArgs = num_args((skvm::Op)op);
+        if (numArgs < 0) {
+            return false;
+        }
+        for (int a = 0; a < 4; a++) {
+            if (a < numArgs ? (args[a] < 0 || args[a] >= index) : args[a] != skvm::NA) {
+                return false;
+            }
+        }
+        if (inst->death < index || inst->death > count) {
+            return false;
+        }
+        inst->op = (skvm::Op)op;
+        inst->x = args[0];
+        inst->y = args[1];
+        inst->z = args[2];
+        inst->w = args[3];
+        inst->can_hoist = canHoist;
+        return true;
+    };
+
+    // A damaged file loads nothing, rather than whatever programs precede the damage.
+    std::vector<std::pair<Key, std::shared_ptr<CachedProgram>>> programs;
+    for (uint32_t i = 0; i < count; i++) {
+        Key key;
+        uint32_t numStrides, uniformBytes, numInstructions;
+        if (!stream->read(&key.shader,     sizeof(key.shader))     ||
+            !stream->read(&key.clip,       sizeof(key.clip))       ||
+            !stream->read(&key.blender,    sizeof(key.blender))    ||
+            !stream->read(&key.colorSpace, sizeof(key.colorSpace)) ||
+            !stream->readU8(&key.colorType) ||
+            !stream->readU8(&key.alphaType) ||
+            !stream->readU8(&key.coverage)  || key.coverage >= Coverage::kCount ||
+            !stream->readU32(&numStrides)   || numStrides > 8) {  // We use at most 4 arguments.
+            return 0;
+        }
+
+        auto cached = std::make_shared<CachedProgram>();
+        for (uint32_t s = 0; s < numStrides; s++) {
+            int32_t stride;
+            if (!stream->readS32(&stride) || stride < 0) {
+                return 0;
+            }
+            cached->strides.push_back(stride);
+        }
+        if (!stream->readU32(&uniformBytes)    || uniformBytes    > (1 << 20) ||
+            !stream->readU32(&numInstructions) || numInstructions > (1 << 20)) {
+            return 0;
+        }
+        cached->uniformBytes = uniformBytes;
+        for (uint32_t n = 0; n < numInstructions; n++) {
+            cached->instructions.emplace_back();
+            if (!read_instruction(&cached->instructions.back(),
+                                  SkToInt(n), SkToInt(numInstructions))) {
+                return 0;
+            }
+        }
+        if (!valid_program(cached->instructions, cached->strides, cached->uniformBytes)) {
+            return 0;
+        }
+        cached->verified = false;
+        programs.emplace_back(key, std::move(cached));
+    }
+    if (!stream->isAtEnd()) {
+        return 0;
+    }
+
+    for (auto& [key, cached] : programs) {
+        cached->program = skvm::Program(cached->instructions,
+                                        /*visualizer=*/nullptr,
+                                        cached->strides,
+                                        /*traceHooks=*/{},
+                                        DebugName(key).c_str(),
+                                        /*allow_jit=*/true);
+        this->insert(key, std::move(cached));
+    }
+
+    const int loaded = SkToInt(programs.size());
+    SkAutoMutexExclusive lock(fMutex);
+    fLoaded += loaded;
+    return loaded;
+}
+
+SkVMBlitter::ProgramCacheStats SkVMBlitter::GetProgramCacheStats() {
+    return ActiveProgramCache().stats();
+}
+
+int SkVMBlitter::SaveProgramCache(SkWStream* stream) {
+    return ActiveProgramCache().save(stream);
+}
+
+int SkVMBlitter::LoadProgramCache(SkStream* stream) {
+    return ActiveProgramCache().load(stream);
+}
+
+void SkVMBlitter::PurgeProgramCache() {
+    ActiveProgramCache().purge();
 }
 
 SkString SkVMBlitter::DebugName(const Key& key) {
@@ -574,9 +939,7 @@ SkString SkVMBlitter::DebugName(const Key& key) {
                           key.coverage);
 }
 
-void SkVMBlitter::ReleaseProgramCache() {}
-
-skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
+const skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
     // eg, blitter re-use...
     if (fProgramPtrs[coverage]) {
         return fProgramPtrs[coverage];
@@ -584,21 +947,16 @@ skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
 
     // Next, cache lookup...
     Key key = fKey.withCoverage(coverage);
-    {
-        skvm::Program* p = nullptr;
-        if (SkLRUCache<Key, skvm::Program>* cache = TryAcquireProgramCache()) {
-            p = cache->find(key);
-            ReleaseProgramCache();
-        }
-        if (p) {
-            SkASSERT(!p->empty());
-            fProgramPtrs[coverage] = p;
-            return p;
-        }
+    ProgramCache::Entry loaded = ActiveProgramCache().find(key);
+    if (loaded && loaded->verified) {
+        SkASSERT(!loaded->program.empty());
+        fPrograms[coverage] = std::move(loaded);
+        fProgramPtrs[coverage] = &fPrograms[coverage]->program;
+        return fProgramPtrs[coverage];
     }
 
     // Okay, let's build it...
-    fStoreToCache = true;
+    const double start = SkTime::GetNSecs();
 
     // We don't really _need_ to rebuild fUniforms here.
     // It's just more natural to have effects unconditionally emit them,
@@ -611,7 +969,29 @@ skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
     SkASSERTF(fUniforms.buf.size() == prev,
               "%zu, prev was %zu", fUniforms.buf.size(), prev);
 
-    skvm::Program program = builder.done(DebugName(key).c_str());
+    auto cached = std::make_shared<CachedProgram>();
+    cached->instructions = builder.optimize();
+    cached->strides      = builder.strides();
+    cached->uniformBytes = fUniforms.buf.size() * sizeof(int);
+
+    // A program from LoadProgramCache() can be used once we know it's exactly what we'd build.
+    if (loaded && loaded->uniformBytes == cached->uniformBytes
+               && loaded->strides      == cached->strides
+               && same_instructions(loaded->instructions, cached->instructions)) {
+        loaded->verified = true;
+        ActiveProgramCache().addVerified();
+        fPrograms[coverage] = std::move(loaded);
+        fProgramPtrs[coverage] = &fPrograms[coverage]->program;
+        return fProgramPtrs[coverage];
+    }
+
+    cached->program      = skvm::Program(cached->instructions,
+                                         /*visualizer=*/nullptr,
+                                         cached->strides,
+                                         builder.traceHooks(),
+                                         DebugName(key).c_str(),
+                                         /*allow_jit=*/true);
+    const skvm::Program& program = cached->program;
     if ((false)) {
         static std::atomic<int> missed{0},
                                 total{0};
@@ -627,7 +1007,14 @@ skvm::Program* SkVMBlitter::buildProgram(Coverage coverage) {
                                 total.load(), missed.load()); });
         }
     }
-    fProgramPtrs[coverage] = fPrograms[coverage].set(std::move(program));
+    ActiveProgramCache().addCompileTime((SkTime::GetNSecs() - start) * 1e-6);
+
+    // Programs with trace hooks point at debugger state that won't outlive this draw.
+    if (!program.hasTraceHooks()) {
+        ActiveProgramCache().insert(key, cached);
+    }
+    fPrograms[coverage] = std::move(cached);
+    fProgramPtrs[coverage] = &fPrograms[coverage]->program;
     return fProgramPtrs[coverage];
 }
 
@@ -645,7 +1032,7 @@ const void* SkVMBlitter::isSprite(int x, int y) const {
 }
 
 void SkVMBlitter::blitH(int x, int y, int w) {
-    skvm::Program* blit_h = this->buildProgram(Coverage::Full);
+    const skvm::Program* blit_h = this->buildProgram(Coverage::Full);
     this->updateUniforms(x+w, y);
     if (const void* sprite = this->isSprite(x,y)) {
         SK_BLITTER_TRACE_STEP(blitH1, true, /*scanlines=*/1, /*pixels=*/w);
@@ -657,8 +1044,8 @@ void SkVMBlitter::blitH(int x, int y, int w) {
 }
 
 void SkVMBlitter::blitAntiH(int x, int y, const SkAlpha cov[], const int16_t runs[]) {
-    skvm::Program* blit_anti_h = this->buildProgram(Coverage::UniformF);
-    skvm::Program* blit_h = this->buildProgram(Coverage::Full);
+    const skvm::Program* blit_anti_h = this->buildProgram(Coverage::UniformF);
+    const skvm::Program* blit_h = this->buildProgram(Coverage::Full);
 
     SK_BLITTER_TRACE_STEP(blitAntiH, true, /*scanlines=*/1ul, /*pixels=*/0ul);
     for (int16_t run = *runs; run > 0; run = *runs) {
@@ -688,6 +1075,44 @@ void SkVMBlitter::blitAntiH(int x, int y, const SkAlpha cov[], const int16_t run
     }
 }
 
+void SkVMBlitter::blitSpans(const Span spans[], int count) {
+    const skvm::Program* blit_anti_h = nullptr;
+    const skvm::Program* blit_h = nullptr;
+
+    SK_BLITTER_TRACE_STEP(blitSpans, true, /*scanlines=*/count, /*pixels=*/0ul);
+    for (int i = 0; i < count; ++i) {
+        const int x = spans[i].fX,
+                  y = spans[i].fY,
+                  w = spans[i].fWidth;
+        const SkAlpha coverage = spans[i].fAlpha;
+        if (coverage == 0x00) {
+            continue;
+        }
+        this->updateUniforms(x+w, y);
+        const void* sprite = this->isSprite(x,y);
+        if (coverage == 0xFF) {
+            if (!blit_h) {
+                blit_h = this->buildProgram(Coverage::Full);
+            }
+            if (sprite) {
+                blit_h->eval(w, fUniforms.buf.data(), fDevice.addr(x,y), sprite);
+            } else {
+                blit_h->eval(w, fUniforms.buf.data(), fDevice.addr(x,y));
+            }
+        } else {
+            if (!blit_anti_h) {
+                blit_anti_h = this->buildProgram(Coverage::UniformF);
+            }
+            const float covF = coverage * (1/255.0f);
+            if (sprite) {
+                blit_anti_h->eval(w, fUniforms.buf.data(), fDevice.addr(x,y), sprite, &covF);
+            } else {
+                blit_anti_h->eval(w, fUniforms.buf.data(), fDevice.addr(x,y), &covF);
+            }
+        }
+    }
+}
+
 void SkVMBlitter::blitMask(const SkMask& mask, const SkIRect& clip) {
     if (mask.fFormat == SkMask::kBW_Format) {
         return SkBlitter::blitMask(mask, clip);
@@ -10,10 +10,13 @@
 
 #include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlitter.h"
-#include "src/core/SkLRUCache.h"
-#include "src/core/SkTLazy.h"
 #include "src/core/SkVM.h"
 
+#include <memory>
+
+class SkStream;
+class SkWStream;
+
 class SkVMBlitter final : public SkBlitter {
 public:
     static SkVMBlitter* Make(const SkPixmap& dst,
@@ -39,6 +42,43 @@ public:
 
     ~SkVMBlitter() override;
 
+    // SkVMBlitter programs are cached process-wide, shared by all threads.
+    struct ProgramCacheStats {
+        int     hits;
+        int     misses;     // Includes loaded programs found before they were verified.
+        double  compileMs;  // Total time spent building programs for misses.
+        int     loaded;     // Programs added by LoadProgramCache().
+        int     verified;   // Loaded programs a blitter rebuilt, matched, and then used.
+    };
+    static ProgramCacheStats GetProgramCacheStats();
+
+    // Write every cached program to the stream, so a later process can LoadProgramCache()
+    // instead of rebuilding them. Returns the number of programs written.
+    static int SaveProgramCache(SkWStream*);
+
+    // Rebuild and cache the programs written by SaveProgramCache(). Returns the number of
+    // programs loaded; files written by a different build or a CPU with different features,
+    // and damaged files, load nothing.  A loaded program is only used once a blitter has built
+    // the same instructions itself, so loading saves JIT time but never changes what's drawn.
+    static int LoadProgramCache(SkStream*);
+
+    // Drop all cached programs and reset the stats. Mostly for tests.
+    static void PurgeProgramCache();
+
+    // While one of these is alive, SkVMBlitters made on this thread, and the functions above
+    // called on this thread, use an empty cache of its own instead of the process-wide one.
+    // Tests use it to check exact stats while other threads draw.
+    class ProgramCache;
+    class ScopedPrivateProgramCache {
+    public:
+        ScopedPrivateProgramCache();
+        ~ScopedPrivateProgramCache();
+
+    private:
+        std::unique_ptr<ProgramCache> fCache;
+        ProgramCache*                 fPrevious;
+    };
+
 private:
     enum Coverage { Full, UniformF, MaskA8, MaskLCD16, Mask3D, kCount };
     struct Key {
@@ -81,16 +121,21 @@ private:
                              skvm::Uniforms* uniforms, SkArenaAlloc* alloc);
     static Key CacheKey(const Params& params,
                         skvm::Uniforms* uniforms, SkArenaAlloc* alloc, bool* ok);
-    static SkLRUCache<Key, skvm::Program>* TryAcquireProgramCache();
     static SkString DebugName(const Key& key);
-    static void ReleaseProgramCache();
 
-    skvm::Program* buildProgram(Coverage coverage);
+    // A program, and what it was built from so it can be serialized.
+    struct CachedProgram;
+    // The process-wide cache, unless this thread has a ScopedPrivateProgramCache.
+    static ProgramCache& ActiveProgramCache();
+    static thread_local ProgramCache* gPrivateProgramCache;
+
+    const skvm::Program* buildProgram(Coverage coverage);
     void updateUniforms(int right, int y);
     const void* isSprite(int x, int y) const;
 
     void blitH(int x, int y, int w) override;
     void blitAntiH(int x, int y, const SkAlpha cov[], const int16_t runs[]) override;
+    void blitSpans(const Span spans[], int count) override;
 
 private:
     void blitMask(const SkMask& mask, const SkIRect& clip) override;
@@ -102,9 +147,8 @@ private:
     SkArenaAlloc    fAlloc{2*sizeof(void*)};  // but a few effects need to ref large content.
     const Params    fParams;
     const Key       fKey;
-    bool            fStoreToCache = false;
-    skvm::Program*         fProgramPtrs[Coverage::kCount] = {nullptr};
-    SkTLazy<skvm::Program> fPrograms[Coverage::kCount];
+    const skvm::Program*                 fProgramPtrs[Coverage::kCount] = {nullptr};
+    std::shared_ptr<const CachedProgram> fPrograms[Coverage::kCount];
 
     friend class Viewer;
 };
@@ -11,6 +11,7 @@
 #include "include/core/SkTileMode.h"
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
+#include "include/private/SkTArray.h"
 #include "include/private/SkTFitsIn.h"
 #include "include/private/SkTPin.h"
 #include "include/private/SkVx.h"
@@ -21,6 +22,7 @@
 #include "src/core/SkOpts.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
 #if SK_SUPPORT_GPU
@@ -719,6 +721,88 @@ private:
     skvx::Vec<4, uint32_t>* fBuffer1Cursor;
 };
 
+// Large blurs are split into bands, rows for the X pass and strips of columns for the Y pass,
+// that run in parallel on the default SkExecutor. Every band has its own Pass, since a Pass
+// carries the running sums of the line it's blurring. Bands cover at least kMinPixelsPerBand
+// pixels, so blurs too small to be worth the threads stay on this one.
+static constexpr int kMinPixelsPerBand = 64 * 1024;
+static constexpr int kMaxBands         = 16;
+
+// The Y pass copies kStripWidth columns at a time into a transposed scratch buffer, so it reads
+// and writes whole cache lines of the image, and blurs each column there with unit stride.
+static constexpr int kStripWidth = 16;
+
+// Returns how many lines of [0, lines) each band should hold.
+int lines_per_band(int lines, int pixelsPerLine) {
+    int64_t pixels = (int64_t)lines * pixelsPerLine;
+    int bands = (int)std::min<int64_t>(pixels / kMinPixelsPerBand, kMaxBands);
+    bands = SkTPin(bands, 1, std::max(lines, 1));
+    return (lines + bands - 1) / bands;
+}
+
+// Blurs each of the rows of src into dst, in parallel bands of rows.
+void blur_x(const SkSTArray<kMaxBands, Pass*>& passes, int rowsPerBand, int rows,
+            int srcLeft, int srcRight, int dstRight,
+            const uint32_t* src, int srcRowStride, uint32_t* dst, int dstRowStride) {
+    auto blurRows = [&](int y0, int y1) {
+        Pass* pass = passes[y0 / rowsPerBand];
+        for (int y = y0; y < y1; y++) {
+            pass->blur(srcLeft, srcRight, dstRight,
+                       src + (int64_t)y * srcRowStride, 1, dst + (int64_t)y * dstRowStride, 1);
+        }
+    };
+    if (passes.count() == 1) {
+        blurRows(0, rows);
+        return;
+    }
+    SkTaskGroup().parallel_for(0, rows, rowsPerBand, blurRows);
+}
+
+// Blurs each of the columns of src into dst, in parallel bands of kStripWidth wide strips.
+// A strip's dst columns may overlap its src columns, as long as dst starts no lower than src.
+void blur_y(const SkSTArray<kMaxBands, Pass*>& passes, int stripsPerBand, int columns,
+            int srcTop, int srcBottom, int dstBottom,
+            const uint32_t* src, int srcRowStride, uint32_t* dst, int dstRowStride) {
+    const int srcH = srcBottom - srcTop,
+              dstH = dstBottom;
+    const int strips = (columns + kStripWidth - 1) / kStripWidth;
+
+    auto blurStrips = [&](int s0, int s1) {
+        Pass* pass = passes[s0 / stripsPerBand];
+        // Column c of the strip is scratch[c*srcH, (c+1)*srcH) before blurring, and
+        // blurred[c*dstH, (c+1)*dstH) after.
+        SkAutoTMalloc<uint32_t> scratch((size_t)kStripWidth * (srcH + dstH));
+        uint32_t* columnsIn  = scratch.get();
+        uint32_t* columnsOut = columnsIn + (size_t)kStripWidth * srcH;
+
+        for (int strip = s0; strip < s1; strip++) {
+            const int x0 = strip * kStripWidth,
+                      w  = std::min(kStripWidth, columns - x0);
+            for (int y = 0; y < srcH; y++) {
+                const uint32_t* row = src + (int64_t)y * srcRowStride + x0;
+                for (int c = 0; c < w; c++) {
+                    columnsIn[c * srcH + y] = row[c];
+                }
+            }
+            for (int c = 0; c < w; c++) {
+                pass->blur(srcTop, srcBottom, dstBottom,
+                           columnsIn + c * srcH, 1, columnsOut + c * dstH, 1);
+            }
+            for (int y = 0; y < dstH; y++) {
+                uint32_t* row = dst + (int64_t)y * dstRowStride + x0;
+                for (int c = 0; c < w; c++) {
+                    row[c] = columnsOut[c * dstH + y];
+                }
+            }
+        }
+    };
+    if (passes.count() == 1) {
+        blurStrips(0, strips);
+        return;
+    }
+    SkTaskGroup().parallel_for(0, strips, stripsPerBand, blurStrips);
+}
+
 sk_sp<SkSpecialImage> copy_image_with_bounds(
         const SkImageFilter_Base::Context& ctx, const sk_sp<SkSpecialImage> &input,
         SkIRect srcBounds, SkIRect dstBounds) {
@@ -842,8 +926,29 @@ sk_sp<SkSpecialImage> cpu_blur(
         return nullptr;
     }
 
+    // Every band gets its own pass buffer. Band i's X pass and Y pass share buffer i, since the
+    // X pass is done before the Y pass begins.
+    const int intermediateW = makerX->window() > 1 ? dstW : srcW;
+    const int rowsPerBand   = lines_per_band(srcH, dstW),
+              stripsPerBand = lines_per_band((intermediateW + kStripWidth - 1) / kStripWidth,
+                                             kStripWidth * dstH),
+              bands = std::max((srcH + rowsPerBand - 1) / rowsPerBand,
+                               (intermediateW + kStripWidth * stripsPerBand - 1) /
+                               (kStripWidth * stripsPerBand));
     size_t bufferSizeBytes = std::max(makerX->bufferSizeBytes(), makerY->bufferSizeBytes());
-    auto buffer = alloc.makeBytesAlignedTo(bufferSizeBytes, alignof(skvx::Vec<4, uint32_t>));
+    SkSTArray<kMaxBands, void*> buffers;
+    for (int i = 0; i < bands; i++) {
+        buffers.push_back(alloc.makeBytesAlignedTo(bufferSizeBytes,
+                                                   alignof(skvx::Vec<4, uint32_t>)));
+    }
+    // The arena isn't thread safe, so we make every band's Pass here, up front.
+    auto makePasses = [&](PassMaker* maker, int count) {
+        SkSTArray<kMaxBands, Pass*> passes;
+        for (int i = 0; i < count; i++) {
+            passes.push_back(maker->makePass(buffers[i], &alloc));
+        }
+        return passes;
+    };
 
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
@@ -873,7 +978,6 @@ sk_sp<SkSpecialImage> cpu_blur(
     }
 
     if (makerX->window() > 1) {
-        Pass* pass = makerX->makePass(buffer, &alloc);
         // Make int64 to avoid overflow in multiplication below.
         int64_t shift = srcBounds.top() - dstBounds.top();
 
@@ -886,27 +990,19 @@ sk_sp<SkSpecialImage> cpu_blur(
         intermediateWidth = dstW;
         intermediateDst = static_cast<uint32_t *>(dst.getPixels());
 
-        const uint32_t* srcCursor = static_cast<uint32_t*>(src.getPixels());
-        uint32_t* dstCursor = intermediateSrc;
-        for (auto y = 0; y < srcH; y++) {
-            pass->blur(srcBounds.left(), srcBounds.right(), dstBounds.right(),
-                      srcCursor, 1, dstCursor, 1);
-            srcCursor += src.rowBytesAsPixels();
-            dstCursor += intermediateRowBytesAsPixels;
-        }
+        blur_x(makePasses(makerX, (srcH + rowsPerBand - 1) / rowsPerBand), rowsPerBand, srcH,
+               srcBounds.left(), srcBounds.right(), dstBounds.right(),
+               static_cast<uint32_t*>(src.getPixels()), src.rowBytesAsPixels(),
+               intermediateSrc, intermediateRowBytesAsPixels);
     }
 
     if (makerY->window() > 1) {
-        Pass* pass = makerY->makePass(buffer, &alloc);
-        const uint32_t* srcCursor = intermediateSrc;
-        uint32_t* dstCursor = intermediateDst;
-        for (auto x = 0; x < intermediateWidth; x++) {
-            pass->blur(srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
-                       srcCursor, intermediateRowBytesAsPixels,
-                       dstCursor, dst.rowBytesAsPixels());
-            srcCursor += 1;
-            dstCursor += 1;
-        }
+        SkASSERT(intermediateWidth == intermediateW);
+        const int strips = (intermediateWidth + kStripWidth - 1) / kStripWidth;
+        blur_y(makePasses(makerY, (strips + stripsPerBand - 1) / stripsPerBand), stripsPerBand,
+               intermediateWidth, srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
+               intermediateSrc, intermediateRowBytesAsPixels,
+               intermediateDst, dst.rowBytesAsPixels());
     }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
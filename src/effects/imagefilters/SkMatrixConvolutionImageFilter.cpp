@@ -12,11 +12,16 @@
 #include "include/effects/SkImageFilters.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkTPin.h"
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
+#include <type_traits>
+
 #if SK_SUPPORT_GPU
 #include "src/gpu/ganesh/GrRecordingContextPriv.h"
 #include "src/gpu/ganesh/GrTextureProxy.h"
@@ -45,6 +50,7 @@ public:
         SkASSERT(kernelSize.fWidth >= 1 && kernelSize.fHeight >= 1);
         SkASSERT(kernelOffset.fX >= 0 && kernelOffset.fX < kernelSize.fWidth);
         SkASSERT(kernelOffset.fY >= 0 && kernelOffset.fY < kernelSize.fHeight);
+        this->separateKernel();
     }
 
     ~SkMatrixConvolutionImageFilter() override {
@@ -72,6 +78,13 @@ private:
     SkTileMode  fTileMode;
     bool        fConvolveAlpha;
 
+    // If fKernel is the outer product of a column and a row, and both are longer than 1, the
+    // raster path convolves with the row and then the column. Otherwise these are empty.
+    SkAutoTArray<SkScalar> fKernelRow;
+    SkAutoTArray<SkScalar> fKernelColumn;
+
+    void separateKernel();
+
     template <class PixelFetcher, bool convolveAlpha>
     void filterPixels(const SkBitmap& src,
                       SkBitmap* result,
@@ -95,6 +108,18 @@ private:
                             const SkIRect& rect,
                             const SkIRect& bounds) const;
 
+    // Fast paths for interior pixels, which never sample outside of src.
+    template <bool convolveAlpha>
+    void filterInteriorDirect(const SkBitmap& src,
+                              SkBitmap* result,
+                              const SkIVector& offset,
+                              const SkIRect& rect) const;
+    template <bool convolveAlpha>
+    void filterInteriorSeparable(const SkBitmap& src,
+                                 SkBitmap* result,
+                                 const SkIVector& offset,
+                                 const SkIRect& rect) const;
+
     using INHERITED = SkImageFilter_Base;
 };
 
@@ -140,6 +165,57 @@ public:
     }
 };
 
+// Turns the sums of one pixel's weighted channels into that pixel.
+template <bool convolveAlpha>
+static inline SkPMColor convolved_pixel(SkScalar sumA, SkScalar sumR, SkScalar sumG, SkScalar sumB,
+                                        SkScalar gain, SkScalar bias, SkPMColor center) {
+    int a = convolveAlpha
+          ? SkTPin(SkScalarFloorToInt(sumA * gain + bias), 0, 255)
+          : 255;
+    int r = SkTPin(SkScalarFloorToInt(sumR * gain + bias), 0, a);
+    int g = SkTPin(SkScalarFloorToInt(sumG * gain + bias), 0, a);
+    int b = SkTPin(SkScalarFloorToInt(sumB * gain + bias), 0, a);
+    if (!convolveAlpha) {
+        a = SkGetPackedA32(center);
+        return SkPreMultiplyARGB(a, r, g, b);
+    }
+    return SkPackARGB32(a, r, g, b);
+}
+
+// The interior fast paths convolve N neighboring pixels at a time, one channel per vector.
+static constexpr int kConvolveN = 8;
+
+template <int N>
+struct ConvolveChannels {
+    using V = skvx::Vec<N, float>;
+
+    static ConvolveChannels Load(const SkPMColor* src) {
+        auto px = skvx::Vec<N, uint32_t>::Load(src);
+        return {skvx::cast<float>((px >> SK_A32_SHIFT) & 0xff),
+                skvx::cast<float>((px >> SK_R32_SHIFT) & 0xff),
+                skvx::cast<float>((px >> SK_G32_SHIFT) & 0xff),
+                skvx::cast<float>((px >> SK_B32_SHIFT) & 0xff)};
+    }
+
+    // Adds each channel of c times k, as the scalar path does.
+    template <bool convolveAlpha>
+    void accumulate(const ConvolveChannels& c, SkScalar k) {
+        if (convolveAlpha) {
+            a += c.a * k;
+        }
+        r += c.r * k;
+        g += c.g * k;
+        b += c.b * k;
+    }
+
+    V a = 0, r = 0, g = 0, b = 0;
+};
+
+// Rows of interior pixels are split into bands of at least this many multiply-adds per channel,
+// which run in parallel on the default SkExecutor.
+static constexpr int64_t kMinWorkPerBand = 1 << 20;
+static constexpr int     kMaxBands       = 16;
+
 } // end namespace
 
 sk_sp<SkImageFilter> SkImageFilters::MatrixConvolution(const SkISize& kernelSize,
@@ -259,18 +335,8 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
                     sumB += SkGetPackedB32(s) * k;
                 }
             }
-            int a = convolveAlpha
-                  ? SkTPin(SkScalarFloorToInt(sumA * fGain + fBias), 0, 255)
-                  : 255;
-            int r = SkTPin(SkScalarFloorToInt(sumR * fGain + fBias), 0, a);
-            int g = SkTPin(SkScalarFloorToInt(sumG * fGain + fBias), 0, a);
-            int b = SkTPin(SkScalarFloorToInt(sumB * fGain + fBias), 0, a);
-            if (!convolveAlpha) {
-                a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
-                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
-            } else {
-                *dptr++ = SkPackARGB32(a, r, g, b);
-            }
+            SkPMColor center = convolveAlpha ? 0 : PixelFetcher::fetch(src, x, y, bounds);
+            *dptr++ = convolved_pixel<convolveAlpha>(sumA, sumR, sumG, sumB, fGain, fBias, center);
         }
     }
 }
@@ -288,6 +354,164 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
     }
 }
 
+void SkMatrixConvolutionImageFilter::separateKernel() {
+    const int w = fKernelSize.width(),
+              h = fKernelSize.height();
+    if (w < 2 || h < 2) {
+        return;
+    }
+
+    // Factor around the largest weight: the row through it, and its column scaled to 1 there.
+    int pivot = 0;
+    for (int i = 1; i < w * h; i++) {
+        if (SkScalarAbs(fKernel[i]) > SkScalarAbs(fKernel[pivot])) {
+            pivot = i;
+        }
+    }
+    const SkScalar maxWeight = fKernel[pivot];
+    if (maxWeight == 0 || !SkScalarIsFinite(maxWeight)) {
+        return;
+    }
+    const int pivotX = pivot % w,
+              pivotY = pivot / w;
+
+    SkAutoTArray<SkScalar> row(w), column(h);
+    for (int x = 0; x < w; x++) {
+        row[x] = fKernel[pivotY * w + x];
+    }
+    for (int y = 0; y < h; y++) {
+        column[y] = fKernel[y * w + pivotX] / maxWeight;
+    }
+
+    // The factors must reproduce every weight, up to float precision.
+    const SkScalar tolerance = SkScalarAbs(maxWeight) * 1e-6f;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (!(SkScalarAbs(column[y] * row[x] - fKernel[y * w + x]) <= tolerance)) {
+                return;
+            }
+        }
+    }
+    fKernelRow = std::move(row);
+    fKernelColumn = std::move(column);
+}
+
+template <bool convolveAlpha>
+void SkMatrixConvolutionImageFilter::filterInteriorDirect(const SkBitmap& src,
+                                                          SkBitmap* result,
+                                                          const SkIVector& offset,
+                                                          const SkIRect& rect) const {
+    auto convolve = [&](auto n, int x, int y, SkPMColor* dptr) {
+        constexpr int N = decltype(n)::value;
+        ConvolveChannels<N> sum;
+        for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
+            const SkPMColor* row = src.getAddr32(x - fKernelOffset.fX, y + cy - fKernelOffset.fY);
+            const SkScalar* k = fKernel + cy * fKernelSize.fWidth;
+            for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
+                sum.template accumulate<convolveAlpha>(ConvolveChannels<N>::Load(row + cx), k[cx]);
+            }
+        }
+        const SkPMColor* center = src.getAddr32(x, y);
+        for (int i = 0; i < N; i++) {
+            dptr[i] = convolved_pixel<convolveAlpha>(sum.a[i], sum.r[i], sum.g[i], sum.b[i],
+                                                     fGain, fBias, center[i]);
+        }
+    };
+
+    for (int y = rect.fTop; y < rect.fBottom; ++y) {
+        SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
+        int x = rect.fLeft;
+        for (; x + kConvolveN <= rect.fRight; x += kConvolveN, dptr += kConvolveN) {
+            convolve(std::integral_constant<int, kConvolveN>{}, x, y, dptr);
+        }
+        for (; x < rect.fRight; x++, dptr++) {
+            convolve(std::integral_constant<int, 1>{}, x, y, dptr);
+        }
+    }
+}
+
+template <bool convolveAlpha>
+void SkMatrixConvolutionImageFilter::filterInteriorSeparable(const SkBitmap& src,
+                                                             SkBitmap* result,
+                                                             const SkIVector& offset,
+                                                             const SkIRect& rect) const {
+    const int w = rect.width(),
+              kernelW = fKernelSize.fWidth,
+              kernelH = fKernelSize.fHeight;
+
+    // We convolve chunks of output rows at a time, to bound the memory we need for the rows of
+    // src under them convolved with fKernelRow. Row i of those is stored as planes of w floats
+    // for each channel: a, r, g, then b.
+    const int chunkRows = std::max(32, kernelH);
+    SkAutoTMalloc<float> horizontal((size_t)(chunkRows + kernelH - 1) * 4 * w);
+    auto plane = [&](int i, int channel) {
+        return horizontal.get() + ((size_t)i * 4 + channel) * w;
+    };
+
+    auto convolveRow = [&](auto n, int i, int y, int x) {
+        constexpr int N = decltype(n)::value;
+        ConvolveChannels<N> sum;
+        const SkPMColor* row = src.getAddr32(x - fKernelOffset.fX, y - fKernelOffset.fY);
+        for (int cx = 0; cx < kernelW; cx++) {
+            sum.template accumulate<convolveAlpha>(ConvolveChannels<N>::Load(row + cx),
+                                                   fKernelRow[cx]);
+        }
+        const int dx = x - rect.fLeft;
+        sum.a.store(plane(i, 0) + dx);
+        sum.r.store(plane(i, 1) + dx);
+        sum.g.store(plane(i, 2) + dx);
+        sum.b.store(plane(i, 3) + dx);
+    };
+
+    auto convolveColumn = [&](auto n, int i, int x, const SkPMColor* center, SkPMColor* dptr) {
+        constexpr int N = decltype(n)::value;
+        using V = typename ConvolveChannels<N>::V;
+        ConvolveChannels<N> sum;
+        const int dx = x - rect.fLeft;
+        for (int cy = 0; cy < kernelH; cy++) {
+            const SkScalar k = fKernelColumn[cy];
+            if (convolveAlpha) {
+                sum.a += V::Load(plane(i + cy, 0) + dx) * k;
+            }
+            sum.r += V::Load(plane(i + cy, 1) + dx) * k;
+            sum.g += V::Load(plane(i + cy, 2) + dx) * k;
+            sum.b += V::Load(plane(i + cy, 3) + dx) * k;
+        }
+        for (int j = 0; j < N; j++) {
+            dptr[j] = convolved_pixel<convolveAlpha>(sum.a[j], sum.r[j], sum.g[j], sum.b[j],
+                                                     fGain, fBias, center[j]);
+        }
+    };
+
+    for (int top = rect.fTop; top < rect.fBottom; top += chunkRows) {
+        const int bottom = std::min(top + chunkRows, rect.fBottom);
+
+        for (int i = 0; i < bottom - top + kernelH - 1; i++) {
+            int x = rect.fLeft;
+            for (; x + kConvolveN <= rect.fRight; x += kConvolveN) {
+                convolveRow(std::integral_constant<int, kConvolveN>{}, i, top + i, x);
+            }
+            for (; x < rect.fRight; x++) {
+                convolveRow(std::integral_constant<int, 1>{}, i, top + i, x);
+            }
+        }
+
+        for (int y = top; y < bottom; ++y) {
+            const SkPMColor* center = src.getAddr32(rect.fLeft, y);
+            SkPMColor* dptr = result->getAddr32(rect.fLeft - offset.fX, y - offset.fY);
+            int x = rect.fLeft;
+            for (; x + kConvolveN <= rect.fRight; x += kConvolveN) {
+                convolveColumn(std::integral_constant<int, kConvolveN>{}, y - top, x,
+                               center + (x - rect.fLeft), dptr + (x - rect.fLeft));
+            }
+            for (; x < rect.fRight; x++) {
+                convolveColumn(std::integral_constant<int, 1>{}, y - top, x,
+                               center + (x - rect.fLeft), dptr + (x - rect.fLeft));
+            }
+        }
+    }
+}
+
 void SkMatrixConvolutionImageFilter::filterInteriorPixels(const SkBitmap& src,
                                                           SkBitmap* result,
                                                           SkIVector& offset,
@@ -302,9 +526,21 @@ void SkMatrixConvolutionImageFilter::filterInteriorPixels(const SkBitmap& src,
             break;
         case SkTileMode::kClamp:
             // Fall through
-        case SkTileMode::kDecal:
-            filterPixels<UncheckedPixelFetcher>(src, result, offset, rect, bounds);
+        case SkTileMode::kDecal: {
+            SkIRect interior = rect;
+            if (!interior.intersect(bounds)) {
+                break;
+            }
+            const bool separable = fKernelRow.get() != nullptr;
+            if (fConvolveAlpha) {
+                separable ? this->filterInteriorSeparable<true>(src, result, offset, interior)
+                          : this->filterInteriorDirect<true>(src, result, offset, interior);
+            } else {
+                separable ? this->filterInteriorSeparable<false>(src, result, offset, interior)
+                          : this->filterInteriorDirect<false>(src, result, offset, interior);
+            }
             break;
+        }
     }
 }
 
@@ -466,7 +702,24 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(const Contex
 
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, top, srcBounds);
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, left, srcBounds);
-    this->filterInteriorPixels(inputBM, &dst, dstContentOffset, interior, srcBounds);
+    {
+        // Split the interior into bands of rows, each worth running on its own thread.
+        const int64_t work = (int64_t)interior.width() * interior.height() *
+                             (fKernelRow.get() ? fKernelSize.fWidth + fKernelSize.fHeight
+                                               : fKernelSize.fWidth * fKernelSize.fHeight);
+        const int bands = SkTPin((int)std::min<int64_t>(work / kMinWorkPerBand, kMaxBands),
+                                 1, std::max(interior.height(), 1));
+        const int rowsPerBand = (interior.height() + bands - 1) / bands;
+        auto filterBand = [&](int top, int bottom) {
+            SkIRect band = SkIRect::MakeLTRB(interior.left(), top, interior.right(), bottom);
+            this->filterInteriorPixels(inputBM, &dst, dstContentOffset, band, srcBounds);
+        };
+        if (bands == 1) {
+            filterBand(interior.top(), interior.bottom());
+        } else {
+            SkTaskGroup().parallel_for(interior.top(), interior.bottom(), rowsPerBand, filterBand);
+        }
+    }
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, right, srcBounds);
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, bottom, srcBounds);
 
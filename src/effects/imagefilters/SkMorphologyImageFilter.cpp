@@ -11,6 +11,7 @@
 #include "include/private/SkColorData.h"
 #include "include/private/SkVx.h"
 #include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkOpts.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkWriteBuffer.h"
@@ -31,10 +32,6 @@
 #include "src/gpu/ganesh/glsl/GrGLSLUniformHandler.h"
 #endif
 
-#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
-    #include <immintrin.h>
-#endif
-
 namespace {
 
 enum class MorphType {
@@ -57,16 +54,6 @@ public:
     SkIRect onFilterNodeBounds(const SkIRect& src, const SkMatrix& ctm,
                                MapDirection, const SkIRect* inputRect) const override;
 
-    /**
-     * All morphology procs have the same signature: src is the source buffer, dst the
-     * destination buffer, radius is the morphology radius, width and height are the bounds
-     * of the destination buffer (in pixels), and srcStride and dstStride are the
-     * number of pixels per row in each buffer. All buffers are 8888.
-     */
-
-    typedef void (*Proc)(const SkPMColor* src, SkPMColor* dst, int radius,
-                         int width, int height, int srcStride, int dstStride);
-
 protected:
     sk_sp<SkSpecialImage> onFilterImage(const Context&, SkIPoint* offset) const override;
     void flatten(SkWriteBuffer&) const override;
@@ -142,22 +129,61 @@ void SkMorphologyImageFilter::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static void call_proc_X(SkMorphologyImageFilter::Proc procX,
+/**
+ * All morphology procs have the same signature: src is the source buffer, dst the
+ * destination buffer, radius is the morphology radius, width and height are the bounds
+ * of the destination buffer (in pixels), and srcStride and dstStride are the
+ * number of pixels per row in each buffer. T is uint32_t for 8888 and uint8_t for A8.
+ */
+template <typename T>
+using MorphProc = void (*)(const T* src, T* dst, int radius,
+                           int width, int height, int srcStride, int dstStride);
+
+template <typename T>
+static void call_proc_X(MorphProc<T> procX,
                         const SkBitmap& src, SkBitmap* dst,
                         int radiusX, const SkIRect& bounds) {
-    procX(src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
+    procX(static_cast<const T*>(src.getAddr(bounds.left(), bounds.top())),
+          static_cast<T*>(dst->getAddr(0, 0)),
           radiusX, bounds.width(), bounds.height(),
           src.rowBytesAsPixels(), dst->rowBytesAsPixels());
 }
 
-static void call_proc_Y(SkMorphologyImageFilter::Proc procY,
-                        const SkPMColor* src, int srcRowBytesAsPixels, SkBitmap* dst,
+template <typename T>
+static void call_proc_Y(MorphProc<T> procY,
+                        const T* src, int srcRowBytesAsPixels, SkBitmap* dst,
                         int radiusY, const SkIRect& bounds) {
-    procY(src, dst->getAddr32(0, 0),
+    procY(src, static_cast<T*>(dst->getAddr(0, 0)),
           radiusY, bounds.height(), bounds.width(),
           srcRowBytesAsPixels, dst->rowBytesAsPixels());
 }
 
+// Dilates or erodes src into dst, which is srcBounds sized, first along X, then along Y.
+template <typename T>
+static bool morph_bitmap(MorphProc<T> procX, MorphProc<T> procY,
+                         const SkBitmap& src, const SkIRect& srcBounds,
+                         int radiusX, int radiusY, SkBitmap* dst) {
+    if (radiusX > 0 && radiusY > 0) {
+        SkBitmap tmp;
+        if (!tmp.tryAllocPixels(dst->info())) {
+            return false;
+        }
+
+        call_proc_X(procX, src, &tmp, radiusX, srcBounds);
+        SkIRect tmpBounds = SkIRect::MakeWH(srcBounds.width(), srcBounds.height());
+        call_proc_Y(procY,
+                    static_cast<const T*>(tmp.getAddr(tmpBounds.left(), tmpBounds.top())),
+                    tmp.rowBytesAsPixels(), dst, radiusY, tmpBounds);
+    } else if (radiusX > 0) {
+        call_proc_X(procX, src, dst, radiusX, srcBounds);
+    } else if (radiusY > 0) {
+        call_proc_Y(procY,
+                    static_cast<const T*>(src.getAddr(srcBounds.left(), srcBounds.top())),
+                    src.rowBytesAsPixels(), dst, radiusY, srcBounds);
+    }
+    return true;
+}
+
 SkRect SkMorphologyImageFilter::computeFastBounds(const SkRect& src) const {
     SkRect bounds = this->getInput(0) ? this->getInput(0)->computeFastBounds(src) : src;
     bounds.outset(fRadius.width(), fRadius.height());
@@ -504,121 +530,6 @@ static sk_sp<SkSpecialImage> apply_morphology(
 }
 #endif
 
-namespace {
-
-#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                __m128i extreme = (type == MorphType::kDilate) ? _mm_setzero_si128()
-                                                               : _mm_set1_epi32(0xFFFFFFFF);
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    __m128i src_pixel = _mm_cvtsi32_si128(*p);
-                    extreme = (type == MorphType::kDilate) ? _mm_max_epu8(src_pixel, extreme)
-                                                           : _mm_min_epu8(src_pixel, extreme);
-                }
-                *dptr = _mm_cvtsi128_si32(extreme);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
-            }
-            if (x >= radius) { src += srcStrideX; }
-            if (x + radius < width - 1) { upperSrc += srcStrideX; }
-            dst += dstStrideX;
-        }
-    }
-
-#elif defined(SK_ARM_HAS_NEON)
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                uint8x8_t extreme = vdup_n_u8(type == MorphType::kDilate ? 0 : 255);
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    uint8x8_t src_pixel = vreinterpret_u8_u32(vdup_n_u32(*p));
-                    extreme = (type == MorphType::kDilate) ? vmax_u8(src_pixel, extreme)
-                                                           : vmin_u8(src_pixel, extreme);
-                }
-                *dptr = vget_lane_u32(vreinterpret_u32_u8(extreme), 0);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
-            }
-            if (x >= radius) src += srcStrideX;
-            if (x + radius < width - 1) upperSrc += srcStrideX;
-            dst += dstStrideX;
-        }
-    }
-
-#else
-    template<MorphType type, MorphDirection direction>
-    static void morph(const SkPMColor* src, SkPMColor* dst,
-                      int radius, int width, int height, int srcStride, int dstStride) {
-        const int srcStrideX = direction == MorphDirection::kX ? 1 : srcStride;
-        const int dstStrideX = direction == MorphDirection::kX ? 1 : dstStride;
-        const int srcStrideY = direction == MorphDirection::kX ? srcStride : 1;
-        const int dstStrideY = direction == MorphDirection::kX ? dstStride : 1;
-        radius = std::min(radius, width - 1);
-        const SkPMColor* upperSrc = src + radius * srcStrideX;
-        for (int x = 0; x < width; ++x) {
-            const SkPMColor* lp = src;
-            const SkPMColor* up = upperSrc;
-            SkPMColor* dptr = dst;
-            for (int y = 0; y < height; ++y) {
-                // If we're maxing (dilate), start from 0; if minning (erode), start from 255.
-                const int start = (type == MorphType::kDilate) ? 0 : 255;
-                int B = start, G = start, R = start, A = start;
-                for (const SkPMColor* p = lp; p <= up; p += srcStrideX) {
-                    int b = SkGetPackedB32(*p),
-                        g = SkGetPackedG32(*p),
-                        r = SkGetPackedR32(*p),
-                        a = SkGetPackedA32(*p);
-                    if (type == MorphType::kDilate) {
-                        B = std::max(b, B);
-                        G = std::max(g, G);
-                        R = std::max(r, R);
-                        A = std::max(a, A);
-                    } else {
-                        B = std::min(b, B);
-                        G = std::min(g, G);
-                        R = std::min(r, R);
-                        A = std::min(a, A);
-                    }
-                }
-                *dptr = SkPackARGB32(A, R, G, B);
-                dptr += dstStrideY;
-                lp += srcStrideY;
-                up += srcStrideY;
-            }
-            if (x >= radius) { src += srcStrideX; }
-            if (x + radius < width - 1) { upperSrc += srcStrideX; }
-            dst += dstStrideX;
-        }
-    }
-#endif
-}  // namespace
-
 sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(const Context& ctx,
                                                              SkIPoint* offset) const {
     SkIPoint inputOffset = SkIPoint::Make(0, 0);
@@ -682,7 +593,7 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(const Context& ctx,
         return nullptr;
     }
 
-    if (inputBM.colorType() != kN32_SkColorType) {
+    if (inputBM.colorType() != kN32_SkColorType && inputBM.colorType() != kAlpha_8_SkColorType) {
         return nullptr;
     }
 
@@ -693,34 +604,19 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(const Context& ctx,
         return nullptr;
     }
 
-    SkMorphologyImageFilter::Proc procX, procY;
-
-    if (MorphType::kDilate == fType) {
-        procX = &morph<MorphType::kDilate, MorphDirection::kX>;
-        procY = &morph<MorphType::kDilate, MorphDirection::kY>;
+    const bool dilate = MorphType::kDilate == fType;
+    bool ok;
+    if (inputBM.colorType() == kAlpha_8_SkColorType) {
+        ok = morph_bitmap<uint8_t>(dilate ? SkOpts::dilate_x_A8 : SkOpts::erode_x_A8,
+                                   dilate ? SkOpts::dilate_y_A8 : SkOpts::erode_y_A8,
+                                   inputBM, srcBounds, width, height, &dst);
     } else {
-        procX = &morph<MorphType::kErode,  MorphDirection::kX>;
-        procY = &morph<MorphType::kErode,  MorphDirection::kY>;
+        ok = morph_bitmap<uint32_t>(dilate ? SkOpts::dilate_x_8888 : SkOpts::erode_x_8888,
+                                    dilate ? SkOpts::dilate_y_8888 : SkOpts::erode_y_8888,
+                                    inputBM, srcBounds, width, height, &dst);
     }
-
-    if (width > 0 && height > 0) {
-        SkBitmap tmp;
-        if (!tmp.tryAllocPixels(info)) {
-            return nullptr;
-        }
-
-        call_proc_X(procX, inputBM, &tmp, width, srcBounds);
-        SkIRect tmpBounds = SkIRect::MakeWH(srcBounds.width(), srcBounds.height());
-        call_proc_Y(procY,
-                    tmp.getAddr32(tmpBounds.left(), tmpBounds.top()), tmp.rowBytesAsPixels(),
-                    &dst, height, tmpBounds);
-    } else if (width > 0) {
-        call_proc_X(procX, inputBM, &dst, width, srcBounds);
-    } else if (height > 0) {
-        call_proc_Y(procY,
-                    inputBM.getAddr32(srcBounds.left(), srcBounds.top()),
-                    inputBM.rowBytesAsPixels(),
-                    &dst, height, srcBounds);
+    if (!ok) {
+        return nullptr;
     }
     offset->fX = bounds.left();
     offset->fY = bounds.top();
@@ -8,6 +8,7 @@
 #include <atomic>
 #include <cmath>
 #include "include/core/SkCanvas.h"
+#include "include/core/SkRegion.h"
 #include "src/core/SkAutoPixmapStorage.h"
 #include "src/core/SkImagePriv.h"
 #include "src/core/SkPaintPriv.h"
@@ -117,6 +118,10 @@ void SkSurface_Base::onAsyncRescaleAndReadPixelsYUV420(
     callback(context, nullptr);
 }
 
+void SkSurface_Base::onTakeDamage(SkRegion* damage) {
+    damage->setEmpty();
+}
+
 bool SkSurface_Base::outstandingImageSnapshot() const {
     return fCachedImage && !fCachedImage->unique();
 }
@@ -201,6 +206,14 @@ void SkSurface::notifyContentWillChange(ContentChangeMode mode) {
     sk_ignore_unused_variable(asSB(this)->aboutToDraw(mode));
 }
 
+bool SkSurface::enableDamageTracking(int tileSize) {
+    return tileSize > 0 && asSB(this)->onEnableDamageTracking(tileSize);
+}
+
+void SkSurface::takeDamage(SkRegion* damage) {
+    asSB(this)->onTakeDamage(damage);
+}
+
 SkCanvas* SkSurface::getCanvas() {
     return asSB(this)->getCachedCanvas();
 }
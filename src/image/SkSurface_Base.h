@@ -106,6 +106,12 @@ public:
      */
     virtual void onDiscard() {}
 
+    /**
+     *  Only raster surfaces track damage; see SkSurface::enableDamageTracking().
+     */
+    virtual bool onEnableDamageTracking(int tileSize) { return false; }
+    virtual void onTakeDamage(SkRegion* damage);
+
     /**
      *  If the surface is about to change, we call this so that our subclass
      *  can optionally fork their backend (copy-on-write) in case it was
@@ -7,7 +7,10 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkMallocPixelRef.h"
+#include "include/core/SkRegion.h"
 #include "include/private/SkImageInfoPriv.h"
+#include "src/core/SkBitmapDevice.h"
+#include "src/core/SkDamageTracker.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkImagePriv.h"
 #include "src/image/SkSurface_Base.h"
@@ -26,8 +29,12 @@ public:
     void onDraw(SkCanvas*, SkScalar, SkScalar, const SkSamplingOptions&, const SkPaint*) override;
     bool onCopyOnWrite(ContentChangeMode) override;
     void onRestoreBackingMutability() override;
+    bool onEnableDamageTracking(int tileSize) override;
+    void onTakeDamage(SkRegion*) override;
 
 private:
+    SkBitmapDevice* baseDevice();
+
     SkBitmap    fBitmap;
     bool        fWeOwnThePixels;
 
@@ -115,6 +122,28 @@ sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
 
 void SkSurface_Raster::onWritePixels(const SkPixmap& src, int x, int y) {
     fBitmap.writePixels(src, x, y);
+    if (SkDamageTracker* tracker = this->baseDevice()->fDamageTracker.get()) {
+        tracker->add(SkIRect::MakeXYWH(x, y, src.width(), src.height()));
+    }
+}
+
+SkBitmapDevice* SkSurface_Raster::baseDevice() {
+    // Our canvas is always backed by fBitmap, through an SkBitmapDevice.
+    return static_cast<SkBitmapDevice*>(this->getCachedCanvas()->baseDevice());
+}
+
+bool SkSurface_Raster::onEnableDamageTracking(int tileSize) {
+    this->baseDevice()->fDamageTracker =
+            std::make_unique<SkDamageTracker>(fBitmap.dimensions(), tileSize);
+    return true;
+}
+
+void SkSurface_Raster::onTakeDamage(SkRegion* damage) {
+    if (SkDamageTracker* tracker = this->baseDevice()->fDamageTracker.get()) {
+        tracker->takeDamage(damage);
+    } else {
+        damage->setEmpty();
+    }
 }
 
 void SkSurface_Raster::onRestoreBackingMutability() {
@@ -13,13 +13,18 @@
 #include "include/core/SkString.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/private/SkImageInfoPriv.h"
+#include "include/private/SkTo.h"
+#include "include/private/SkVx.h"
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/images/SkImageEncoderFns.h"
+#include <algorithm>
 #include <vector>
 
 #include <png.h>
+#include "zlib.h"
 
 static_assert(PNG_FILTER_NONE  == (int)SkPngEncoder::FilterFlag::kNone,  "Skia libpng filter err.");
 static_assert(PNG_FILTER_SUB   == (int)SkPngEncoder::FilterFlag::kSub,   "Skia libpng filter err.");
@@ -59,9 +64,15 @@ public:
     bool writeInfo(const SkImageInfo& srcInfo);
     void chooseProc(const SkImageInfo& srcInfo);
 
+    // Write image data we've filtered and compressed ourselves, then end the png.
+    bool writeIDAT(const void* data, size_t size);
+    bool writeEnd();
+
     png_structp pngPtr() { return fPngPtr; }
     png_infop infoPtr() { return fInfoPtr; }
     int pngBytesPerPixel() const { return fPngBytesPerPixel; }
+    int filters() const { return fFilters; }
+    int zlibLevel() const { return fZLibLevel; }
     transform_scanline_proc proc() const { return fProc; }
 
     ~SkPngEncoderMgr() {
@@ -78,6 +89,8 @@ private:
     png_structp             fPngPtr;
     png_infop               fInfoPtr;
     int                     fPngBytesPerPixel;
+    int                     fFilters;
+    int                     fZLibLevel;
     transform_scanline_proc fProc;
 };
 
@@ -197,10 +210,12 @@ bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::
     int filters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
     SkASSERT(filters == (int)options.fFilterFlags);
     png_set_filter(fPngPtr, PNG_FILTER_TYPE_BASE, filters);
+    fFilters = filters;
 
     int zlibLevel = std::min(std::max(0, options.fZLibLevel), 9);
     SkASSERT(zlibLevel == options.fZLibLevel);
     png_set_compression_level(fPngPtr, zlibLevel);
+    fZLibLevel = zlibLevel;
 
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
@@ -398,6 +413,364 @@ void SkPngEncoderMgr::chooseProc(const SkImageInfo& srcInfo) {
     fProc = choose_proc(srcInfo);
 }
 
+bool SkPngEncoderMgr::writeIDAT(const void* data, size_t size) {
+    if (setjmp(png_jmpbuf(fPngPtr))) {
+        return false;
+    }
+
+    png_write_chunk(fPngPtr, (png_const_bytep)"IDAT", (png_const_bytep)data, size);
+    return true;
+}
+
+bool SkPngEncoderMgr::writeEnd() {
+    if (setjmp(png_jmpbuf(fPngPtr))) {
+        return false;
+    }
+
+    // png_write_end() insists on libpng having compressed the IDATs itself.  It would only add
+    // chunks we haven't asked for anyway, so we write IEND directly.
+    png_write_chunk(fPngPtr, (png_const_bytep)"IEND", nullptr, 0);
+    return true;
+}
+
+// Filter types, in the order libpng tries them.  Each FilterFlag is (kNone << type).
+enum FilterType : int { kNone_FilterType, kSub_FilterType, kUp_FilterType,
+                        kAvg_FilterType, kPaeth_FilterType, kFilterTypeCount };
+
+static constexpr int filter_flag(int type) {
+    return (int)SkPngEncoder::FilterFlag::kNone << type;
+}
+
+// Filters N bytes of row with kType.  Each byte is predicted from the same byte of the pixel to
+// its left (a), above it in prev (b), and above and to the left (c).  row and prev must both be
+// preceded by bpp zeros, which stand in for the pixels left of the image.
+template <int kType, int N>
+SK_ALWAYS_INLINE static skvx::Vec<N,uint8_t> filter(const uint8_t row[], const uint8_t prev[],
+                                                    int bpp) {
+    using U8 = skvx::Vec<N,uint8_t>;
+    const U8 x = U8::Load(row);
+    if constexpr (kType == kNone_FilterType) {
+        return x;
+    } else if constexpr (kType == kSub_FilterType) {
+        return x - U8::Load(row - bpp);
+    } else if constexpr (kType == kUp_FilterType) {
+        return x - U8::Load(prev);
+    } else if constexpr (kType == kAvg_FilterType) {
+        const U8 a = U8::Load(row - bpp),
+                 b = U8::Load(prev);
+        return x - ((a & b) + ((a ^ b) >> 1));  // (a + b) / 2, without overflowing a byte.
+    } else {
+        // Paeth predicts whichever of a, b, and c is closest to a + b - c, preferring a, then b.
+        // Those distances are |b - c|, |a - c|, and |(a - c) + (b - c)|, which we can find
+        // without leaving bytes: when a - c and b - c have the same sign, the last is pa + pb
+        // (saturating is fine, as it's then no smaller than either), and otherwise |pa - pb|.
+        const U8 a = U8::Load(row - bpp),
+                 b = U8::Load(prev),
+                 c = U8::Load(prev - bpp);
+        auto absdiff = [](const U8& x, const U8& y) { return skvx::max(x, y) - skvx::min(x, y); };
+        const U8 pa = absdiff(b, c),
+                 pb = absdiff(a, c),
+                 pc = skvx::if_then_else((a >= c) == (b >= c),
+                                         pa + skvx::min(pb, U8(255) - pa),
+                                         absdiff(pa, pb));
+        return x - skvx::if_then_else((pa <= pb) & (pa <= pc), a,
+                                      skvx::if_then_else(pb <= pc, b, c));
+    }
+}
+
+template <int kType>
+static void filter_row(uint8_t dst[], const uint8_t row[], const uint8_t prev[],
+                       size_t rowBytes, int bpp) {
+    size_t i = 0;
+    for (; i + 16 <= rowBytes; i += 16) {
+        filter<kType,16>(row + i, prev + i, bpp).store(dst + i);
+    }
+    for (; i < rowBytes; i++) {
+        filter<kType,1>(row + i, prev + i, bpp).store(dst + i);
+    }
+}
+
+// libpng's guess at how well row will compress filtered with kType: the sum of the filtered
+// bytes' magnitudes, read as signed bytes.  With blockStep > 1 we only sum every blockStep'th
+// 16 bytes, which is usually enough to rank the filters.
+template <int kType>
+static size_t filtered_sum(const uint8_t row[], const uint8_t prev[], size_t rowBytes, int bpp,
+                           size_t blockStep) {
+    using U8  = skvx::Vec<16,uint8_t>;
+    using U16 = skvx::Vec<8,uint16_t>;
+
+    size_t sum = 0,
+           i   = 0;
+    while (i + 16 <= rowBytes) {
+        // Each block adds at most 2 * 128 to each 16-bit lane, so we total them every 128 blocks.
+        U16 lanes = 0;
+        for (int blocks = 0; blocks < 128 && i + 16 <= rowBytes; blocks++, i += 16 * blockStep) {
+            const U8 v = filter<kType,16>(row + i, prev + i, bpp);
+            const U16 magnitudes = skvx::bit_pun<U16>(skvx::min(v, U8(0) - v));
+            lanes += (magnitudes & 0xFF) + (magnitudes >> 8);
+        }
+        uint16_t totals[8];
+        lanes.store(totals);
+        for (uint16_t total : totals) {
+            sum += total;
+        }
+    }
+
+    // Short rows count in full, sampled or not.
+    if (blockStep == 1 || rowBytes < 16) {
+        for (i = rowBytes & ~(size_t)15; i < rowBytes; i++) {
+            const uint8_t v = filter<kType,1>(row + i, prev + i, bpp)[0];
+            sum += v < 128 ? v : 256 - v;
+        }
+    }
+    return sum;
+}
+
+static constexpr void (*kFilterRow[])(uint8_t[], const uint8_t[], const uint8_t[], size_t, int) = {
+    filter_row<kNone_FilterType>,
+    filter_row<kSub_FilterType>,
+    filter_row<kUp_FilterType>,
+    filter_row<kAvg_FilterType>,
+    filter_row<kPaeth_FilterType>,
+};
+
+static constexpr size_t (*kFilteredSum[])(const uint8_t[], const uint8_t[], size_t, int, size_t) = {
+    filtered_sum<kNone_FilterType>,
+    filtered_sum<kSub_FilterType>,
+    filtered_sum<kUp_FilterType>,
+    filtered_sum<kAvg_FilterType>,
+    filtered_sum<kPaeth_FilterType>,
+};
+
+// When sampling, we compare filters on one in this many blocks of 16 bytes.
+static constexpr size_t kSampleStep = 4;
+
+// Writes the filter type and then the filtered row to dst.  Given several filters, we pick the
+// first with the smallest filtered_sum() of the whole row, as libpng does, or of a sample of it.
+static void filter_row(int filters, bool sampled, uint8_t dst[], const uint8_t row[],
+                       const uint8_t prev[], size_t rowBytes, int bpp) {
+    int best = kNone_FilterType;
+    size_t bestSum = SIZE_MAX;
+    for (int type = 0; type < kFilterTypeCount; type++) {
+        if (!(filters & filter_flag(type))) {
+            continue;
+        }
+        if (filters == filter_flag(type)) {
+            best = type;
+            break;
+        }
+
+        size_t sum = kFilteredSum[type](row, prev, rowBytes, bpp, sampled ? kSampleStep : 1);
+        if (sum < bestSum) {
+            bestSum = sum;
+            best = type;
+        }
+    }
+    dst[0] = SkToU8(best);
+    kFilterRow[best](dst + 1, row, prev, rowBytes, bpp);
+}
+
+// Transforms rows [top, bottom) of src to libpng's format, then filters them into dst, one
+// filter type and rowBytes filtered bytes per row.
+static void filter_rows(SkPngEncoderMgr* mgr, const SkPixmap& src, int filters, bool sampled,
+                        int top, int bottom, uint8_t dst[]) {
+    const int    width    = src.width(),
+                 bpp      = mgr->pngBytesPerPixel();
+    const size_t rowBytes = (size_t)bpp * width;
+
+    // The current and previous rows, each preceded by bpp zeros for the filters' left edge.
+    // The previous row of the first row of the image is all zeros too.
+    std::vector<uint8_t> rows(2 * (bpp + rowBytes), 0);
+    uint8_t* prev = rows.data() + bpp;
+    uint8_t* row  = prev + rowBytes + bpp;
+
+    auto transform = [&](uint8_t* dstRow, int y) {
+        const void* srcRow = src.addr(0, y);
+        sk_msan_assert_initialized(srcRow,
+                                   (const uint8_t*)srcRow + (width << src.shiftPerPixel()));
+        mgr->proc()((char*)dstRow, (const char*)srcRow, width,
+                    SkColorTypeBytesPerPixel(src.colorType()));
+    };
+    if (top > 0) {
+        transform(prev, top - 1);
+    }
+    for (int y = top; y < bottom; y++) {
+        transform(row, y);
+        filter_row(filters, sampled, dst, row, prev, rowBytes, bpp);
+        dst += rowBytes + 1;
+        std::swap(row, prev);
+    }
+}
+
+// Compresses size bytes of data onto the end of out, which grows as needed.  flush is passed
+// along to deflate().
+static bool deflate_into(z_stream* z, const uint8_t* data, size_t size, int flush,
+                         std::vector<uint8_t>* out) {
+    z->next_in  = const_cast<uint8_t*>(data);
+    z->avail_in = SkToUInt(size);
+
+    size_t written = out->size();
+    out->resize(written + deflateBound(z, size) + 16);  // Room for a sync flush, too.
+    int result;
+    do {
+        if (written == out->size()) {
+            out->resize(2 * out->size());
+        }
+        z->next_out  = out->data() + written;
+        z->avail_out = SkToUInt(out->size() - written);
+        result = deflate(z, flush);
+        written = out->size() - z->avail_out;
+    } while (result == Z_OK && z->avail_out == 0);
+    out->resize(written);
+
+    // If a deflate() exactly filled the buffer, the next had nothing left to do.
+    return flush == Z_FINISH ? result == Z_STREAM_END
+                             : (result == Z_OK || result == Z_BUF_ERROR) && z->avail_in == 0;
+}
+
+// Like pigz, we deflate strips of about this many filtered bytes independently.  Each strip but
+// the last ends with a sync flush, so their outputs concatenate into a single zlib stream.
+// Serially, we filter and compress a strip at a time.
+static constexpr size_t kStripBytes = 128 * 1024;
+
+// Deflate never looks back further than this, so it's all of the preceding rows a strip needs
+// as its dictionary to compress as well as a serial encode.
+static constexpr size_t kWindowBytes = 32 * 1024;
+
+static int rows_per_strip(size_t filteredRowBytes) {
+    return SkToInt(std::max<size_t>(1, kStripBytes / filteredRowBytes));
+}
+
+// Returns true if we can filter and compress src ourselves, writing libpng's rows unchanged.
+static bool can_filter_rows(SkPngEncoderMgr* mgr, const SkPixmap& src) {
+    // Not so when libpng strips filler bytes from our rows.
+    return mgr->proc() &&
+           png_get_rowbytes(mgr->pngPtr(), mgr->infoPtr()) ==
+                   (size_t)mgr->pngBytesPerPixel() * src.width();
+}
+
+static bool has_several_strips(SkPngEncoderMgr* mgr, const SkPixmap& src) {
+    return src.height() > rows_per_strip((size_t)mgr->pngBytesPerPixel() * src.width() + 1);
+}
+
+// Filters and compresses src's rows ourselves, in parallel strips if given an executor.
+static bool encode_filtered(SkPngEncoderMgr* mgr, const SkPixmap& src, SkExecutor* executor,
+                            bool sampled) {
+    const int    width    = src.width(),
+                 height   = src.height();
+    const size_t stride   = (size_t)mgr->pngBytesPerPixel() * width + 1;  // With filter type.
+
+    // As in libpng, filters that need pixels we don't have only see zeros, so we drop them.
+    int filters = mgr->filters();
+    if (height == 1) {
+        filters &= ~(int)(SkPngEncoder::FilterFlag::kUp  |
+                          SkPngEncoder::FilterFlag::kAvg |
+                          SkPngEncoder::FilterFlag::kPaeth);
+    }
+    if (width == 1) {
+        filters &= ~(int)(SkPngEncoder::FilterFlag::kSub |
+                          SkPngEncoder::FilterFlag::kAvg |
+                          SkPngEncoder::FilterFlag::kPaeth);
+    }
+    if (filters == 0) {
+        filters = (int)SkPngEncoder::FilterFlag::kNone;
+    }
+    const int level    = mgr->zlibLevel(),
+              strategy = filters == (int)SkPngEncoder::FilterFlag::kNone ? Z_DEFAULT_STRATEGY
+                                                                          : Z_FILTERED;
+
+    const int rowsPerStrip = rows_per_strip(stride),
+              stripCount   = (height + rowsPerStrip - 1) / rowsPerStrip;
+
+    if (!executor) {
+        z_stream z = {};
+        if (Z_OK != deflateInit2(&z, level, Z_DEFLATED, MAX_WBITS, 8, strategy)) {
+            return false;
+        }
+
+        std::vector<uint8_t> filtered(rowsPerStrip * stride),
+                             out;
+        bool ok = true;
+        for (int top = 0; ok && top < height; top += rowsPerStrip) {
+            const int bottom = std::min(top + rowsPerStrip, height);
+            filter_rows(mgr, src, filters, sampled, top, bottom, filtered.data());
+
+            out.clear();
+            ok = deflate_into(&z, filtered.data(), (bottom - top) * stride,
+                              bottom == height ? Z_FINISH : Z_NO_FLUSH, &out) &&
+                 (out.empty() || mgr->writeIDAT(out.data(), out.size()));
+        }
+        deflateEnd(&z);
+        return ok && mgr->writeEnd();
+    }
+
+    const int dictRows = SkToInt((kWindowBytes + stride - 1) / stride);
+
+    std::vector<std::vector<uint8_t>> idats(stripCount);
+    std::vector<uLong>                adlers(stripCount);
+
+    auto encode_strip = [&](int strip) {
+        const int top    = strip * rowsPerStrip,
+                  bottom = std::min(top + rowsPerStrip, height),
+                  first  = std::max(0, top - dictRows);
+
+        // Filter this strip's rows, and enough rows above it to fill deflate's window.
+        std::vector<uint8_t> filtered((bottom - first) * stride);
+        filter_rows(mgr, src, filters, sampled, first, bottom, filtered.data());
+
+        const uint8_t* data = filtered.data() + (top - first) * stride;
+        const size_t   size = (bottom - top) * stride,
+                   dictSize = std::min(kWindowBytes, (top - first) * stride);
+        adlers[strip] = adler32(adler32(0, nullptr, 0), data, SkToUInt(size));
+
+        // A raw deflate stream, so the strips can be concatenated.
+        z_stream z = {};
+        if (Z_OK != deflateInit2(&z, level, Z_DEFLATED, -MAX_WBITS, 8, strategy)) {
+            return false;
+        }
+        bool ok = (dictSize == 0 ||
+                   Z_OK == deflateSetDictionary(&z, data - dictSize, SkToUInt(dictSize))) &&
+                  deflate_into(&z, data, size,
+                               strip == stripCount - 1 ? Z_FINISH : Z_SYNC_FLUSH, &idats[strip]);
+        deflateEnd(&z);
+        return ok;
+    };
+
+    bool ok = SkTaskGroup(*executor).parallel_for(0, stripCount, 1, [&](int begin, int end) {
+        for (int strip = begin; strip < end; strip++) {
+            if (!encode_strip(strip)) {
+                return false;
+            }
+        }
+        return true;
+    });
+    if (!ok) {
+        return false;
+    }
+
+    // Wrap the strips up as one zlib stream: a header (a 32K window, and roughly how hard we
+    // tried), and the adler32 of all the filtered rows, combined from each strip's.
+    const uint8_t cmf = 0x78;
+    uint8_t flg = (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6;
+    flg += 31 - ((cmf << 8) + flg) % 31;
+    idats.front().insert(idats.front().begin(), {cmf, flg});
+
+    uLong adler = adler32(0, nullptr, 0);
+    for (int strip = 0; strip < stripCount; strip++) {
+        const int rows = std::min(rowsPerStrip, height - strip * rowsPerStrip);
+        adler = adler32_combine(adler, adlers[strip], (z_off_t)(rows * stride));
+    }
+    idats.back().insert(idats.back().end(), {(uint8_t)(adler >> 24), (uint8_t)(adler >> 16),
+                                             (uint8_t)(adler >>  8), (uint8_t)(adler >>  0)});
+
+    for (const std::vector<uint8_t>& idat : idats) {
+        if (!mgr->writeIDAT(idat.data(), idat.size())) {
+            return false;
+        }
+    }
+    return mgr->writeEnd();
+}
+
 std::unique_ptr<SkEncoder> SkPngEncoder::Make(SkWStream* dst, const SkPixmap& src,
                                               const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -462,7 +835,22 @@ bool SkPngEncoder::onEncodeRows(int numRows) {
 
 bool SkPngEncoder::Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
     auto encoder = SkPngEncoder::Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    if (!encoder) {
+        return false;
+    }
+
+    const bool ownFilters = options.fFilterHeuristic != FilterHeuristic::kLibpng;
+    if (options.fExecutor || ownFilters) {
+        SkPngEncoderMgr* mgr = static_cast<SkPngEncoder*>(encoder.get())->fEncoderMgr.get();
+        if (can_filter_rows(mgr, src)) {
+            SkExecutor* executor = has_several_strips(mgr, src) ? options.fExecutor : nullptr;
+            if (executor || ownFilters) {
+                return encode_filtered(mgr, src, executor,
+                                       options.fFilterHeuristic == FilterHeuristic::kSampledMinSum);
+            }
+        }
+    }
+    return encoder->encodeRows(src.height());
 }
 
 #endif
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipmap_opts_DEFINED
+#define SkMipmap_opts_DEFINED
+
+#include "include/private/SkVx.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// These box filter two rows of src into one row of count dst pixels, the common case of building
+// a mip level from a level with even dimensions. They produce exactly the same pixels as the
+// portable downsample_2_2<> in SkMipmap.cpp.
+
+namespace SK_OPTS_NS {
+
+#if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    static constexpr int kDownsampleN = 8;
+#else
+    static constexpr int kDownsampleN = 4;
+#endif
+
+// Each 64-bit lane holds a horizontal pair of 8888 pixels. We spread their channels out into
+// 16-bit fields, add the two rows, then add the top and bottom halves of the lane to sum each
+// 2x2 block. Every sum is at most 4*255, so no field ever carries into its neighbor.
+template <int N>
+static skvx::Vec<N,uint32_t> box_2_2_8888(const skvx::Vec<N,uint64_t>& p0,
+                                          const skvx::Vec<N,uint64_t>& p1) {
+    const uint64_t mask = 0x00ff00ff'00ff00ff;
+    skvx::Vec<N,uint64_t> rb = (p0 & mask) + (p1 & mask),
+                          ga = ((p0 >> 8) & mask) + ((p1 >> 8) & mask);
+    rb = ((rb + (rb >> 32)) >> 2) & 0x00ff00ff;
+    ga = ((ga + (ga >> 32)) >> 2) & 0x00ff00ff;
+    return skvx::cast<uint32_t>(rb | (ga << 8));
+}
+
+// Each 16-bit lane holds a horizontal pair of 8-bit pixels.
+template <int N>
+static skvx::Vec<N,uint8_t> box_2_2_A8(const skvx::Vec<N,uint16_t>& p0,
+                                       const skvx::Vec<N,uint16_t>& p1) {
+    auto sum = (p0 & 0xff) + (p0 >> 8) + (p1 & 0xff) + (p1 >> 8);
+    return skvx::cast<uint8_t>(sum >> 2);
+}
+
+// Half <-> float conversions that round exactly like SkHalfToFloat_finite_ftz() and
+// SkFloatToHalf_finite_ftz(), which the portable code uses.
+template <int N>
+static skvx::Vec<N,float> half_to_float(const skvx::Vec<N,uint16_t>& h) {
+#if !defined(SKNX_NO_SIMD) && defined(SK_CPU_ARM64)
+    return skvx::from_half(h);
+#else
+    skvx::Vec<N,int32_t> bits     = skvx::cast<int32_t>(h),
+                         sign     = bits & 0x00008000,
+                         positive = bits ^ sign,
+                         is_norm  = 0x03ff < positive,
+                         norm     = (positive << 13) + ((127 - 15) << 23);
+    return skvx::bit_pun<skvx::Vec<N,float>>((sign << 16) | (norm & is_norm));
+#endif
+}
+
+template <int N>
+static skvx::Vec<N,uint16_t> float_to_half(const skvx::Vec<N,float>& f) {
+#if !defined(SKNX_NO_SIMD) && defined(SK_CPU_ARM64)
+    return skvx::to_half(f);
+#else
+    skvx::Vec<N,int32_t> bits         = skvx::bit_pun<skvx::Vec<N,int32_t>>(f),
+                         sign         = bits & (int32_t)0x80000000,
+                         positive     = bits ^ sign,
+                         will_be_norm = 0x387fdfff < positive,
+                         norm         = (positive - ((127 - 15) << 23)) >> 13;
+    return skvx::cast<uint16_t>((sign >> 16) | (will_be_norm & norm));
+#endif
+}
+
+/*not static*/ inline void downsample_2_2_8888(void* dst, const void* src, size_t srcRB,
+                                                int count) {
+    auto p0 = static_cast<const uint32_t*>(src);
+    auto p1 = (const uint32_t*)((const char*)p0 + srcRB);
+    auto d  = static_cast<uint32_t*>(dst);
+
+    constexpr int N = kDownsampleN;
+    for (; count >= N; count -= N) {
+        box_2_2_8888(skvx::Vec<N,uint64_t>::Load(p0),
+                     skvx::Vec<N,uint64_t>::Load(p1)).store(d);
+        p0 += 2*N;
+        p1 += 2*N;
+        d  += N;
+    }
+    for (; count > 0; count--) {
+        box_2_2_8888(skvx::Vec<1,uint64_t>::Load(p0),
+                     skvx::Vec<1,uint64_t>::Load(p1)).store(d);
+        p0 += 2;
+        p1 += 2;
+        d  += 1;
+    }
+}
+
+/*not static*/ inline void downsample_2_2_A8(void* dst, const void* src, size_t srcRB,
+                                              int count) {
+    auto p0 = static_cast<const uint8_t*>(src);
+    auto p1 = p0 + srcRB;
+    auto d  = static_cast<uint8_t*>(dst);
+
+    constexpr int N = 4*kDownsampleN;
+    for (; count >= N; count -= N) {
+        box_2_2_A8(skvx::Vec<N,uint16_t>::Load(p0),
+                   skvx::Vec<N,uint16_t>::Load(p1)).store(d);
+        p0 += 2*N;
+        p1 += 2*N;
+        d  += N;
+    }
+    for (; count > 0; count--) {
+        box_2_2_A8(skvx::Vec<1,uint16_t>::Load(p0),
+                   skvx::Vec<1,uint16_t>::Load(p1)).store(d);
+        p0 += 2;
+        p1 += 2;
+        d  += 1;
+    }
+}
+
+/*not static*/ inline void downsample_2_2_F16(void* dst, const void* src, size_t srcRB,
+                                               int count) {
+    auto p0 = static_cast<const uint64_t*>(src);
+    auto p1 = (const uint64_t*)((const char*)p0 + srcRB);
+    auto d  = static_cast<uint64_t*>(dst);
+
+    // Two dst pixels at a time: split each row into its even and odd pixels, 8 halfs apiece.
+    auto even = [](const skvx::Vec<4,uint64_t>& px) {
+        return half_to_float(skvx::bit_pun<skvx::Vec<8,uint16_t>>(skvx::shuffle<0,2>(px)));
+    };
+    auto odd = [](const skvx::Vec<4,uint64_t>& px) {
+        return half_to_float(skvx::bit_pun<skvx::Vec<8,uint16_t>>(skvx::shuffle<1,3>(px)));
+    };
+    for (; count >= 2; count -= 2) {
+        auto r0 = skvx::Vec<4,uint64_t>::Load(p0),
+             r1 = skvx::Vec<4,uint64_t>::Load(p1);
+        // Same order of operations as the portable code, so we round identically.
+        auto c = even(r0) + even(r1) + odd(r0) + odd(r1);
+        float_to_half(c * 0.25f).store(d);
+        p0 += 4;
+        p1 += 4;
+        d  += 2;
+    }
+    if (count > 0) {
+        auto c00 = half_to_float(skvx::Vec<4,uint16_t>::Load(p0 + 0)),
+             c01 = half_to_float(skvx::Vec<4,uint16_t>::Load(p0 + 1)),
+             c10 = half_to_float(skvx::Vec<4,uint16_t>::Load(p1 + 0)),
+             c11 = half_to_float(skvx::Vec<4,uint16_t>::Load(p1 + 1));
+        float_to_half((c00 + c10 + c01 + c11) * 0.25f).store(d);
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMipmap_opts_DEFINED
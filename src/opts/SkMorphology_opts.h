@@ -0,0 +1,186 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMorphology_opts_DEFINED
+#define SkMorphology_opts_DEFINED
+
+#include "include/private/SkTemplates.h"
+#include "include/private/SkVx.h"
+
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Dilate (erode) sets each pixel to the per-channel max (min) of the pixels within radius of it
+// along one line, clamping the window to the ends of the line. These use the van Herk/Gil-Werman
+// algorithm: split the line into blocks of 2*radius+1 pixels and take running maxes forward and
+// backward within each block. Every window then spans at most two blocks, so each pixel costs
+// the same three max ops no matter how big radius is. Max and min are exact, so the results match
+// scanning the whole window bit for bit.
+//
+// All procs have the same signature as SkMorphologyImageFilter's: width is the length of each
+// line, height the number of lines, and strides are in pixels. The _x procs work along rows, the
+// _y procs along columns. We process kMorphologyBytes/sizeof(pixel) lines at once, one pixel of
+// each line per vector, which for the _y procs are just neighboring pixels in a row.
+
+namespace SK_OPTS_NS {
+
+#if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    static constexpr int kMorphologyBytes = 32;
+#else
+    static constexpr int kMorphologyBytes = 16;
+#endif
+
+enum class MorphologyOp { kDilate, kErode };
+
+// Morphs lines [0, N) of src into dst. along is the stride between the pixels of a line, across
+// the stride between the lines. Each vector holds pixel i of all N lines, a byte per channel.
+template <MorphologyOp op, typename T, int N>
+static void morph_lines(const T* src, T* dst, int radius, int width,
+                        int srcAlong, int srcAcross, int dstAlong, int dstAcross,
+                        uint8_t* scratch) {
+    using V = skvx::Vec<N * (int)sizeof(T), uint8_t>;
+
+    auto load = [&](int i) {
+        const T* p = src + (ptrdiff_t)i * srcAlong;
+        if (srcAcross == 1) {
+            return V::Load(p);
+        }
+        T px[N];
+        for (int j = 0; j < N; j++) {
+            px[j] = p[j * srcAcross];
+        }
+        return V::Load(px);
+    };
+    auto store = [&](int i, const V& v) {
+        T* p = dst + (ptrdiff_t)i * dstAlong;
+        if (dstAcross == 1) {
+            v.store(p);
+            return;
+        }
+        T px[N];
+        v.store(px);
+        for (int j = 0; j < N; j++) {
+            p[j * dstAcross] = px[j];
+        }
+    };
+    auto combine = [](const V& a, const V& b) {
+        return op == MorphologyOp::kDilate ? skvx::max(a, b) : skvx::min(a, b);
+    };
+
+    // prefix[i] combines pixels from the start of i's block through i, and suffix[i] combines
+    // pixels from i through the end of i's block. The last block may be short.
+    uint8_t* prefix = scratch;
+    uint8_t* suffix = scratch + width * sizeof(V);
+    auto get = [](const uint8_t* buf, int i) { return V::Load(buf + i * sizeof(V)); };
+    auto put = [](uint8_t* buf, int i, const V& v) { v.store(buf + i * sizeof(V)); };
+
+    const int window = 2 * radius + 1;
+    for (int start = 0; start < width; start += window) {
+        const int end = std::min(start + window, width);
+        V run = load(start);
+        put(prefix, start, run);
+        put(suffix, start, run);
+        for (int i = start + 1; i < end; i++) {
+            V px = load(i);
+            put(suffix, i, px);
+            run = combine(run, px);
+            put(prefix, i, run);
+        }
+        run = get(suffix, end - 1);
+        for (int i = end - 2; i >= start; i--) {
+            run = combine(run, get(suffix, i));
+            put(suffix, i, run);
+        }
+    }
+
+    // Windows near the start of the line are clamped to begin at 0, inside the first block.
+    int x = 0;
+    for (; x < radius; x++) {
+        store(x, get(prefix, std::min(x + radius, width - 1)));
+    }
+    // Full windows span the end of one block and the start of the next, or exactly one block.
+    for (; x < width - radius; x++) {
+        store(x, combine(get(suffix, x - radius), get(prefix, x + radius)));
+    }
+    // Windows near the end of the line are clamped to end at width-1, which may or may not be in
+    // the same block as the start of the window.
+    const int lastBlock = (width - 1) / window * window;
+    for (; x < width; x++) {
+        const int lo = x - radius;
+        store(x, lo >= lastBlock ? get(suffix, lo)
+                                 : combine(get(suffix, lo), get(prefix, width - 1)));
+    }
+}
+
+template <MorphologyOp op, bool alongX, typename T>
+static void morph(const T* src, T* dst, int radius, int width, int height,
+                  int srcStride, int dstStride) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    radius = std::min(radius, width - 1);
+
+    const int srcAlong  = alongX ? 1 : srcStride,
+              srcAcross = alongX ? srcStride : 1,
+              dstAlong  = alongX ? 1 : dstStride,
+              dstAcross = alongX ? dstStride : 1;
+
+    constexpr int N = kMorphologyBytes / sizeof(T);
+    SkAutoTMalloc<uint8_t> scratch(2 * (size_t)width * kMorphologyBytes);
+
+    int line = 0;
+    for (; line + N <= height; line += N) {
+        morph_lines<op, T, N>(src + (ptrdiff_t)line * srcAcross, dst + (ptrdiff_t)line * dstAcross,
+                              radius, width, srcAlong, srcAcross, dstAlong, dstAcross,
+                              scratch.get());
+    }
+    for (; line < height; line++) {
+        morph_lines<op, T, 1>(src + (ptrdiff_t)line * srcAcross, dst + (ptrdiff_t)line * dstAcross,
+                              radius, width, srcAlong, srcAcross, dstAlong, dstAcross,
+                              scratch.get());
+    }
+}
+
+/*not static*/ inline void dilate_x_8888(const uint32_t* src, uint32_t* dst, int radius,
+                                         int width, int height, int srcStride, int dstStride) {
+    morph<MorphologyOp::kDilate, true>(src, dst, radius, width, height, srcStride, dstStride);
+}
+/*not static*/ inline void dilate_y_8888(const uint32_t* src, uint32_t* dst, int radius,
+                                         int width, int height, int srcStride, int dstStride) {
+    morph<MorphologyOp::kDilate, false>(src, dst, radius, width, height, srcStride, dstStride);
+}
+/*not static*/ inline void erode_x_8888(const uint32_t* src, uint32_t* dst, int radius,
+                                        int width, int height, int srcStride, int dstStride) {
+    morph<MorphologyOp::kErode, true>(src, dst, radius, width, height, srcStride, dstStride);
+}
+/*not static*/ inline void erode_y_8888(const uint32_t* src, uint32_t* dst, int radius,
+                                        int width, int height, int srcStride, int dstStride) {
+    morph<MorphologyOp::kErode, false>(src, dst, radius, width, height, srcStride, dstStride);
+}
+
+/*not static*/ inline void dilate_x_A8(const uint8_t* src, uint8_t* dst, int radius,
+                                       int width, int height, int srcStride, int dstStride) {
+    morph<MorphologyOp::kDilate, true>(src, dst, radius, width, height, srcStride, dstStride);
+}
+/*not static*/ inline void dilate_y_A8(const uint8_t* src, uint8_t* dst, int radius,
+                                       int width, int height, int srcStride, int dstStride) {
+    morph<MorphologyOp::kDilate, false>(src, dst, radius, width, height, srcStride, dstStride);
+}
+/*not static*/ inline void erode_x_A8(const uint8_t* src, uint8_t* dst, int radius,
+                                      int width, int height, int srcStride, int dstStride) {
+    morph<MorphologyOp::kErode, true>(src, dst, radius, width, height, srcStride, dstStride);
+}
+/*not static*/ inline void erode_y_A8(const uint8_t* src, uint8_t* dst, int radius,
+                                      int width, int height, int srcStride, int dstStride) {
+    morph<MorphologyOp::kErode, false>(src, dst, radius, width, height, srcStride, dstStride);
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMorphology_opts_DEFINED
@@ -11,6 +11,8 @@
 #include "src/core/SkCubicSolver.h"
 #include "src/opts/SkBitmapProcState_opts.h"
 #include "src/opts/SkBlitRow_opts.h"
+#include "src/opts/SkMipmap_opts.h"
+#include "src/opts/SkMorphology_opts.h"
 #include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkSwizzler_opts.h"
 #include "src/opts/SkUtils_opts.h"
@@ -25,12 +27,30 @@ namespace SkOpts {
 
         cubic_solver = SK_OPTS_NS::cubic_solver;
 
+        downsample_2_2_8888 = SK_OPTS_NS::downsample_2_2_8888;
+        downsample_2_2_F16  = SK_OPTS_NS::downsample_2_2_F16;
+        downsample_2_2_A8   = SK_OPTS_NS::downsample_2_2_A8;
+
+        dilate_x_8888 = SK_OPTS_NS::dilate_x_8888;
+        dilate_y_8888 = SK_OPTS_NS::dilate_y_8888;
+        erode_x_8888  = SK_OPTS_NS::erode_x_8888;
+        erode_y_8888  = SK_OPTS_NS::erode_y_8888;
+        dilate_x_A8   = SK_OPTS_NS::dilate_x_A8;
+        dilate_y_A8   = SK_OPTS_NS::dilate_y_A8;
+        erode_x_A8    = SK_OPTS_NS::erode_x_A8;
+        erode_y_A8    = SK_OPTS_NS::erode_y_A8;
+
         RGBA_to_BGRA          = SK_OPTS_NS::RGBA_to_BGRA;
         RGBA_to_rgbA          = SK_OPTS_NS::RGBA_to_rgbA;
         RGBA_to_bgrA          = SK_OPTS_NS::RGBA_to_bgrA;
         gray_to_RGB1          = SK_OPTS_NS::gray_to_RGB1;
         grayA_to_RGBA         = SK_OPTS_NS::grayA_to_RGBA;
         grayA_to_rgbA         = SK_OPTS_NS::grayA_to_rgbA;
+        RGBA16_to_RGBA        = SK_OPTS_NS::RGBA16_to_RGBA;
+        RGBA16_to_BGRA        = SK_OPTS_NS::RGBA16_to_BGRA;
+        RGBA16_to_rgbA        = SK_OPTS_NS::RGBA16_to_rgbA;
+        RGBA16_to_bgrA        = SK_OPTS_NS::RGBA16_to_bgrA;
+        index_to_8888         = SK_OPTS_NS::index_to_8888;
         inverted_CMYK_to_RGB1 = SK_OPTS_NS::inverted_CMYK_to_RGB1;
         inverted_CMYK_to_BGR1 = SK_OPTS_NS::inverted_CMYK_to_BGR1;
 
@@ -40,12 +60,20 @@ namespace SkOpts {
         start_pipeline_highp = SK_OPTS_NS::start_pipeline;
     #undef M
 
+    #define M(st, ...) fused_stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
+        SK_RASTER_PIPELINE_FUSED_STAGES(M)
+    #undef M
+
     #define M(st) stages_lowp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::lowp::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_lowp = (StageFn)SK_OPTS_NS::lowp::just_return;
         start_pipeline_lowp = SK_OPTS_NS::lowp::start_pipeline;
     #undef M
 
+    #define M(st, ...) fused_stages_lowp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::lowp::st;
+        SK_RASTER_PIPELINE_FUSED_STAGES(M)
+    #undef M
+
         interpret_skvm = SK_OPTS_NS::interpret_skvm;
     }
 }  // namespace SkOpts
@@ -13,6 +13,7 @@
 #include "include/third_party/skcms/skcms.h"
 #include "src/core/SkUtils.h"  // unaligned_{load,store}
 #include <cstdint>
+#include <type_traits>
 
 // Every function in this file should be marked static and inline using SI.
 #if defined(__clang__)
@@ -2910,6 +2911,38 @@ STAGE(swizzle, void* ctx) {
     }
 }
 
+// ~~~~~~ Fused stages ~~~~~~ //
+
+// A fused stage runs the kernels of a whole run of stages from one stage function. Each kernel
+// pulls its own context off the program just as its stage would have, so the program for a fused
+// stage is simply the contexts of its run, in order.
+#define SK_FUSED_KERNELS_2(a,b)     a##_k, b##_k
+#define SK_FUSED_KERNELS_3(a,b,c)   a##_k, b##_k, c##_k
+#define SK_FUSED_KERNELS_4(a,b,c,d) a##_k, b##_k, c##_k, d##_k
+
+#if JUMPER_NARROW_STAGES
+    template <auto... kernels>
+    static void ABI fused(Params* params, void** program, F r, F g, F b, F a) {
+        (kernels(Ctx{program}, params->dx,params->dy,params->tail, r,g,b,a,
+                 params->dr, params->dg, params->db, params->da), ...);
+        auto next = (Stage)load_and_inc(program);
+        next(params,program, r,g,b,a);
+    }
+#else
+    template <auto... kernels>
+    static void ABI fused(size_t tail, void** program, size_t dx, size_t dy,
+                          F r, F g, F b, F a, F dr, F dg, F db, F da) {
+        (kernels(Ctx{program}, dx,dy,tail, r,g,b,a, dr,dg,db,da), ...);
+        auto next = (Stage)load_and_inc(program);
+        next(tail,program,dx,dy, r,g,b,a, dr,dg,db,da);
+    }
+#endif
+
+#define M(name, count, ...) \
+    static constexpr Stage name = fused<SK_FUSED_KERNELS_##count(__VA_ARGS__)>;
+    SK_RASTER_PIPELINE_FUSED_STAGES(M)
+#undef M
+
 namespace lowp {
 #if defined(JUMPER_IS_SCALAR) || defined(SK_DISABLE_LOWP_RASTER_PIPELINE)
     // If we're not compiled by Clang, or otherwise switched into scalar mode (old Clang, manually),
@@ -2918,6 +2951,9 @@ namespace lowp {
     #define M(st) static void (*st)(void) = nullptr;
         SK_RASTER_PIPELINE_STAGES(M)
     #undef M
+    #define M(st, ...) static void (*st)(void) = nullptr;
+        SK_RASTER_PIPELINE_FUSED_STAGES(M)
+    #undef M
     static void (*just_return)(void) = nullptr;
 
     static void start_pipeline(size_t,size_t,size_t,size_t, void**) {}
@@ -4277,6 +4313,55 @@ STAGE_PP(swizzle, void* ctx) {
     }
 }
 
+// ~~~~~~ Fused stages ~~~~~~ //
+
+// As in highp, but lowp kernels come in three shapes; fused_k() calls each as its STAGE_ macro
+// would. Only runs of stages that are all implemented in lowp can be fused here.
+template <auto kernel>
+SI void fused_k(void**& program, size_t dx, size_t dy, size_t tail,
+                U16&  r, U16&  g, U16&  b, U16&  a,
+                U16& dr, U16& dg, U16& db, U16& da) {
+    using K = decltype(kernel);
+    if constexpr (std::is_invocable_v<K, Ctx, size_t,size_t,size_t, F&,F&>) {
+        auto x = join<F>(r,g),
+             y = join<F>(b,a);
+        kernel(Ctx{program}, dx,dy,tail, x,y);
+        split(x, &r,&g);
+        split(y, &b,&a);
+    } else if constexpr (std::is_invocable_v<K, Ctx, size_t,size_t,size_t, F,F,
+                                             U16&,U16&,U16&,U16&, U16&,U16&,U16&,U16&>) {
+        auto x = join<F>(r,g),
+             y = join<F>(b,a);
+        kernel(Ctx{program}, dx,dy,tail, x,y, r,g,b,a, dr,dg,db,da);
+    } else {
+        kernel(Ctx{program}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    }
+}
+
+#if JUMPER_NARROW_STAGES
+    template <auto... kernels>
+    static void ABI fused(Params* params, void** program, U16 r, U16 g, U16 b, U16 a) {
+        (fused_k<kernels>(program, params->dx,params->dy,params->tail, r,g,b,a,
+                          params->dr,params->dg,params->db,params->da), ...);
+        auto next = (Stage)load_and_inc(program);
+        next(params,program, r,g,b,a);
+    }
+#else
+    template <auto... kernels>
+    static void ABI fused(size_t tail, void** program, size_t dx, size_t dy,
+                          U16  r, U16  g, U16  b, U16  a,
+                          U16 dr, U16 dg, U16 db, U16 da) {
+        (fused_k<kernels>(program, dx,dy,tail, r,g,b,a, dr,dg,db,da), ...);
+        auto next = (Stage)load_and_inc(program);
+        next(tail,program,dx,dy, r,g,b,a, dr,dg,db,da);
+    }
+#endif
+
+#define M(name, count, ...) \
+    static constexpr Stage name = fused<SK_FUSED_KERNELS_##count(__VA_ARGS__)>;
+    SK_RASTER_PIPELINE_FUSED_STAGES(M)
+#undef M
+
 // Now we'll add null stand-ins for stages we haven't implemented in lowp.
 // If a pipeline uses these stages, it'll boot it out of lowp into highp.
 #define NOT_IMPLEMENTED(st) static void (*st)(void) = nullptr;
@@ -4383,5 +4468,8 @@ STAGE_PP(swizzle, void* ctx) {
 }  // namespace SK_OPTS_NS
 
 #undef SI
+#undef SK_FUSED_KERNELS_2
+#undef SK_FUSED_KERNELS_3
+#undef SK_FUSED_KERNELS_4
 
 #endif//SkRasterPipeline_opts_DEFINED
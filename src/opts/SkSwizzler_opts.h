@@ -1384,6 +1384,298 @@ static void RGB_to_BGR1_portable(uint32_t dst[], const uint8_t* src, int count)
     }
 #endif
 
+// 16-bit PNGs store each component big-endian, so stripping them to 8 bits keeps every other
+// byte, starting with the first.
+static void RGB16_to_RGB1_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4];
+        src += 6;
+        dst[i] = (uint32_t)0xFF << 24
+               | (uint32_t)b    << 16
+               | (uint32_t)g    <<  8
+               | (uint32_t)r    <<  0;
+    }
+}
+static void RGB16_to_BGR1_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4];
+        src += 6;
+        dst[i] = (uint32_t)0xFF << 24
+               | (uint32_t)r    << 16
+               | (uint32_t)g    <<  8
+               | (uint32_t)b    <<  0;
+    }
+}
+static void RGBA16_to_RGBA_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4],
+                a = src[6];
+        src += 8;
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)b << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)r <<  0;
+    }
+}
+static void RGBA16_to_BGRA_portable(uint32_t dst[], const uint8_t* src, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t r = src[0],
+                g = src[2],
+                b = src[4],
+                a = src[6];
+        src += 8;
+        dst[i] = (uint32_t)a << 24
+               | (uint32_t)r << 16
+               | (uint32_t)g <<  8
+               | (uint32_t)b <<  0;
+    }
+}
+#if defined(SK_ARM_HAS_NEON)
+    // Loading big-endian components as little-endian uint16_t puts the byte we keep in the low
+    // half of each lane, which is what vmovn_u16() narrows to.
+    static void strip_rgb16_should_swaprb(bool kSwapRB,
+                                          uint32_t dst[], const uint8_t* src, int count) {
+        while (count >= 8) {
+            // Load 8 pixels.
+            uint16x8x3_t rgb = vld3q_u16((const uint16_t*) src);
+
+            // Narrow to 8 bits, insert an opaque alpha channel and swap if needed.
+            uint8x8x4_t rgba;
+            rgba.val[0] = vmovn_u16(rgb.val[kSwapRB ? 2 : 0]);
+            rgba.val[1] = vmovn_u16(rgb.val[1]);
+            rgba.val[2] = vmovn_u16(rgb.val[kSwapRB ? 0 : 2]);
+            rgba.val[3] = vdup_n_u8(0xFF);
+
+            // Store 8 pixels.
+            vst4_u8((uint8_t*) dst, rgba);
+            src += 8*6;
+            dst += 8;
+            count -= 8;
+        }
+
+        // Call portable code to finish up the tail of [0,8) pixels.
+        auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+        proc(dst, src, count);
+    }
+
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        strip_rgb16_should_swaprb(false, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        strip_rgb16_should_swaprb(true, dst, src, count);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    // 6-byte pixels don't line up well with wider vectors, so we stick with SSSE3 here.
+    static void strip_rgb16_should_swaprb(bool kSwapRB,
+                                          uint32_t dst[], const uint8_t* src, int count) {
+        const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+        __m128i lo, hi;
+        const uint8_t X = 0xFF; // Used a placeholder.  Any byte with its top bit set reads as 0.
+        if (kSwapRB) {
+            lo = _mm_setr_epi8(4,2,0,X, 10,8,6,X, X,X,X,X, X,X,X,X);
+            hi = _mm_setr_epi8(X,X,X,X, X,X,X,X, 8,6,4,X, 14,12,10,X);
+        } else {
+            lo = _mm_setr_epi8(0,2,4,X, 6,8,10,X, X,X,X,X, X,X,X,X);
+            hi = _mm_setr_epi8(X,X,X,X, X,X,X,X, 4,6,8,X, 10,12,14,X);
+        }
+
+        while (count >= 4) {
+            // Load 4 pixels in two overlapping vectors: the first 16 bytes hold pixels 0 and 1,
+            // the last 16 bytes hold pixels 2 and 3.
+            __m128i p01 = _mm_loadu_si128((const __m128i*) (src + 0)),
+                    p23 = _mm_loadu_si128((const __m128i*) (src + 8));
+
+            // Keep the high byte of each component, then mask to RGB(FF).
+            __m128i rgba = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(p01, lo),
+                                                     _mm_shuffle_epi8(p23, hi)), alphaMask);
+
+            // Store 4 pixels.
+            _mm_storeu_si128((__m128i*) dst, rgba);
+
+            src += 4*6;
+            dst += 4;
+            count -= 4;
+        }
+
+        // Call portable code to finish up the tail of [0,4) pixels.
+        auto proc = kSwapRB ? RGB16_to_BGR1_portable : RGB16_to_RGB1_portable;
+        proc(dst, src, count);
+    }
+
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        strip_rgb16_should_swaprb(false, dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        strip_rgb16_should_swaprb(true, dst, src, count);
+    }
+#else
+    /*not static*/ inline void RGB16_to_RGB1(uint32_t dst[], const uint8_t* src, int count) {
+        RGB16_to_RGB1_portable(dst, src, count);
+    }
+    /*not static*/ inline void RGB16_to_BGR1(uint32_t dst[], const uint8_t* src, int count) {
+        RGB16_to_BGR1_portable(dst, src, count);
+    }
+#endif
+
+#if defined(SK_ARM_HAS_NEON)
+    static void strip_rgba16_should_swaprb(bool kSwapRB,
+                                           uint32_t dst[], const uint8_t* src, int count) {
+        while (count >= 8) {
+            // Load 8 pixels.
+            uint16x8x4_t rgba16 = vld4q_u16((const uint16_t*) src);
+
+            // Narrow to 8 bits and swap if needed.
+            uint8x8x4_t rgba;
+            rgba.val[0] = vmovn_u16(rgba16.val[kSwapRB ? 2 : 0]);
+            rgba.val[1] = vmovn_u16(rgba16.val[1]);
+            rgba.val[2] = vmovn_u16(rgba16.val[kSwapRB ? 0 : 2]);
+            rgba.val[3] = vmovn_u16(rgba16.val[3]);
+
+            // Store 8 pixels.
+            vst4_u8((uint8_t*) dst, rgba);
+            src += 8*8;
+            dst += 8;
+            count -= 8;
+        }
+
+        // Call portable code to finish up the tail of [0,8) pixels.
+        auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+        proc(dst, src, count);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    static void strip_rgba16_should_swaprb(bool kSwapRB,
+                                           uint32_t dst[], const uint8_t* src, int count) {
+        __m256i strip;
+        const uint8_t X = 0xFF; // Used a placeholder.  Any byte with its top bit set reads as 0.
+        if (kSwapRB) {
+            strip = _mm256_setr_epi8(4,2,0,6, 12,10,8,14, X,X,X,X, X,X,X,X,
+                                     4,2,0,6, 12,10,8,14, X,X,X,X, X,X,X,X);
+        } else {
+            strip = _mm256_setr_epi8(0,2,4,6, 8,10,12,14, X,X,X,X, X,X,X,X,
+                                     0,2,4,6, 8,10,12,14, X,X,X,X, X,X,X,X);
+        }
+
+        while (count >= 8) {
+            // Load 8 pixels.
+            __m256i lo = _mm256_loadu_si256((const __m256i*) (src +  0)),
+                    hi = _mm256_loadu_si256((const __m256i*) (src + 32));
+
+            // Keep the high byte of each component.  Shuffles stay within 128-bit lanes, so
+            // this leaves p01 | p23 and p45 | p67 in the low halves of each lane.
+            lo = _mm256_shuffle_epi8(lo, strip);
+            hi = _mm256_shuffle_epi8(hi, strip);
+
+            // Combine into p01 p45 | p23 p67, then reorder to p01 p23 | p45 p67.
+            __m256i rgba = _mm256_unpacklo_epi64(lo, hi);
+            rgba = _mm256_permute4x64_epi64(rgba, 0xD8);
+
+            // Store 8 pixels.
+            _mm256_storeu_si256((__m256i*) dst, rgba);
+
+            src += 8*8;
+            dst += 8;
+            count -= 8;
+        }
+
+        // Call portable code to finish up the tail of [0,8) pixels.
+        auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+        proc(dst, src, count);
+    }
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    static void strip_rgba16_should_swaprb(bool kSwapRB,
+                                           uint32_t dst[], const uint8_t* src, int count) {
+        __m128i strip;
+        const uint8_t X = 0xFF; // Used a placeholder.  Any byte with its top bit set reads as 0.
+        if (kSwapRB) {
+            strip = _mm_setr_epi8(4,2,0,6, 12,10,8,14, X,X,X,X, X,X,X,X);
+        } else {
+            strip = _mm_setr_epi8(0,2,4,6, 8,10,12,14, X,X,X,X, X,X,X,X);
+        }
+
+        while (count >= 4) {
+            // Load 4 pixels.
+            __m128i p01 = _mm_loadu_si128((const __m128i*) (src +  0)),
+                    p23 = _mm_loadu_si128((const __m128i*) (src + 16));
+
+            // Keep the high byte of each component.
+            __m128i rgba = _mm_unpacklo_epi64(_mm_shuffle_epi8(p01, strip),
+                                              _mm_shuffle_epi8(p23, strip));
+
+            // Store 4 pixels.
+            _mm_storeu_si128((__m128i*) dst, rgba);
+
+            src += 4*8;
+            dst += 4;
+            count -= 4;
+        }
+
+        // Call portable code to finish up the tail of [0,4) pixels.
+        auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+        proc(dst, src, count);
+    }
+#else
+    static void strip_rgba16_should_swaprb(bool kSwapRB,
+                                           uint32_t dst[], const uint8_t* src, int count) {
+        auto proc = kSwapRB ? RGBA16_to_BGRA_portable : RGBA16_to_RGBA_portable;
+        proc(dst, src, count);
+    }
+#endif
+
+/*not static*/ inline void RGBA16_to_RGBA(uint32_t dst[], const uint8_t* src, int count) {
+    strip_rgba16_should_swaprb(false, dst, src, count);
+}
+/*not static*/ inline void RGBA16_to_BGRA(uint32_t dst[], const uint8_t* src, int count) {
+    strip_rgba16_should_swaprb(true, dst, src, count);
+}
+
+// Premultiplying as a second pass over dst lets us reuse the kernels above; the row is still in
+// cache from the first.
+/*not static*/ inline void RGBA16_to_rgbA(uint32_t dst[], const uint8_t* src, int count) {
+    RGBA16_to_RGBA(dst, src, count);
+    RGBA_to_rgbA(dst, dst, count);
+}
+/*not static*/ inline void RGBA16_to_bgrA(uint32_t dst[], const uint8_t* src, int count) {
+    RGBA16_to_BGRA(dst, src, count);
+    RGBA_to_rgbA(dst, dst, count);
+}
+
+static void index_to_8888_portable(uint32_t dst[], const uint8_t* src, int count,
+                                   const uint32_t table[]) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = table[src[i]];
+    }
+}
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    // Gathers only pay off from AVX2 on; narrower machines have no gather instruction.
+    /*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                             const uint32_t table[]) {
+        while (count >= 8) {
+            // Load 8 indices, widen them to 32 bits, and look them all up at once.
+            __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) src));
+            __m256i colors  = _mm256_i32gather_epi32((const int*) table, indices, 4);
+
+            // Store 8 pixels.
+            _mm256_storeu_si256((__m256i*) dst, colors);
+
+            src += 8;
+            dst += 8;
+            count -= 8;
+        }
+        index_to_8888_portable(dst, src, count, table);
+    }
+#else
+    /*not static*/ inline void index_to_8888(uint32_t dst[], const uint8_t* src, int count,
+                                             const uint32_t table[]) {
+        index_to_8888_portable(dst, src, count, table);
+    }
+#endif
+
 }  // namespace SK_OPTS_NS
 
 #endif // SkSwizzler_opts_DEFINED
@@ -9,10 +9,14 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImage.h"
+#include "include/private/SkMutex.h"
+#include "include/private/SkTo.h"
 #include "include/utils/SkAnimCodecPlayer.h"
 #include "src/codec/SkCodecImageGenerator.h"
 #include "src/core/SkPixmapPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include <algorithm>
+#include <atomic>
 
 SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
     fImageInfo = fCodec->getInfo();
@@ -137,4 +141,129 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
     return fCurrIndex != prevIndex;
 }
 
+bool SkAnimCodecPlayer::DecodeAllFrames(sk_sp<SkData> data, SkExecutor* executor,
+                                        const std::function<void(int, sk_sp<SkImage>)>& onFrame) {
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        return false;
+    }
+
+    const SkImageInfo imageInfo = codec->getInfo();
+    std::vector<SkCodec::FrameInfo> frameInfos = codec->getFrameInfo();
+    if (frameInfos.empty()) {
+        // Static image -- a single frame that depends on nothing.
+        if (codec->getFrameCount() != 1) {
+            return false;
+        }
+        SkCodec::FrameInfo still = {};
+        still.fRequiredFrame = SkCodec::kNoFrame;
+        still.fAlphaType     = imageInfo.alphaType();
+        frameInfos.push_back(still);
+    }
+    const int count = SkToInt(frameInfos.size());
+
+    // Frames form a forest: each hangs off the frame it's drawn over, if any.  A frame keeps its
+    // image only while some of the frames drawn over it have yet to copy it.
+    struct Frame {
+        std::vector<int> fDependents;
+        std::atomic<int> fPendingDependents{0};
+        sk_sp<SkImage>   fImage;
+    };
+    std::unique_ptr<Frame[]> frames(new Frame[count]);
+    std::vector<int> roots;
+    for (int i = 0; i < count; i++) {
+        const int required = frameInfos[i].fRequiredFrame;
+        if (required == SkCodec::kNoFrame) {
+            roots.push_back(i);
+        } else {
+            SkASSERT(0 <= required && required < i);
+            frames[required].fDependents.push_back(i);
+            frames[required].fPendingDependents++;
+        }
+    }
+
+    // Codecs aren't thread safe, so each decode borrows one, making more as needed.
+    SkMutex mutex;  // Guards codecs and calls to onFrame.
+    std::vector<std::unique_ptr<SkCodec>> codecs;
+    codecs.push_back(std::move(codec));
+    auto borrow_codec = [&]() -> std::unique_ptr<SkCodec> {
+        {
+            SkAutoMutexExclusive lock(mutex);
+            if (!codecs.empty()) {
+                std::unique_ptr<SkCodec> spare = std::move(codecs.back());
+                codecs.pop_back();
+                return spare;
+            }
+        }
+        return SkCodec::MakeFromData(data);
+    };
+
+    auto decode = [&](int index) -> bool {
+        const SkCodec::FrameInfo& frameInfo = frameInfos[index];
+
+        SkImageInfo info = imageInfo;
+        if (frameInfo.fAlphaType != kOpaque_SkAlphaType && info.isOpaque()) {
+            info = info.makeAlphaType(kPremul_SkAlphaType);
+        }
+        const size_t rb = info.minRowBytes();
+        sk_sp<SkData> pixels = SkData::MakeUninitialized(info.computeByteSize(rb));
+        const SkPixmap dst(info, pixels->writable_data(), rb);
 
+        SkCodec::Options opts;
+        opts.fFrameIndex = index;
+        if (frameInfo.fRequiredFrame != SkCodec::kNoFrame) {
+            Frame& prior = frames[frameInfo.fRequiredFrame];
+            SkAssertResult(prior.fImage->readPixels(nullptr, dst, 0, 0));
+            if (--prior.fPendingDependents == 0) {
+                prior.fImage.reset();
+            }
+            opts.fPriorFrame = frameInfo.fRequiredFrame;
+        }
+
+        std::unique_ptr<SkCodec> frameCodec = borrow_codec();
+        if (!frameCodec || SkCodec::kSuccess != frameCodec->getPixels(dst, &opts)) {
+            return false;
+        }
+
+        sk_sp<SkImage> image = SkImage::MakeRasterData(info, std::move(pixels), rb);
+        if (!frames[index].fDependents.empty()) {
+            frames[index].fImage = image;
+        }
+        SkAutoMutexExclusive lock(mutex);
+        codecs.push_back(std::move(frameCodec));
+        onFrame(index, std::move(image));
+        return true;
+    };
+
+    // Once a frame is decoded, the frames drawn over it can start.
+    std::atomic<bool> ok{true};
+    std::function<void(int)> schedule;
+    auto run = [&](int index) {
+        if (!decode(index)) {
+            ok = false;
+            return;
+        }
+        for (int dependent : frames[index].fDependents) {
+            schedule(dependent);
+        }
+    };
+
+    if (executor) {
+        SkTaskGroup group(*executor);
+        schedule = [&](int index) { group.add([&run, index] { run(index); }); };
+        for (int root : roots) {
+            schedule(root);
+        }
+        group.wait();
+    } else {
+        // Depth first, so we're done with each keyframe as soon as we can be.
+        std::vector<int> stack(roots.rbegin(), roots.rend());
+        schedule = [&](int index) { stack.push_back(index); };
+        while (!stack.empty()) {
+            const int index = stack.back();
+            stack.pop_back();
+            run(index);
+        }
+    }
+    return ok;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkRegion.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkCoreBlitters.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkScan.h"
+#include "src/core/SkVMBlitter.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <vector>
+
+static constexpr int kW = 200,
+                     kH = 20;
+
+// Records the alpha each pixel was last blitted with. It doesn't override blitSpans(), so spans
+// sent to it go through SkBlitter's fallback.
+struct RecordingBlitter : public SkBlitter {
+    void blitH(int x, int y, int width) override {
+        std::fill_n(&fAlpha[y * kW + x], width, 0xFF);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        for (int n; (n = runs[0]) != 0; x += n, antialias += n, runs += n) {
+            std::fill_n(&fAlpha[y * kW + x], n, antialias[0]);
+        }
+    }
+
+    std::vector<SkAlpha> fAlpha = std::vector<SkAlpha>(kW * kH, 0);
+};
+
+// Counts how often it is handed a batch, and how many spans arrive in all.
+struct CountingBlitter : public RecordingBlitter {
+    void blitSpans(const Span spans[], int count) override {
+        fBatches++;
+        fSpans += count;
+        this->INHERITED::blitSpans(spans, count);
+    }
+
+    int fBatches = 0,
+        fSpans   = 0;
+
+    using INHERITED = RecordingBlitter;
+};
+
+DEF_TEST(BlitSpans_Clipped, reporter) {
+    SkRandom rand;
+    std::vector<SkBlitter::Span> spans;
+    for (int i = 0; i < 300; i++) {
+        // Some spans are longer than SkBlitter's fallback chunks, and some have zero alpha.
+        int x = rand.nextRangeU(0, kW - 1),
+            y = rand.nextRangeU(0, kH - 1),
+            w = rand.nextRangeU(1, kW - x);
+        SkAlpha alpha = i % 3 == 0 ? 0xFF : SkToU8(rand.nextBits(8));
+        spans.push_back({y, x, w, alpha});
+    }
+
+    SkRegion rgn;
+    rgn.op(SkIRect::MakeLTRB( 10,  2,  90, 15), SkRegion::kUnion_Op);
+    rgn.op(SkIRect::MakeLTRB( 70,  5, 180, 18), SkRegion::kUnion_Op);
+    rgn.op(SkIRect::MakeLTRB(100,  8, 120, 12), SkRegion::kDifference_Op);
+    const SkIRect rect = SkIRect::MakeLTRB(5, 3, 150, 17);
+
+    for (bool useRegion : {false, true}) {
+        // Each pixel should end up with the alpha of the last span covering it, if it's clipped in.
+        std::vector<SkAlpha> expected(kW * kH, 0);
+        for (const SkBlitter::Span& span : spans) {
+            for (int x = span.fX; x < span.fX + span.fWidth; x++) {
+                bool inClip = useRegion ? rgn.contains(x, span.fY) : rect.contains(x, span.fY);
+                if (inClip && span.fAlpha) {
+                    expected[span.fY * kW + x] = span.fAlpha;
+                }
+            }
+        }
+
+        RecordingBlitter recorder;
+        SkRectClipBlitter rectClipper;
+        SkRgnClipBlitter  rgnClipper;
+        rectClipper.init(&recorder, rect);
+        rgnClipper.init(&recorder, &rgn);
+        SkBlitter* clipper = useRegion ? (SkBlitter*)&rgnClipper : (SkBlitter*)&rectClipper;
+
+        // Send the spans in uneven batches, as scan converters would.
+        for (int i = 0, n = 1; i < (int)spans.size(); i += n, n = n % 7 + 1) {
+            clipper->blitSpans(spans.data() + i, std::min(n, (int)spans.size() - i));
+        }
+        REPORTER_ASSERT(reporter, recorder.fAlpha == expected, "useRegion %d", useRegion);
+    }
+}
+
+DEF_TEST(BlitSpans_FillPath, reporter) {
+    SkPath path;
+    path.moveTo(10, 1).lineTo(190, 4).lineTo(150, 19).lineTo(20, 16).close();
+    const SkRegion clip(SkIRect::MakeWH(kW, kH));
+
+    CountingBlitter blitter;
+    SkScan::FillPath(path, clip, &blitter);
+
+    // One span per row, sent in batches rather than one call each.
+    REPORTER_ASSERT(reporter, blitter.fSpans == 18);
+    REPORTER_ASSERT(reporter, blitter.fBatches >= 1 && blitter.fBatches < blitter.fSpans);
+
+    // The batched spans still cover what the path does.
+    REPORTER_ASSERT(reporter, blitter.fAlpha[10 * kW + 100] == 0xFF);
+    REPORTER_ASSERT(reporter, blitter.fAlpha[10 * kW +   5] == 0x00);
+    REPORTER_ASSERT(reporter, blitter.fAlpha[ 0 * kW + 100] == 0x00);
+}
+
+// SkRasterPipelineBlitter and SkVMBlitter draw batches with their own loops, which must draw
+// exactly what blitH() and blitAntiH() draw one span at a time.
+DEF_TEST(BlitSpans_MatchesPerSpan, reporter) {
+    SkRandom rand;
+    std::vector<SkBlitter::Span> spans;
+    for (int i = 0; i < 300; i++) {
+        // Overlapping spans, so the order they're drawn in matters too.
+        int x = rand.nextRangeU(0, kW - 1),
+            y = rand.nextRangeU(0, kH - 1),
+            w = rand.nextRangeU(1, std::min(kW - x, 40));
+        SkAlpha alpha = i % 3 == 0 ? 0xFF
+                      : i % 7 == 0 ? 0x00 : SkToU8(rand.nextBits(8));
+        spans.push_back({y, x, w, alpha});
+    }
+
+    const SkPoint pts[] = {{0, 0}, {kW, kH}};
+    const SkColor colors[] = {0xff2040c0, 0x80e0a010, 0xff10c040};
+    SkPaint solid, translucent, shaded;
+    solid.setColor(0xff336699);
+    translucent.setColor(0x80ff3366);
+    shaded.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, SK_ARRAY_COUNT(colors),
+                                                  SkTileMode::kClamp));
+
+    const SkMatrixProvider matrixProvider(SkMatrix::I());
+    for (bool skvm : {false, true}) {
+        for (const SkPaint& paint : {solid, translucent, shaded}) {
+            auto draw = [&](bool batched) {
+                SkBitmap bm;
+                bm.allocN32Pixels(kW, kH);
+                for (int y = 0; y < kH; y++) {
+                    for (int x = 0; x < kW; x++) {
+                        *bm.getAddr32(x, y) =
+                                SkPreMultiplyARGB(0xff, (7 * x) & 0xff, (13 * y) & 0xff, 0x80);
+                    }
+                }
+                SkPixmap dst;
+                SkAssertResult(bm.peekPixels(&dst));
+
+                SkSTArenaAlloc<kSkBlitterContextSize> alloc;
+                SkBlitter* blitter = skvm
+                    ? SkVMBlitter::Make(dst, paint, matrixProvider, &alloc, nullptr)
+                    : SkCreateRasterPipelineBlitter(dst, paint, matrixProvider, &alloc, nullptr);
+                REPORTER_ASSERT(reporter, blitter);
+                if (!blitter) {
+                    return bm;
+                }
+
+                if (batched) {
+                    for (int i = 0, n = 1; i < (int)spans.size(); i += n, n = n % 13 + 1) {
+                        blitter->blitSpans(spans.data() + i,
+                                           std::min(n, (int)spans.size() - i));
+                    }
+                } else {
+                    for (const SkBlitter::Span& span : spans) {
+                        if (span.fAlpha == 0xFF) {
+                            blitter->blitH(span.fX, span.fY, span.fWidth);
+                        } else {
+                            // One run of fWidth pixels, terminated at runs[fWidth].
+                            std::vector<SkAlpha> aa(span.fWidth + 1, 0);
+                            std::vector<int16_t> runs(span.fWidth + 1, 0);
+                            aa[0]   = span.fAlpha;
+                            runs[0] = SkToS16(span.fWidth);
+                            blitter->blitAntiH(span.fX, span.fY, aa.data(), runs.data());
+                        }
+                    }
+                }
+                return bm;
+            };
+
+            SkBitmap batched  = draw(true),
+                     perSpan  = draw(false);
+            int mismatches = 0;
+            for (int y = 0; y < kH; y++) {
+                for (int x = 0; x < kW; x++) {
+                    mismatches += *batched.getAddr32(x, y) != *perSpan.getAddr32(x, y);
+                }
+            }
+            REPORTER_ASSERT(reporter, mismatches == 0, "skvm %d, paint %08x, shader %d: %d",
+                            skvm, paint.getColor(), paint.getShader() != nullptr, mismatches);
+        }
+    }
+}
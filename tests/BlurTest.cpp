@@ -11,6 +11,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkMath.h"
@@ -35,6 +36,8 @@
 #include "src/core/SkMask.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/core/SkMathPriv.h"
+#include "src/core/SkPicturePriv.h"
+#include "src/core/SkReadBuffer.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
@@ -42,6 +45,8 @@
 
 #include <math.h>
 #include <string.h>
+#include <algorithm>
+#include <cstdlib>
 #include <initializer_list>
 #include <utility>
 
@@ -580,3 +585,166 @@ DEF_TEST(zero_blur, reporter) {
     SkIPoint offset;
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
+
+// Round rects too thin to stretch across are still drawn as a nine-patch, stretched only along
+// their length, and must match blurring a mask of the whole rrect.
+DEF_TEST(BlurredThinRRectNinePatch, reporter) {
+    sk_sp<SkMaskFilter> blur = SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 4);
+
+    for (SkRect r : {SkRect::MakeLTRB(20, 20, 320,  32),
+                     SkRect::MakeLTRB(20, 20, 120,  32),
+                     SkRect::MakeLTRB(30, 20,  44, 180),
+                     SkRect::MakeLTRB(30, 20,  90, 180)}) {
+        const SkRRect rrect = SkRRect::MakeRectXY(r, 6, 6);
+
+        SkBitmap src;
+        src.allocPixels(SkImageInfo::MakeA8(r.roundOut().width(), r.roundOut().height()));
+        src.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkCanvas canvas(src);
+            canvas.translate(-r.fLeft, -r.fTop);
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            canvas.drawRRect(rrect, paint);
+        }
+
+        SkMask srcMask, expected;
+        srcMask.fImage    = (uint8_t*)src.getPixels();
+        srcMask.fBounds   = r.roundOut();
+        srcMask.fRowBytes = src.rowBytes();
+        srcMask.fFormat   = SkMask::kA8_Format;
+        SkIPoint margin;
+        if (!as_MFB(blur)->filterMask(&expected, srcMask, SkMatrix::I(), &margin)) {
+            ERRORF(reporter, "filterMask failed");
+            continue;
+        }
+        SkAutoMaskFreeImage autoExpected(expected.fImage);
+
+        SkBitmap dst;
+        dst.allocPixels(SkImageInfo::MakeA8(400, 200));
+        dst.eraseColor(SK_ColorTRANSPARENT);
+        {
+            SkCanvas canvas(dst);
+            SkPaint paint;
+            paint.setMaskFilter(blur);
+            canvas.drawRRect(rrect, paint);
+        }
+
+        int maxDiff = 0;
+        for (int y = 0; y < dst.height(); ++y) {
+            for (int x = 0; x < dst.width(); ++x) {
+                int want = expected.fBounds.contains(x, y) ? *expected.getAddr8(x, y) : 0;
+                maxDiff = std::max(maxDiff, std::abs(want - *dst.getAddr8(x, y)));
+            }
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 1, "%g x %g rrect, max diff %d",
+                        r.width(), r.height(), maxDiff);
+    }
+}
+
+// The fast approximate quality must match kExact wherever both use the box blurs, and stay within
+// its documented error elsewhere.
+DEF_TEST(BlurFastApproximateQuality, reporter) {
+    SkMask src;
+    src.fBounds   = SkIRect::MakeWH(37, 29);
+    src.fRowBytes = src.fBounds.width();
+    src.fFormat   = SkMask::kA8_Format;
+    src.fImage    = SkMask::AllocImage(src.computeImageSize());
+    SkAutoMaskFreeImage autoSrc(src.fImage);
+    for (int y = 0; y < src.fBounds.height(); ++y) {
+        for (int x = 0; x < src.fBounds.width(); ++x) {
+            // A solid block, a thin line, and a few scattered dots.
+            bool on = (x >= 4 && x < 20 && y >= 3 && y < 17) || x == 27 ||
+                      (x * 7 + y * 3) % 23 == 0;
+            src.fImage[y * src.fRowBytes + x] = on ? 0xFF : 0x00;
+        }
+    }
+
+    for (double sigma : {1.2, 1.5, 1.87, 1.99, 2.0, 3.0, 7.5, 20.0}) {
+        SkMask exact, fast;
+        SkIPoint exactMargin, fastMargin;
+        if (!SkBlurMask::BoxBlur(&exact, src, sigma, kNormal_SkBlurStyle, &exactMargin) ||
+            !SkBlurMask::BoxBlur(&fast, src, sigma, kNormal_SkBlurStyle, &fastMargin,
+                                 SkMaskBlurFilter::Quality::kFastApproximate)) {
+            ERRORF(reporter, "BoxBlur failed for sigma %g", sigma);
+            continue;
+        }
+        SkAutoMaskFreeImage autoExact(exact.fImage),
+                            autoFast(fast.fImage);
+
+        // The margins differ below sigma 2, so compare over the union of both results.
+        SkIRect bounds = exact.fBounds;
+        bounds.join(fast.fBounds);
+        auto coverage = [](const SkMask& mask, int x, int y) {
+            return mask.fBounds.contains(x, y) ? *mask.getAddr8(x, y) : 0;
+        };
+        int maxDiff = 0;
+        for (int y = bounds.fTop; y < bounds.fBottom; ++y) {
+            for (int x = bounds.fLeft; x < bounds.fRight; ++x) {
+                maxDiff = std::max(maxDiff, std::abs(coverage(exact, x, y) - coverage(fast, x, y)));
+            }
+        }
+
+        if (sigma >= 2) {
+            REPORTER_ASSERT(reporter, exact.fBounds == fast.fBounds && exactMargin == fastMargin,
+                            "sigma %g", sigma);
+            REPORTER_ASSERT(reporter, maxDiff == 0, "sigma %g, max diff %d", sigma, maxDiff);
+        } else {
+            REPORTER_ASSERT(reporter, maxDiff <= 34, "sigma %g, max diff %d", sigma, maxDiff);
+        }
+    }
+}
+
+// The public opt-in must reach the CPU mask blur, survive serialization, and stay within the error
+// documented on SkMaskFilter::MakeBlur.
+DEF_TEST(BlurMaskFilterFastApproximate, reporter) {
+    // A triangle goes through SkBlurMaskFilterImpl::filterMask; rects and rrects would not.
+    SkPath path;
+    path.moveTo(6, 5).lineTo(40, 12).lineTo(14, 38).close();
+
+    auto draw = [&](sk_sp<SkMaskFilter> mf) {
+        SkBitmap bm;
+        bm.allocN32Pixels(48, 48);
+        bm.eraseColor(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setMaskFilter(std::move(mf));
+        SkCanvas(bm).drawPath(path, paint);
+        return bm;
+    };
+    auto maxAlphaDiff = [](const SkBitmap& a, const SkBitmap& b) {
+        int maxDiff = 0;
+        for (int y = 0; y < a.height(); ++y) {
+            for (int x = 0; x < a.width(); ++x) {
+                maxDiff = std::max(maxDiff, std::abs((int)SkColorGetA(a.getColor(x, y)) -
+                                                     (int)SkColorGetA(b.getColor(x, y))));
+            }
+        }
+        return maxDiff;
+    };
+
+    for (SkScalar sigma : {1.5f, 3.0f}) {
+        sk_sp<SkMaskFilter> fast = SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, sigma, true,
+                                                          SkBlurQuality::kFastApproximate);
+        SkBitmap exactBM = draw(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, sigma)),
+                 fastBM  = draw(fast);
+
+        int maxDiff = maxAlphaDiff(exactBM, fastBM);
+        if (sigma < 2) {
+            REPORTER_ASSERT(reporter, maxDiff > 0 && maxDiff <= 34, "max diff %d", maxDiff);
+        } else {
+            REPORTER_ASSERT(reporter, maxDiff == 0, "max diff %d", maxDiff);
+        }
+
+        sk_sp<SkData> data = fast->serialize();
+        sk_sp<SkMaskFilter> copy = SkMaskFilter::Deserialize(data->data(), data->size());
+        REPORTER_ASSERT(reporter, copy);
+        if (copy) {
+            REPORTER_ASSERT(reporter, maxAlphaDiff(fastBM, draw(std::move(copy))) == 0);
+        }
+
+        // Pictures older than kBlurMaskFilterQuality never set the quality bit.
+        SkReadBuffer oldBuffer(data->data(), data->size());
+        oldBuffer.setVersion(SkPicturePriv::kRawImageShaders);
+        REPORTER_ASSERT(reporter, !oldBuffer.readMaskFilter());
+    }
+}
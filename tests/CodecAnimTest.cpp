@@ -10,6 +10,7 @@
 #include "include/codec/SkCodecAnimation.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkRect.h"
@@ -609,3 +610,51 @@ DEF_TEST(AnimCodecPlayer, r) {
                         "Mismatched size for frame at 500 ms of %s", test.fFile);
     }
 }
+
+DEF_TEST(AnimCodecPlayer_DecodeAllFrames, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const char* file : {"images/alphabetAnim.gif", "images/required.gif",
+                             "images/test640x479.gif", "images/stoplight.webp",
+                             "images/required.webp", "images/randPixels.png"}) {
+        sk_sp<SkData> data = GetResourceAsData(file);
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            continue;
+        }
+
+        // Decode each frame independently, letting the codec decode the frames it requires.
+        std::vector<SkBitmap> expected(codec->getFrameCount());
+        for (int i = 0; i < (int)expected.size(); i++) {
+            SkImageInfo info = codec->getInfo();
+            if (codec->getFrameCount() > 1) {
+                SkCodec::FrameInfo frameInfo;
+                REPORTER_ASSERT(r, codec->getFrameInfo(i, &frameInfo));
+                if (frameInfo.fAlphaType != kOpaque_SkAlphaType && info.isOpaque()) {
+                    info = info.makeAlphaType(kPremul_SkAlphaType);
+                }
+            }
+            SkCodec::Options opts;
+            opts.fFrameIndex = i;
+            expected[i].allocPixels(info);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(expected[i].pixmap(), &opts));
+        }
+
+        for (SkExecutor* exec : {(SkExecutor*)nullptr, executor.get()}) {
+            std::vector<sk_sp<SkImage>> frames(expected.size());
+            bool ok = SkAnimCodecPlayer::DecodeAllFrames(data, exec,
+                                                         [&](int index, sk_sp<SkImage> image) {
+                REPORTER_ASSERT(r, 0 <= index && index < (int)frames.size());
+                REPORTER_ASSERT(r, !frames[index], "%s frame %d was decoded twice", file, index);
+                frames[index] = std::move(image);
+            });
+            REPORTER_ASSERT(r, ok, "%s", file);
+
+            for (int i = 0; i < (int)frames.size(); i++) {
+                SkPixmap actual;
+                REPORTER_ASSERT(r, frames[i] && frames[i]->peekPixels(&actual));
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected[i].pixmap(), actual),
+                                "%s frame %d (%s executor)", file, i, exec ? "with" : "no");
+            }
+        }
+    }
+}
@@ -19,6 +19,7 @@
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkImageGenerator.h"
@@ -40,6 +41,7 @@
 #include "include/third_party/skcms/skcms.h"
 #include "include/utils/SkRandom.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/codec/SkJpegCodec.h"
 #include "src/core/SkAutoMalloc.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkMD5.h"
@@ -1062,6 +1064,137 @@ DEF_TEST(Codec_jpeg_rewind, r) {
     REPORTER_ASSERT(r, SkCodec::kIncompleteInput == result);
 }
 
+class SkJpegCodecTestingAccess {
+public:
+    // Decodes in bands without falling back to a serial decode.
+    static SkCodec::Result DecodeRestartIntervals(SkCodec* codec, const SkPixmap& dst,
+                                                  const SkCodec::Options& options) {
+        SkASSERT(codec->getEncodedFormat() == SkEncodedImageFormat::kJPEG);
+        return static_cast<SkJpegCodec*>(codec)->decodeRestartIntervals(
+                dst.info(), dst.writable_addr(), dst.rowBytes(), options);
+    }
+};
+
+DEF_TEST(Codec_jpeg_restartIntervals, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    // icc-v2-gbr.jpg has a restart marker after each row of 4:2:0 MCUs, so it's split into
+    // bands. The others have no restart markers, too few of them, or are CMYK, and should be
+    // decoded serially.
+    for (const char* path : { "images/icc-v2-gbr.jpg",
+                              "images/wide_gamut_yellow_224_224_64.jpeg",
+                              "images/mandrill_512_q075.jpg",
+                              "images/mandrill_cmyk.jpg" }) {
+        const bool splitsIntoBands = !strcmp(path, "images/icc-v2-gbr.jpg");
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+
+        // Dropping the end of the data leaves the last restart interval incomplete, with no EOI.
+        for (size_t size : { data->size(), data->size() - 32 }) {
+            sk_sp<SkData> subset = SkData::MakeSubset(data.get(), 0, size);
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(subset);
+            if (!codec || codec->getEncodedFormat() != SkEncodedImageFormat::kJPEG) {
+                ERRORF(r, "Unable to create codec '%s'.", path);
+                return;
+            }
+
+            for (SkColorType ct : { kRGBA_8888_SkColorType, kBGRA_8888_SkColorType,
+                                    kRGB_565_SkColorType, kRGBA_F16_SkColorType }) {
+                // The sRGB variant needs a color xform, except for F16, which always has one.
+                for (sk_sp<SkColorSpace> cs : { codec->getInfo().refColorSpace(),
+                                                SkColorSpace::MakeSRGB() }) {
+                    SkImageInfo info = codec->getInfo().makeColorType(ct).makeColorSpace(cs);
+                    if (ct == kRGB_565_SkColorType && !cs->isSRGB()) {
+                        continue;
+                    }
+
+                    SkBitmap serial, parallel, bands;
+                    serial.allocPixels(info);
+                    parallel.allocPixels(info);
+                    bands.allocPixels(info);
+                    serial.eraseColor(SK_ColorTRANSPARENT);
+                    parallel.eraseColor(SK_ColorTRANSPARENT);
+                    bands.eraseColor(SK_ColorTRANSPARENT);
+
+                    SkCodec::Options options;
+                    const SkCodec::Result serialResult = codec->getPixels(serial.pixmap());
+                    options.fExecutor = executor.get();
+                    const SkCodec::Result parallelResult =
+                            codec->getPixels(parallel.pixmap(), &options);
+
+                    // Make sure the image we expect to be split into bands really is, and
+                    // that the others really fall back to a serial decode.
+                    const SkCodec::Result bandsResult =
+                            SkJpegCodecTestingAccess::DecodeRestartIntervals(
+                                    codec.get(), bands.pixmap(), options);
+                    const bool expectBands = splitsIntoBands && size == data->size();
+                    REPORTER_ASSERT(r, bandsResult == (expectBands ? SkCodec::kSuccess
+                                                                   : SkCodec::kUnimplemented),
+                                    "%s %zu ct %d", path, size, ct);
+                    if (expectBands) {
+                        REPORTER_ASSERT(r, md5(serial) == md5(bands),
+                                        "%s %zu ct %d", path, size, ct);
+                    }
+
+                    REPORTER_ASSERT(r, serialResult == parallelResult, "%s %zu", path, size);
+                    REPORTER_ASSERT(r, serialResult == (size == data->size()
+                                                        ? SkCodec::kSuccess
+                                                        : SkCodec::kIncompleteInput));
+                    REPORTER_ASSERT(r, md5(serial) == md5(parallel),
+                                    "%s %zu ct %d", path, size, ct);
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_readsMemoryInPlace, r) {
+    for (const char* path : { "images/mandrill_512.png",
+                              "images/plane_interlaced.png",
+                              "images/mandrill_512_q075.jpg",
+                              "images/color_wheel.webp",
+                              "images/flightAnim.gif" }) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+
+        // Decode every frame, so animated codecs have to seek back and forth.
+        std::vector<SkMD5::Digest> digests[2];
+        for (bool hasMemoryBase : { false, true }) {
+            auto stream = std::make_unique<CountingMemStream>(data, hasMemoryBase);
+            CountingMemStream* counter = stream.get();
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(std::move(stream));
+            if (!codec) {
+                ERRORF(r, "Unable to create codec '%s'.", path);
+                return;
+            }
+
+            const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                                     .makeAlphaType(kPremul_SkAlphaType);
+            for (int i = 0; i < codec->getFrameCount(); i++) {
+                SkBitmap bm;
+                bm.allocPixels(info);
+                SkCodec::Options options;
+                options.fFrameIndex = i;
+                REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.pixmap(), &options),
+                                "%s frame %d", path, i);
+                digests[hasMemoryBase].push_back(md5(bm));
+            }
+
+            // Codecs should only copy out small headers from memory they can read in place.
+            if (hasMemoryBase) {
+                REPORTER_ASSERT(r, counter->bytesCopied() < data->size() / 16,
+                                "%s copied %zu of %zu bytes", path, counter->bytesCopied(),
+                                data->size());
+            }
+        }
+        REPORTER_ASSERT(r, digests[0] == digests[1], "%s", path);
+    }
+}
+
 static void check_color_xform(skiatest::Reporter* r, const char* path) {
     std::unique_ptr<SkAndroidCodec> codec(SkAndroidCodec::MakeFromStream(GetResourceAsStream(path)));
 
@@ -8,10 +8,12 @@
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkEncodedImageFormat.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageEncoder.h"
 #include "include/core/SkStream.h"
@@ -20,6 +22,7 @@
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
 #include "include/private/SkImageInfoPriv.h"
+#include "include/utils/SkRandom.h"
 
 #include <png.h>
 
@@ -333,6 +336,127 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+DEF_TEST(Encode_PngParallel, r) {
+    // Tall enough to be split into many strips, with an odd width and rows the filters can
+    // predict some, but not all, of.
+    SkBitmap bitmap;
+    bitmap.allocPixels(SkImageInfo::MakeN32(301, 700, kUnpremul_SkAlphaType));
+    SkRandom random;
+    for (int y = 0; y < bitmap.height(); y++) {
+        for (int x = 0; x < bitmap.width(); x++) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32NoCheck(255 - y / 3, x, (x + y) & 0xFF,
+                                                          random.nextULessThan(16));
+        }
+    }
+    SkPixmap src = bitmap.pixmap();
+
+    auto decode = [&](sk_sp<SkData> data, SkBitmap* dst) {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(std::move(data));
+        dst->allocPixels(src.info());
+        return codec && SkCodec::kSuccess == codec->getPixels(dst->pixmap());
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (auto filters : {SkPngEncoder::FilterFlag::kAll, SkPngEncoder::FilterFlag::kNone,
+                         SkPngEncoder::FilterFlag::kPaeth,
+                         SkPngEncoder::FilterFlag::kSub | SkPngEncoder::FilterFlag::kAvg}) {
+        for (int zlibLevel : {0, 1, 6, 9}) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = filters;
+            options.fZLibLevel = zlibLevel;
+
+            SkDynamicMemoryWStream serial, parallel;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src, options));
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel, src, options));
+            sk_sp<SkData> serialData   = serial.detachAsData(),
+                          parallelData = parallel.detachAsData();
+
+            // Both should decode to exactly the source pixels.  We pick filters as libpng
+            // does, so the strips only cost a little compression at each boundary.
+            SkBitmap serialBM, parallelBM;
+            REPORTER_ASSERT(r, decode(serialData, &serialBM));
+            REPORTER_ASSERT(r, decode(parallelData, &parallelBM));
+            for (int y = 0; y < src.height(); y++) {
+                REPORTER_ASSERT(r, !memcmp(src.addr(0, y), serialBM.getAddr(0, y),
+                                           src.info().minRowBytes()));
+                REPORTER_ASSERT(r, !memcmp(src.addr(0, y), parallelBM.getAddr(0, y),
+                                           src.info().minRowBytes()));
+            }
+            REPORTER_ASSERT(r, parallelData->size() <= serialData->size() * 101 / 100,
+                            "filters %d, zlib level %d: %zu bytes in parallel, %zu serially",
+                            (int)filters, zlibLevel, parallelData->size(), serialData->size());
+        }
+    }
+}
+
+DEF_TEST(Encode_PngFilterHeuristics, r) {
+    auto decode = [](sk_sp<SkData> data, const SkImageInfo& info, SkBitmap* dst) {
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(std::move(data));
+        dst->allocPixels(info);
+        return codec && SkCodec::kSuccess == codec->getPixels(dst->pixmap());
+    };
+
+    SkRandom random;
+    // Sizes with and without a partial block of 16 bytes at the end of each row, and ones where
+    // libpng drops the filters that look at missing neighbors.
+    for (SkISize size : {SkISize{1, 1}, SkISize{1, 37}, SkISize{37, 1}, SkISize{5, 3},
+                         SkISize{301, 700}}) {
+        for (SkColorType ct : {kN32_SkColorType, kRGB_565_SkColorType, kGray_8_SkColorType,
+                               kRGBA_F16_SkColorType}) {
+            SkBitmap bitmap;
+            bitmap.allocPixels(SkImageInfo::Make(size, ct, kUnpremul_SkAlphaType));
+            for (int y = 0; y < size.height(); y++) {
+                for (int x = 0; x < size.width(); x++) {
+                    bitmap.erase(SkColorSetARGB(255 - y / 3, x & 0xFF, (x + y) & 0xFF,
+                                                random.nextULessThan(16)),
+                                 SkIRect::MakeXYWH(x, y, 1, 1));
+                }
+            }
+
+            for (auto filters : {SkPngEncoder::FilterFlag::kAll,
+                                 SkPngEncoder::FilterFlag::kPaeth,
+                                 SkPngEncoder::FilterFlag::kSub | SkPngEncoder::FilterFlag::kAvg}) {
+                SkPngEncoder::Options options;
+                options.fFilterFlags = filters;
+
+                // kMinSum picks the same filters libpng does, so it should compress as well.
+                // Sampling may cost a little more.
+                SkBitmap expected;
+                sk_sp<SkData> libpngData;
+                {
+                    SkDynamicMemoryWStream stream;
+                    REPORTER_ASSERT(r, SkPngEncoder::Encode(&stream, bitmap.pixmap(), options));
+                    libpngData = stream.detachAsData();
+                    REPORTER_ASSERT(r, decode(libpngData, bitmap.info(), &expected));
+                }
+                for (auto heuristic : {SkPngEncoder::FilterHeuristic::kMinSum,
+                                       SkPngEncoder::FilterHeuristic::kSampledMinSum}) {
+                    options.fFilterHeuristic = heuristic;
+                    SkDynamicMemoryWStream stream;
+                    REPORTER_ASSERT(r, SkPngEncoder::Encode(&stream, bitmap.pixmap(), options));
+                    sk_sp<SkData> data = stream.detachAsData();
+
+                    SkBitmap actual;
+                    REPORTER_ASSERT(r, decode(data, bitmap.info(), &actual));
+                    for (int y = 0; y < size.height(); y++) {
+                        REPORTER_ASSERT(r, !memcmp(expected.getAddr(0, y), actual.getAddr(0, y),
+                                                   bitmap.info().minRowBytes()));
+                    }
+
+                    const size_t slack = heuristic == SkPngEncoder::FilterHeuristic::kMinSum
+                                       ? libpngData->size() / 200 : libpngData->size() / 20;
+                    REPORTER_ASSERT(r, data->size() <= libpngData->size() + slack + 16,
+                                    "%dx%d, color type %d, filters %d, heuristic %d: "
+                                    "%zu bytes, libpng %zu",
+                                    size.width(), size.height(), ct, (int)filters, (int)heuristic,
+                                    data->size(), libpngData->size());
+                }
+            }
+        }
+    }
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "src/core/SkTaskGroup.h"
+#include "tests/Test.h"
+
+#include <atomic>
+#include <vector>
+
+DEF_TEST(SkExecutor_WorkStealing, r) {
+    auto executor = SkExecutor::MakeWorkStealingThreadPool(4);
+
+    std::atomic<int> count{0};
+    SkTaskGroup tasks(*executor);
+    tasks.batch(1000, [&](int) { count++; });
+    tasks.wait();
+    REPORTER_ASSERT(r, count == 1000);
+
+    // Work added from outside the pool and from inside it should both run.
+    count = 0;
+    for (int i = 0; i < 10; i++) {
+        tasks.add([&] {
+            for (int j = 0; j < 10; j++) {
+                tasks.add([&] { count++; });
+            }
+        });
+    }
+    tasks.wait();
+    REPORTER_ASSERT(r, count == 100);
+}
+
+DEF_TEST(SkExecutor_WorkStealingNested, r) {
+    // Even without borrowing, tasks can wait on the subtasks they spawn:
+    // the pool's own threads are always allowed to borrow work.
+    for (bool allowBorrowing : {true, false}) {
+        auto executor = SkExecutor::MakeWorkStealingThreadPool(3, allowBorrowing);
+
+        std::atomic<int> count{0};
+        SkTaskGroup outer(*executor);
+        outer.batch(20, [&](int) {
+            SkTaskGroup inner(*executor);
+            inner.batch(20, [&](int) { count++; });
+            inner.wait();
+        });
+        outer.wait();
+        REPORTER_ASSERT(r, count == 400);
+    }
+}
+
+DEF_TEST(SkTaskGroup_ParallelFor, r) {
+    auto executor = SkExecutor::MakeWorkStealingThreadPool(4);
+    SkTaskGroup tasks(*executor);
+
+    // Every index is visited exactly once, including the ragged last chunk.
+    std::vector<int> visits(1009, 0);
+    std::atomic<bool> chunksOk{true};
+    bool finished = tasks.parallel_for(0, (int)visits.size(), 16, [&](int lo, int hi) {
+        if (lo >= hi || hi - lo > 16) {
+            chunksOk = false;
+        }
+        for (int i = lo; i < hi; i++) {
+            visits[i]++;
+        }
+    });
+    REPORTER_ASSERT(r, finished);
+    REPORTER_ASSERT(r, chunksOk);
+    for (int v : visits) {
+        REPORTER_ASSERT(r, v == 1);
+    }
+
+    // Empty ranges don't call fn.
+    int calls = 0;
+    REPORTER_ASSERT(r, tasks.parallel_for(5, 5, 1, [&](int, int) { calls++; }));
+    REPORTER_ASSERT(r, calls == 0);
+
+    // Returning false stops chunks that haven't started yet.
+    std::atomic<int> started{0};
+    finished = tasks.parallel_for(0, 100000, 1, [&](int lo, int) {
+        started++;
+        return lo < 10;
+    });
+    REPORTER_ASSERT(r, !finished);
+    REPORTER_ASSERT(r, started < 100000);
+}
+
+DEF_TEST(SkTaskGroup_ParallelReduce, r) {
+    auto executor = SkExecutor::MakeWorkStealingThreadPool(4);
+    SkTaskGroup tasks(*executor);
+
+    auto sum = [](int lo, int hi) {
+        int64_t s = 0;
+        for (int i = lo; i < hi; i++) {
+            s += i;
+        }
+        return s;
+    };
+    auto add = [](int64_t a, int64_t b) { return a + b; };
+    REPORTER_ASSERT(r, tasks.parallel_reduce(0, 10000, 7, int64_t(0), sum, add) == 49995000);
+    REPORTER_ASSERT(r, tasks.parallel_reduce(3, 3, 7, int64_t(42), sum, add) == 42);
+
+    // Partial results are joined in order, so non-commutative joins are deterministic.
+    auto first = [](int lo, int) { return std::vector<int>{lo}; };
+    auto concat = [](std::vector<int> a, std::vector<int> b) {
+        a.insert(a.end(), b.begin(), b.end());
+        return a;
+    };
+    std::vector<int> firsts = tasks.parallel_reduce(0, 50, 10, std::vector<int>{}, first, concat);
+    REPORTER_ASSERT(r, firsts == (std::vector<int>{0, 10, 20, 30, 40}));
+}
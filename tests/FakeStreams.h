@@ -83,4 +83,33 @@ private:
     size_t          fLimit;
     SkMemoryStream  fStream;
 };
+
+// SkMemoryStream that tallies the bytes copied out of it with read(). It can also hide its
+// memory base, so readers have to copy.
+class CountingMemStream : public SkMemoryStream {
+public:
+    CountingMemStream(sk_sp<SkData> data, bool hasMemoryBase)
+        : SkMemoryStream(std::move(data))
+        , fHasMemoryBase(hasMemoryBase)
+        , fBytesCopied(0)
+    {}
+
+    size_t read(void* buffer, size_t size) override {
+        size = SkMemoryStream::read(buffer, size);
+        if (buffer) {
+            fBytesCopied += size;
+        }
+        return size;
+    }
+
+    const void* getMemoryBase() override {
+        return fHasMemoryBase ? SkMemoryStream::getMemoryBase() : nullptr;
+    }
+
+    size_t bytesCopied() const { return fBytesCopied; }
+
+private:
+    const bool fHasMemoryBase;
+    size_t     fBytesCopied;
+};
 #endif // FakeStreams_DEFINED
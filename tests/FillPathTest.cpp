@@ -5,12 +5,23 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkRegion.h"
+#include "include/effects/SkGradientShader.h"
+#include "src/core/SkArenaAlloc.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkDraw.h"
+#include "src/core/SkMatrixProvider.h"
+#include "src/core/SkRasterClip.h"
 #include "src/core/SkScan.h"
 #include "tests/Test.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
 struct FakeBlitter : public SkBlitter {
     FakeBlitter()
         : m_blitCount(0) { }
@@ -46,3 +57,188 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+// Records the coverage a scan converter blits into a width x height grid.
+struct CoverageBlitter : public SkBlitter {
+    CoverageBlitter(int width, int height) : fWidth(width), fCoverage(width * height, 0) {}
+
+    void blitH(int x, int y, int width) override {
+        std::fill_n(&fCoverage[y * fWidth + x], width, 0xFF);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        for (int n; (n = runs[0]) != 0; x += n, antialias += n, runs += n) {
+            std::fill_n(&fCoverage[y * fWidth + x], n, antialias[0]);
+        }
+    }
+
+    int                  fWidth;
+    std::vector<SkAlpha> fCoverage;
+};
+
+static std::vector<SkAlpha> fill_coverage(const SkPath& path, const SkIRect& clip,
+                                          bool sparseStrips) {
+    CoverageBlitter blitter(clip.right(), clip.bottom());
+    if (sparseStrips) {
+        SkScan::SparseStripsAntiFillPath(path, SkRasterClip(clip), &blitter);
+    } else {
+        SkScan::AntiFillPath(path, SkRasterClip(clip), &blitter);
+    }
+    return blitter.fCoverage;
+}
+
+DEF_TEST(FillPathSparseStrips, reporter) {
+    const SkIRect clip = SkIRect::MakeWH(100, 100);
+
+    // Sparse strips computes exact areas, so a rect's edges and corners get exactly the fraction
+    // of each pixel they cover.
+    SkPath rect = SkPath::Rect({10.5f, 10.25f, 20.5f, 20.75f});
+    std::vector<SkAlpha> coverage = fill_coverage(rect, clip, true);
+    auto at = [&](int x, int y) { return coverage[y * 100 + x]; };
+    REPORTER_ASSERT(reporter, at(10, 10) ==  96);   // 0.5 * 0.75
+    REPORTER_ASSERT(reporter, at(15, 10) == 191);   // 0.75
+    REPORTER_ASSERT(reporter, at(10, 15) == 128);   // 0.5
+    REPORTER_ASSERT(reporter, at(15, 15) == 255);
+    REPORTER_ASSERT(reporter, at(20, 20) ==  96);
+    REPORTER_ASSERT(reporter, at(21, 15) ==   0);
+    REPORTER_ASSERT(reporter, at(15,  9) ==   0);
+
+    // The same goes for the pixels a diagonal cuts in half.
+    SkPath triangle;
+    triangle.moveTo(30, 30).lineTo(40, 30).lineTo(30, 40).close();
+    coverage = fill_coverage(triangle, clip, true);
+    for (int i = 0; i < 10; i++) {
+        REPORTER_ASSERT(reporter, at(30 + i, 39 - i) == 128);
+        REPORTER_ASSERT(reporter, at(30 + i, 38 - i) == (i < 9 ? 255 : 0));
+    }
+
+    // Otherwise it should roughly match the other scan converters, clipped or not, for either
+    // fill rule and inverse fills. They approximate more than we do along nearly horizontal
+    // edges, so single pixels can be off by up to a quarter. (None of these paths cross
+    // themselves, where accumulating coverage is only an approximation.)
+    SkPath circle = SkPath::Circle(50.3f, 40.6f, 33.3f);
+    SkPath clipped = SkPath::Circle(10, 90, 40);
+    SkPath blob;
+    blob.moveTo(3, 90).cubicTo(120, -40, -30, -20, 97, 85).close();
+    SkPath inverse = circle;
+    inverse.setFillType(SkPathFillType::kInverseWinding);
+    SkPath evenOdd = circle;
+    evenOdd.addCircle(50.3f, 40.6f, 12.5f).setFillType(SkPathFillType::kEvenOdd);
+
+    for (const SkPath& path : {circle, clipped, blob, inverse, evenOdd}) {
+        std::vector<SkAlpha> expected = fill_coverage(path, clip, false),
+                             actual   = fill_coverage(path, clip, true);
+        int maxDiff = 0;
+        int64_t expectedSum = 0,
+                actualSum   = 0;
+        for (size_t i = 0; i < expected.size(); i++) {
+            maxDiff = std::max(maxDiff, std::abs(expected[i] - actual[i]));
+            expectedSum += expected[i];
+            actualSum   += actual[i];
+        }
+        REPORTER_ASSERT(reporter, maxDiff <= 64, "max difference %d", maxDiff);
+        REPORTER_ASSERT(reporter, std::abs(expectedSum - actualSum) * 100 <= expectedSum,
+                        "coverage %lld vs %lld", (long long)actualSum, (long long)expectedSum);
+    }
+}
+
+// Threaded path fills rely on sparse strips filling each row the same way no matter which other
+// rows it fills, so filling a path in bands matches filling it all at once exactly.
+DEF_TEST(FillPathSparseStripsBands, reporter) {
+    const SkIRect clip = SkIRect::MakeWH(300, 300);
+
+    SkPath star;
+    star.moveTo(150, 5);
+    for (int i = 1; i < 5; i++) {
+        float angle = i * 4 * SK_ScalarPI / 5;
+        star.lineTo(150 + 145 * SkScalarSin(angle), 150 - 145 * SkScalarCos(angle));
+    }
+    star.close();
+    SkPath evenOdd = star;
+    evenOdd.setFillType(SkPathFillType::kEvenOdd);
+    SkPath circle = SkPath::Circle(150.3f, 140.6f, 133.3f);
+    SkPath blob;
+    blob.moveTo(3, 290).cubicTo(320, -40, -30, -20, 297, 285).close();
+    SkPath inverse = SkPath::Circle(130.3f, 140.7f, 97);
+    inverse.setFillType(SkPathFillType::kInverseWinding);
+    SkPath offscreen = SkPath::Circle(-50, 150, 120);
+
+    for (const SkPath& path : {star, evenOdd, circle, blob, inverse, offscreen}) {
+        const std::vector<SkAlpha> expected = fill_coverage(path, clip, true);
+        for (int rows : {1, 4, 7, 64, 150}) {
+            CoverageBlitter blitter(clip.width(), clip.height());
+            for (int top = 0; top < clip.height(); top += rows) {
+                SkIRect band = SkIRect::MakeLTRB(0, top, clip.width(),
+                                                 std::min(top + rows, clip.height()));
+                SkScan::SparseStripsAntiFillPath(path, SkRasterClip(band), &blitter);
+            }
+            REPORTER_ASSERT(reporter, blitter.fCoverage == expected, "bands of %d rows", rows);
+        }
+    }
+}
+
+// With fThreadedPathFill, SkDraw fills large anti-aliased paths in bands on the default SkExecutor
+// (a thread pool under DM). The pixels must match one serial sparse strips fill.
+DEF_TEST(FillPathThreadedDraw, reporter) {
+    const int kSize = 640;  // Big enough for several bands.
+    const SkIRect bounds = SkIRect::MakeWH(kSize, kSize);
+
+    SkPath blob;
+    blob.moveTo(10, 600).cubicTo(700, -90, -60, -40, 630, 610).close();
+    SkPath inverse = SkPath::Circle(300.3f, 310.7f, 211);
+    inverse.setFillType(SkPathFillType::kInverseWinding);
+
+    SkMatrix ctm = SkMatrix::RotateDeg(7, {320, 320});
+    ctm.preScale(1.1f, 0.95f);
+
+    const SkPoint pts[] = {{0, 0}, {kSize, kSize}};
+    const SkColor colors[] = {0xff2040c0, 0x80e0a010, 0xff10c040};
+    SkPaint solid, shaded;
+    solid.setAntiAlias(true);
+    solid.setColor(0xc0ff3366);
+    shaded.setAntiAlias(true);
+    shaded.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, SK_ARRAY_COUNT(colors),
+                                                  SkTileMode::kMirror));
+
+    for (const SkPath& path : {blob, inverse}) {
+        for (const SkPaint& paint : {solid, shaded}) {
+            SkBitmap expected, actual;
+            expected.allocN32Pixels(kSize, kSize);
+            actual  .allocN32Pixels(kSize, kSize);
+            expected.eraseColor(0xff808080);
+            actual  .eraseColor(0xff808080);
+
+            {
+                SkPath devPath;
+                path.transform(ctm, &devPath);
+                SkPixmap dst;
+                SkAssertResult(expected.peekPixels(&dst));
+                SkMatrixProvider matrixProvider(ctm);
+                SkSTArenaAlloc<kSkBlitterContextSize> alloc;
+                SkBlitter* blitter = SkBlitter::Choose(dst, matrixProvider, paint, &alloc,
+                                                       false, nullptr);
+                SkScan::SparseStripsAntiFillPath(devPath, SkRasterClip(bounds), blitter);
+            }
+
+            {
+                SkMatrixProvider matrixProvider(ctm);
+                SkRasterClip rc(bounds);
+                SkDraw draw;
+                SkAssertResult(actual.peekPixels(&draw.fDst));
+                draw.fMatrixProvider = &matrixProvider;
+                draw.fRC = &rc;
+                draw.fThreadedPathFill = true;
+                draw.drawPath(path, paint);
+            }
+
+            int mismatches = 0;
+            for (int y = 0; y < kSize; y++) {
+                for (int x = 0; x < kSize; x++) {
+                    mismatches += *expected.getAddr32(x, y) != *actual.getAddr32(x, y);
+                }
+            }
+            REPORTER_ASSERT(reporter, mismatches == 0, "inverse %d, shader %d: %d pixels differ",
+                            path.isInverseFillType(), paint.getShader() != nullptr, mismatches);
+        }
+    }
+}
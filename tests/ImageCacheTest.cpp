@@ -5,17 +5,24 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "src/core/SkDiscardableMemory.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 #include "tests/Test.h"
 
+#include <atomic>
+#include <vector>
+
 namespace {
 static void* gGlobalAddress;
+static void* gOtherAddress;
 struct TestingKey : public SkResourceCache::Key {
     intptr_t    fValue;
 
-    TestingKey(intptr_t value, uint64_t sharedID = 0) : fValue(value) {
-        this->init(&gGlobalAddress, sharedID, sizeof(fValue));
+    TestingKey(intptr_t value, uint64_t sharedID = 0, void* nameSpace = &gGlobalAddress)
+            : fValue(value) {
+        this->init(nameSpace, sharedID, sizeof(fValue));
     }
 };
 struct TestingRec : public SkResourceCache::Rec {
@@ -150,3 +157,101 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+static constexpr size_t kRecBytes = sizeof(TestingKey) + sizeof(intptr_t);
+
+DEF_TEST(ImageCache_recentlyUsedSurvivesPurge, r) {
+    // Find keys that all land in the same shard, so purging order is plain LRU order.
+    std::vector<TestingKey> keys;
+    const int shard = SkResourceCache::ShardIndexFor(TestingKey(0));
+    for (intptr_t i = 0; keys.size() < 5; ++i) {
+        if (SkResourceCache::ShardIndexFor(TestingKey(i)) == shard) {
+            keys.push_back(TestingKey(i));
+        }
+    }
+
+    SkResourceCache cache(4 * kRecBytes + 1);
+    for (int i = 0; i < 4; ++i) {
+        cache.add(new TestingRec(keys[i], i));
+    }
+
+    // Using keys[0] should save it, so adding one more pushes out keys[1] instead.
+    intptr_t value;
+    REPORTER_ASSERT(r, cache.find(keys[0], TestingRec::Visitor, &value));
+    cache.add(new TestingRec(keys[4], 4));
+
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() == 4 * kRecBytes);
+    REPORTER_ASSERT(r,  cache.find(keys[0], TestingRec::Visitor, &value) && value == 0);
+    REPORTER_ASSERT(r, !cache.find(keys[1], TestingRec::Visitor, &value));
+    for (int i = 2; i < 5; ++i) {
+        REPORTER_ASSERT(r, cache.find(keys[i], TestingRec::Visitor, &value) && value == i);
+    }
+}
+
+DEF_TEST(ImageCache_namespaceByteLimit, r) {
+    SkResourceCache cache(1024 * 1024);
+    for (int i = 0; i < COUNT; ++i) {
+        cache.add(new TestingRec(TestingKey(i, 0, &gOtherAddress), i));
+    }
+    REPORTER_ASSERT(r, cache.getNamespaceBytesUsed(&gOtherAddress) == 0);  // untracked
+
+    // Setting a limit counts what's already there, and purges down to it.
+    REPORTER_ASSERT(r, cache.setNamespaceByteLimit(&gOtherAddress, 4 * kRecBytes) == 0);
+    REPORTER_ASSERT(r, cache.getNamespaceBytesUsed(&gOtherAddress) <= 4 * kRecBytes);
+
+    // Filling the limited namespace doesn't push out anyone else.
+    for (int i = 0; i < COUNT; ++i) {
+        cache.add(new TestingRec(TestingKey(i), i));
+    }
+    for (int i = COUNT; i < 10 * COUNT; ++i) {
+        cache.add(new TestingRec(TestingKey(i, 0, &gOtherAddress), i));
+        REPORTER_ASSERT(r, cache.getNamespaceBytesUsed(&gOtherAddress) <= 4 * kRecBytes);
+    }
+    REPORTER_ASSERT(r, cache.getNamespaceBytesUsed(&gOtherAddress) > 0);
+    for (int i = 0; i < COUNT; ++i) {
+        intptr_t value = -1;
+        REPORTER_ASSERT(r, cache.find(TestingKey(i), TestingRec::Visitor, &value) && value == i);
+    }
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() ==
+                       COUNT * kRecBytes + cache.getNamespaceBytesUsed(&gOtherAddress));
+
+    REPORTER_ASSERT(r, cache.setNamespaceByteLimit(&gOtherAddress, 0) == 4 * kRecBytes);
+    cache.purgeAll();
+    REPORTER_ASSERT(r, cache.getNamespaceBytesUsed(&gOtherAddress) == 0);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() == 0);
+}
+
+DEF_TEST(ImageCache_concurrent, r) {
+    // Small enough that the threads keep purging each other's Recs.
+    SkResourceCache cache(64 * kRecBytes);
+    cache.setNamespaceByteLimit(&gOtherAddress, 16 * kRecBytes);
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkTaskGroup tasks(*executor);
+    std::atomic<bool> ok{true};
+    tasks.batch(8, [&](int thread) {
+        for (int i = 0; i < 2000; ++i) {
+            int k = (i * 7 + thread) % 256;
+            void* nameSpace = (k & 1) ? &gOtherAddress : &gGlobalAddress;
+            TestingKey key(k, k % 3, nameSpace);
+            intptr_t value = -1;
+            if (cache.find(key, TestingRec::Visitor, &value)) {
+                if (value != k) {
+                    ok = false;
+                }
+            } else {
+                cache.add(new TestingRec(key, k));
+            }
+            if (i % 500 == 0) {
+                cache.purgeSharedID(thread % 3 + 1);
+            }
+        }
+    });
+    tasks.wait();
+
+    REPORTER_ASSERT(r, ok);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() < 64 * kRecBytes);
+    REPORTER_ASSERT(r, cache.getNamespaceBytesUsed(&gOtherAddress) <= 16 * kRecBytes);
+    cache.purgeAll();
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() == 0);
+}
@@ -7,6 +7,7 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
@@ -19,6 +20,8 @@
 #include "include/effects/SkPerlinNoiseShader.h"
 #include "include/effects/SkTableColorFilter.h"
 #include "include/gpu/GrDirectContext.h"
+#include "include/private/SkTPin.h"
+#include "include/utils/SkRandom.h"
 #include "src/core/SkColorFilterBase.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkReadBuffer.h"
@@ -1155,6 +1158,133 @@ DEF_TEST(ImageFilterMatrixConvolutionBorder, reporter) {
     canvas.restore();
 }
 
+// The raster path convolves interior pixels N at a time, with separable kernels in two passes, in
+// bands of rows on multiple threads. Check those against convolving one pixel at a time.
+DEF_TEST(ImageFilterMatrixConvolutionInterior, reporter) {
+    const int kW = 512, kH = 384;
+    SkBitmap source;
+    source.allocN32Pixels(kW, kH);
+    SkRandom rand;
+    for (int y = 0; y < kH; y++) {
+        for (int x = 0; x < kW; x++) {
+            *source.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    // Without convolveAlpha the filter convolves unpremultiplied colors.
+    SkBitmap unpremul;
+    unpremul.allocPixels(source.info().makeAlphaType(kUnpremul_SkAlphaType));
+    SkAssertResult(source.readPixels(unpremul.pixmap()));
+
+    struct Kernel {
+        SkISize  size;
+        SkIPoint offset;
+        SkScalar gain, bias;
+        bool     separable;
+        bool     convolveAlpha;
+        SkScalar kernel[49];
+    };
+    std::vector<Kernel> kernels = {
+        // Sharpen.
+        {{3, 3}, {1, 1}, 1, 0, false, true, { 0, -1,  0,
+                                             -1,  5, -1,
+                                              0, -1,  0}},
+        // Emboss, off center.
+        {{3, 3}, {0, 2}, 1, 128, false, true, {-2, -1, 0,
+                                               -1,  1, 1,
+                                                0,  1, 2}},
+        // Binomial blur, the outer product of {1, 4, 6, 4, 1} and {1, 2, 1}.
+        {{5, 3}, {2, 1}, 1 / 64.0f, 0, true, true, {1, 4,  6, 4, 1,
+                                                    2, 8, 12, 8, 2,
+                                                    1, 4,  6, 4, 1}},
+        // Sharpen again, leaving alpha alone.
+        {{3, 3}, {1, 1}, 1, 0, false, false, { 0, -1,  0,
+                                              -1,  5, -1,
+                                               0, -1,  0}},
+    };
+
+    // 7x7 kernels are enough work to split the interior into bands: nine for the direct sum, and
+    // two for the separable one. Cover both with and without alpha.
+    const SkScalar binomial7[] = {1, 6, 15, 20, 15, 6, 1};
+    for (bool separable : {false, true}) {
+        for (bool convolveAlpha : {true, false}) {
+            Kernel k;
+            k.size          = {7, 7};
+            k.offset        = {3, 2};
+            k.gain          = separable ? 1 / 4096.0f : 1 / 8.0f;
+            k.bias          = separable ? 0 : 96;
+            k.separable     = separable;
+            k.convolveAlpha = convolveAlpha;
+            for (int i = 0; i < 49; i++) {
+                k.kernel[i] = separable ? binomial7[i / 7] * binomial7[i % 7]
+                                        : (SkScalar)((i * 37) % 11 - 5);
+            }
+            kernels.push_back(k);
+        }
+    }
+
+    for (const Kernel& k : kernels) {
+        sk_sp<SkImageFilter> filter = SkImageFilters::MatrixConvolution(
+                k.size, k.kernel, k.gain, k.bias, k.offset, SkTileMode::kClamp, k.convolveAlpha,
+                nullptr);
+
+        // The filter may unpremultiply its input in place, so give it a fresh copy each time.
+        SkBitmap bitmap;
+        bitmap.allocPixels(source.info());
+        SkAssertResult(source.readPixels(bitmap.pixmap()));
+        bitmap.setImmutable();
+
+        const SkIRect bounds = bitmap.bounds();
+        SkIRect outSubset;
+        SkIPoint outOffset;
+        sk_sp<SkImage> image = bitmap.asImage()->makeWithFilter(nullptr, filter.get(),
+                                                                bounds, bounds,
+                                                                &outSubset, &outOffset);
+        SkBitmap actual;
+        actual.allocPixels(bitmap.info());
+        if (!image || !image->readPixels(actual.pixmap(), outSubset.x(), outSubset.y())) {
+            ERRORF(reporter, "filter failed");
+            continue;
+        }
+
+        const SkBitmap& input = k.convolveAlpha ? source : unpremul;
+        // Separable kernels sum in a different order, which may round differently.
+        const int tolerance = k.separable ? 1 : 0;
+        int worst = 0;
+        for (int y = k.offset.fY; y < kH - k.size.fHeight + 1 + k.offset.fY; y++) {
+            for (int x = k.offset.fX; x < kW - k.size.fWidth + 1 + k.offset.fX; x++) {
+                float sums[4] = {0, 0, 0, 0};
+                for (int cy = 0; cy < k.size.fHeight; cy++) {
+                    for (int cx = 0; cx < k.size.fWidth; cx++) {
+                        SkPMColor s = *input.getAddr32(x + cx - k.offset.fX,
+                                                       y + cy - k.offset.fY);
+                        float weight = k.kernel[cy * k.size.fWidth + cx];
+                        sums[0] += SkGetPackedA32(s) * weight;
+                        sums[1] += SkGetPackedR32(s) * weight;
+                        sums[2] += SkGetPackedG32(s) * weight;
+                        sums[3] += SkGetPackedB32(s) * weight;
+                    }
+                }
+                int a = k.convolveAlpha ? SkTPin(SkScalarFloorToInt(sums[0] * k.gain + k.bias),
+                                                 0, 255)
+                                        : 255;
+                int r = SkTPin(SkScalarFloorToInt(sums[1] * k.gain + k.bias), 0, a),
+                    g = SkTPin(SkScalarFloorToInt(sums[2] * k.gain + k.bias), 0, a),
+                    b = SkTPin(SkScalarFloorToInt(sums[3] * k.gain + k.bias), 0, a);
+                SkPMColor expected = k.convolveAlpha
+                        ? SkPackARGB32(a, r, g, b)
+                        : SkPreMultiplyARGB(SkGetPackedA32(*input.getAddr32(x, y)), r, g, b);
+                SkPMColor got = *actual.getAddr32(x, y);
+                for (int shift : {0, 8, 16, 24}) {
+                    worst = std::max(worst, std::abs((int)((expected >> shift) & 0xff) -
+                                                     (int)((got >> shift) & 0xff)));
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, worst <= tolerance, "%dx%d kernel, convolveAlpha %d, off by %d",
+                        k.size.fWidth, k.size.fHeight, k.convolveAlpha, worst);
+    }
+}
+
 static void test_big_kernel(skiatest::Reporter* reporter, GrRecordingContext* rContext) {
     // Check that a kernel that is too big for the GPU still works
     SkScalar identityKernel[49] = {
@@ -2081,3 +2211,60 @@ DEF_TEST(DropShadowImageFilter_Huge, reporter) {
     surf->getCanvas()->saveLayer(nullptr, &paint);
     surf->getCanvas()->restore();
 }
+
+// Large raster blurs are split into bands that run in parallel. Each row of a horizontal blur, and
+// each column of a vertical one, should come out the same as it does when blurred on its own.
+DEF_TEST(BlurImageFilter_Bands, reporter) {
+    const int kW = 600, kH = 400;
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kW, kH);
+    SkRandom rand;
+    for (int y = 0; y < kH; y++) {
+        for (int x = 0; x < kW; x++) {
+            *bitmap.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    bitmap.setImmutable();
+
+    auto blur = [](const SkBitmap& src, const SkImageFilter* filter) {
+        const SkIRect bounds = src.bounds();
+        SkIRect outSubset;
+        SkIPoint offset;
+        sk_sp<SkImage> image = src.asImage()->makeWithFilter(nullptr, filter, bounds, bounds,
+                                                             &outSubset, &offset);
+        SkBitmap dst;
+        dst.allocPixels(src.info());
+        if (!image || outSubset.size() != bounds.size() ||
+            !image->readPixels(dst.pixmap(), outSubset.x(), outSubset.y())) {
+            return SkBitmap();
+        }
+        return dst;
+    };
+
+    for (float sigma : {2.0f, 25.0f}) {
+        sk_sp<SkImageFilter> blurX = SkImageFilters::Blur(sigma, 0, nullptr),
+                             blurY = SkImageFilters::Blur(0, sigma, nullptr);
+
+        SkBitmap wholeX = blur(bitmap, blurX.get());
+        REPORTER_ASSERT(reporter, !wholeX.drawsNothing());
+        for (int y = 0; y < kH && !wholeX.drawsNothing(); y += 37) {
+            SkBitmap row, expected, actual;
+            bitmap.extractSubset(&row, SkIRect::MakeXYWH(0, y, kW, 1));
+            expected = blur(row, blurX.get());
+            wholeX.extractSubset(&actual, SkIRect::MakeXYWH(0, y, kW, 1));
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual),
+                            "sigma %g, row %d", sigma, y);
+        }
+
+        SkBitmap wholeY = blur(bitmap, blurY.get());
+        REPORTER_ASSERT(reporter, !wholeY.drawsNothing());
+        for (int x = 0; x < kW && !wholeY.drawsNothing(); x += 41) {
+            SkBitmap column, expected, actual;
+            bitmap.extractSubset(&column, SkIRect::MakeXYWH(x, 0, 1, kH));
+            expected = blur(column, blurY.get());
+            wholeY.extractSubset(&actual, SkIRect::MakeXYWH(x, 0, 1, kH));
+            REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual),
+                            "sigma %g, column %d", sigma, x);
+        }
+    }
+}
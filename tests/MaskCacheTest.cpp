@@ -36,9 +36,10 @@ DEF_TEST(RRectMaskCache, reporter) {
     SkRRect rrect;
     rrect.setRectXY(rect, 30, 30);
     SkBlurStyle style = kNormal_SkBlurStyle;
+    SkMaskBlurFilter::Quality quality = SkMaskBlurFilter::Quality::kExact;
     SkMask mask;
 
-    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, rrect, &mask, &cache);
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, quality, rrect, &mask, &cache);
     REPORTER_ASSERT(reporter, nullptr == data);
 
     size_t size = 256;
@@ -47,14 +48,19 @@ DEF_TEST(RRectMaskCache, reporter) {
     mask.fBounds.setXYWH(0, 0, 100, 100);
     mask.fRowBytes = 100;
     mask.fFormat = SkMask::kBW_Format;
-    SkMaskCache::Add(sigma, style, rrect, mask, data, &cache);
+    SkMaskCache::Add(sigma, style, quality, rrect, mask, data, &cache);
     check_data(reporter, data, 2, kInCache, kLocked);
 
     data->unref();
     check_data(reporter, data, 1, kInCache, kUnlocked);
 
+    // An approximate blur of the same shape must not pick up the exact mask.
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style,
+                                                       SkMaskBlurFilter::Quality::kFastApproximate,
+                                                       rrect, &mask, &cache));
+
     sk_bzero(&mask, sizeof(mask));
-    data = SkMaskCache::FindAndRef(sigma, style, rrect, &mask, &cache);
+    data = SkMaskCache::FindAndRef(sigma, style, quality, rrect, &mask, &cache);
     REPORTER_ASSERT(reporter, data);
     REPORTER_ASSERT(reporter, data->size() == size);
     REPORTER_ASSERT(reporter, mask.fBounds.top() == 0 && mask.fBounds.bottom() == 100);
@@ -73,9 +79,10 @@ DEF_TEST(RectsMaskCache, reporter) {
     SkRect rect = SkRect::MakeWH(100, 100);
     SkRect rects[2] = {rect};
     SkBlurStyle style = kNormal_SkBlurStyle;
+    SkMaskBlurFilter::Quality quality = SkMaskBlurFilter::Quality::kExact;
     SkMask mask;
 
-    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, rects, 1, &mask, &cache);
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, quality, rects, 1, &mask, &cache);
     REPORTER_ASSERT(reporter, nullptr == data);
 
     size_t size = 256;
@@ -84,14 +91,19 @@ DEF_TEST(RectsMaskCache, reporter) {
     mask.fBounds.setXYWH(0, 0, 100, 100);
     mask.fRowBytes = 100;
     mask.fFormat = SkMask::kBW_Format;
-    SkMaskCache::Add(sigma, style, rects, 1, mask, data, &cache);
+    SkMaskCache::Add(sigma, style, quality, rects, 1, mask, data, &cache);
     check_data(reporter, data, 2, kInCache, kLocked);
 
     data->unref();
     check_data(reporter, data, 1, kInCache, kUnlocked);
 
+    // An approximate blur of the same shape must not pick up the exact mask.
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style,
+                                                       SkMaskBlurFilter::Quality::kFastApproximate,
+                                                       rects, 1, &mask, &cache));
+
     sk_bzero(&mask, sizeof(mask));
-    data = SkMaskCache::FindAndRef(sigma, style, rects, 1, &mask, &cache);
+    data = SkMaskCache::FindAndRef(sigma, style, quality, rects, 1, &mask, &cache);
     REPORTER_ASSERT(reporter, data);
     REPORTER_ASSERT(reporter, data->size() == size);
     REPORTER_ASSERT(reporter, mask.fBounds.top() == 0 && mask.fBounds.bottom() == 100);
@@ -6,6 +6,8 @@
  */
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
+#include "include/private/SkHalf.h"
 #include "include/utils/SkRandom.h"
 #include "src/core/SkMipmap.h"
 #include "tests/Test.h"
@@ -211,6 +213,55 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+// The SkOpts downsamplers and threaded builds must match the portable code bit for bit.
+DEF_TEST(MipMap_OptsMatchPortable, reporter) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    SkMipmap::BuildOptions portable;
+    portable.fAllowOpts = false;
+    SkMipmap::BuildOptions opts;
+    opts.fExecutor = executor.get();
+
+    SkRandom rand;
+    for (SkColorType ct : {kRGBA_8888_SkColorType, kRGBA_F16_SkColorType, kAlpha_8_SkColorType}) {
+        for (SkISize size : {SkISize{512, 512}, SkISize{1037, 517}, SkISize{3, 1024},
+                             SkISize{2048, 6}}) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, ct, kPremul_SkAlphaType));
+            for (int y = 0; y < bm.height(); ++y) {
+                if (ct == kRGBA_F16_SkColorType) {
+                    auto row = (SkHalf*)bm.getAddr(0, y);
+                    for (int x = 0; x < 4 * bm.width(); ++x) {
+                        row[x] = SkFloatToHalf(rand.nextRangeF(-2, 2));
+                    }
+                } else {
+                    auto row = (uint8_t*)bm.getAddr(0, y);
+                    for (size_t x = 0; x < bm.info().minRowBytes(); ++x) {
+                        row[x] = (uint8_t)rand.nextU();
+                    }
+                }
+            }
+
+            sk_sp<SkMipmap> expected(SkMipmap::Build(bm.pixmap(), nullptr, true, portable)),
+                            actual  (SkMipmap::Build(bm.pixmap(), nullptr, true, opts));
+            REPORTER_ASSERT(reporter, expected && actual);
+            REPORTER_ASSERT(reporter, expected->countLevels() == actual->countLevels());
+
+            for (int i = 0; i < expected->countLevels(); ++i) {
+                SkMipmap::Level e, a;
+                SkAssertResult(expected->getLevel(i, &e));
+                SkAssertResult(actual->getLevel(i, &a));
+                for (int y = 0; y < e.fPixmap.height(); ++y) {
+                    REPORTER_ASSERT(reporter, !memcmp(e.fPixmap.addr(0, y), a.fPixmap.addr(0, y),
+                                                      e.fPixmap.info().minRowBytes()),
+                                    "ct %d, %dx%d, level %d, row %d",
+                                    ct, size.width(), size.height(), i, y);
+                }
+            }
+        }
+    }
+}
+
 #include "include/core/SkCanvas.h"
 #include "include/core/SkSurface.h"
 #include "src/core/SkMipmapBuilder.h"
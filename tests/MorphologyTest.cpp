@@ -0,0 +1,87 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/utils/SkRandom.h"
+#include "src/core/SkOpts.h"
+#include "tests/Test.h"
+
+#include <algorithm>
+#include <vector>
+
+// The straightforward morphology SkMorphologyImageFilter used to do, scanning the whole window
+// for every pixel, one byte per channel. SkOpts' morphology procs must match it exactly.
+template <typename T>
+static void morph_reference(bool dilate, bool alongX, const T* src, T* dst, int radius,
+                            int width, int height, int srcStride, int dstStride) {
+    const int srcStrideX = alongX ? 1 : srcStride,
+              dstStrideX = alongX ? 1 : dstStride,
+              srcStrideY = alongX ? srcStride : 1,
+              dstStrideY = alongX ? dstStride : 1;
+    radius = std::min(radius, width - 1);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const int lo = std::max(0, x - radius),
+                      hi = std::min(width - 1, x + radius);
+            T result = 0;
+            for (int byte = 0; byte < (int)sizeof(T); byte++) {
+                int extreme = dilate ? 0 : 255;
+                for (int i = lo; i <= hi; i++) {
+                    int v = (src[y * srcStrideY + i * srcStrideX] >> (8 * byte)) & 0xff;
+                    extreme = dilate ? std::max(extreme, v) : std::min(extreme, v);
+                }
+                result |= (T)extreme << (8 * byte);
+            }
+            dst[y * dstStrideY + x * dstStrideX] = result;
+        }
+    }
+}
+
+template <typename T, typename Proc>
+static void test_morph_proc(skiatest::Reporter* r, const char* name, Proc proc,
+                            bool dilate, bool alongX) {
+    SkRandom rand;
+    // Widths and heights cover single pixels, lines shorter than the window, and partial
+    // groups of lines; radii cover 1 up to past the length of a line.
+    for (int w : {1, 2, 7, 31, 100}) {
+        for (int h : {1, 3, 17, 40}) {
+            for (int radius : {1, 2, 5, 13, 40, 120}) {
+                const int srcStride = w + 3,
+                          dstStride = w + 5;
+                std::vector<T> src(srcStride * h), expected(dstStride * h), actual(dstStride * h);
+                for (T& px : src) {
+                    px = (T)rand.nextU();
+                }
+
+                // The procs take the length of a line as width and the number of lines as height.
+                const int length = alongX ? w : h,
+                          lines  = alongX ? h : w;
+                morph_reference(dilate, alongX, src.data(), expected.data(), radius,
+                                length, lines, srcStride, dstStride);
+                proc(src.data(), actual.data(), radius, length, lines, srcStride, dstStride);
+
+                bool match = true;
+                for (int y = 0; y < h; y++) {
+                    for (int x = 0; x < w; x++) {
+                        match &= expected[y * dstStride + x] == actual[y * dstStride + x];
+                    }
+                }
+                REPORTER_ASSERT(r, match, "%s %dx%d radius %d", name, w, h, radius);
+            }
+        }
+    }
+}
+
+DEF_TEST(Morphology_Procs, r) {
+    test_morph_proc<uint32_t>(r, "dilate_x_8888", SkOpts::dilate_x_8888, true,  true);
+    test_morph_proc<uint32_t>(r, "dilate_y_8888", SkOpts::dilate_y_8888, true,  false);
+    test_morph_proc<uint32_t>(r, "erode_x_8888",  SkOpts::erode_x_8888,  false, true);
+    test_morph_proc<uint32_t>(r, "erode_y_8888",  SkOpts::erode_y_8888,  false, false);
+    test_morph_proc<uint8_t> (r, "dilate_x_A8",   SkOpts::dilate_x_A8,   true,  true);
+    test_morph_proc<uint8_t> (r, "dilate_y_A8",   SkOpts::dilate_y_A8,   true,  false);
+    test_morph_proc<uint8_t> (r, "erode_x_A8",    SkOpts::erode_x_A8,    false, true);
+    test_morph_proc<uint8_t> (r, "erode_y_A8",    SkOpts::erode_y_A8,    false, false);
+}
@@ -6,6 +6,7 @@
  */
 
 #include "include/utils/SkRandom.h"
+#include "src/core/SkPackedBVH.h"
 #include "src/core/SkRTree.h"
 #include "tests/Test.h"
 
@@ -44,7 +45,7 @@ static bool verify_query(SkRect query, SkRect rects[], const std::vector<int>& f
 }
 
 static void run_queries(skiatest::Reporter* reporter, SkRandom& rand, SkRect rects[],
-                        const SkRTree& tree) {
+                        const SkBBoxHierarchy& tree) {
     for (size_t i = 0; i < NUM_QUERIES; ++i) {
         std::vector<int> hits;
         SkRect query = random_rect(rand);
@@ -89,3 +90,54 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(PackedBVH, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        SkPackedBVH bvh;
+        REPORTER_ASSERT(reporter, 0 == bvh.getCount());
+
+        for (int j = 0; j < NUM_RECTS; j++) {
+            rects[j] = random_rect(rand);
+        }
+
+        bvh.insert(rects.get(), NUM_RECTS);
+        run_queries(reporter, rand, rects, bvh);
+        REPORTER_ASSERT(reporter, NUM_RECTS == bvh.getCount());
+        // 200 rects need 25 leaves, 4 nodes above them, then the root.
+        REPORTER_ASSERT(reporter, 3 == bvh.getDepth());
+    }
+}
+
+DEF_TEST(PackedBVH_MatchesRTree, reporter) {
+    SkRandom rand;
+    for (int count : {0, 1, 7, 8, 9, 64, 65, 513, 4000}) {
+        std::vector<SkRect> rects(count);
+        for (SkRect& r : rects) {
+            r = random_rect(rand);
+            // Empty bounds aren't inserted; skip some to check indices stay right.
+            if (rand.nextU() % 8 == 0) {
+                r.fRight = r.fLeft;
+            }
+        }
+
+        SkRTree rtree;
+        SkPackedBVH bvh;
+        rtree.insert(rects.data(), count);
+        bvh.insert(rects.data(), count);
+        REPORTER_ASSERT(reporter, rtree.getCount() == bvh.getCount());
+
+        for (size_t i = 0; i < NUM_QUERIES; ++i) {
+            SkRect query = random_rect(rand);
+            // SkRect::Intersects() ignores NaN edges; so should we.
+            if (i % 10 == 0) {
+                (&query.fLeft)[i % 4] = SK_ScalarNaN;
+            }
+            std::vector<int> expected, found;
+            rtree.search(query, &expected);
+            bvh.search(query, &found);
+            REPORTER_ASSERT(reporter, expected == found, "count %d", count);
+        }
+    }
+}
@@ -11,6 +11,9 @@
 #include "src/gpu/Swizzle.h"
 #include "tests/Test.h"
 
+#include <algorithm>
+#include <iterator>
+
 DEF_TEST(SkRasterPipeline, r) {
     // Build and run a simple pipeline to exercise SkRasterPipeline,
     // drawing 50% transparent blue over opaque red in half-floats.
@@ -568,3 +571,108 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_fusion, r) {
+    // An odd width, so we exercise the tail too.
+    constexpr int kWidth = 67;
+    uint32_t src[kWidth], dst[kWidth];
+    uint8_t  coverage[kWidth];
+    for (int i = 0; i < kWidth; i++) {
+        src[i]      = (4*i+0) << 0 | (4*i+1) << 8 | (4*i+2) << 16 | (3*i) << 24;
+        dst[i]      = (255-2*i) << 0 | (3*i) << 8 | (i) << 16 | 0xffu << 24;
+        coverage[i] = (uint8_t)(7*i);
+    }
+
+    // Builds each pipeline with every stage followed by a pair of swap_src_dst, which does
+    // nothing but keeps any run of stages from being fused, or without them so runs are fused.
+    // A trailing negate_x, which lowp doesn't implement, forces the pipeline into highp.
+    struct Builder {
+        SkRasterPipeline* p;
+        bool fuse;
+        void append(SkRasterPipeline::StockStage stage, const void* ctx = nullptr) {
+            p->append(stage, ctx);
+            if (!fuse) {
+                p->append(SkRasterPipeline::swap_src_dst);
+                p->append(SkRasterPipeline::swap_src_dst);
+            }
+        }
+    };
+
+    for (bool highp : {false, true}) {
+        // A BGRA srcover with coverage: 8 stages that fuse into 3.
+        auto blend = [&](bool fuse, uint32_t* out, int* fusedRuns) {
+            memcpy(out, dst, sizeof(dst));
+            SkRasterPipeline_MemoryCtx srcCtx = {src, 0},
+                                       dstCtx = {out, 0},
+                                       covCtx = {coverage, 0};
+            SkRasterPipeline_<256> p;
+            Builder b = {&p, fuse};
+            b.append(SkRasterPipeline::load_8888, &srcCtx);
+            b.append(SkRasterPipeline::swap_rb);
+            b.append(SkRasterPipeline::load_8888_dst, &dstCtx);
+            b.append(SkRasterPipeline::swap_rb_dst);
+            b.append(SkRasterPipeline::srcover);
+            b.append(SkRasterPipeline::lerp_u8, &covCtx);
+            b.append(SkRasterPipeline::swap_rb);
+            b.append(SkRasterPipeline::store_8888, &dstCtx);
+            if (highp) {
+                p.append(SkRasterPipeline::negate_x);
+            }
+            p.run(0,0,kWidth,1);
+            p.getFusedRuns(fusedRuns);
+        };
+
+        // Fused geometry stages, followed by stages that aren't part of any fused run.
+        auto shade = [&](bool fuse, uint32_t* out, int* fusedRuns) {
+            const float scaleTrans[] = {1/64.0f, 1/8.0f, 0.25f, 0.0f};
+            SkRasterPipeline_MemoryCtx outCtx = {out, 0};
+            SkRasterPipeline_<256> p;
+            Builder b = {&p, fuse};
+            b.append(SkRasterPipeline::seed_shader);
+            b.append(SkRasterPipeline::matrix_scale_translate, scaleTrans);
+            b.append(SkRasterPipeline::clamp_0);
+            b.append(SkRasterPipeline::clamp_1);
+            b.append(SkRasterPipeline::store_8888, &outCtx);
+            if (highp) {
+                p.append(SkRasterPipeline::negate_x);
+            }
+            p.compile()(0,0,kWidth,1);
+            p.getFusedRuns(fusedRuns);
+        };
+
+        // The runs each pipeline should fuse, per fused stage; unfused builds should fuse none.
+        int blendRuns[SkRasterPipeline::kNumFusedStages] = {},
+            shadeRuns[SkRasterPipeline::kNumFusedStages] = {},
+            noRuns   [SkRasterPipeline::kNumFusedStages] = {};
+        blendRuns[SkRasterPipeline::load_8888_swap_rb]                 = 1;
+        blendRuns[SkRasterPipeline::load_8888_dst_swap_rb_dst_srcover] = 1;
+        blendRuns[SkRasterPipeline::lerp_u8_swap_rb_store_8888]        = 1;
+        shadeRuns[SkRasterPipeline::seed_shader_matrix_scale_translate] = 1;
+
+        uint32_t want[kWidth], got[kWidth];
+        for (int pipeline = 0; pipeline < 2; pipeline++) {
+            auto fusesExactly = [&](bool fuse, uint32_t* out,
+                                    const int (&runs)[SkRasterPipeline::kNumFusedStages]) {
+                int fusedRuns[SkRasterPipeline::kNumFusedStages];
+                if (pipeline == 0) {
+                    blend(fuse, out, fusedRuns);
+                } else {
+                    shade(fuse, out, fusedRuns);
+                }
+                return std::equal(std::begin(fusedRuns), std::end(fusedRuns), std::begin(runs));
+            };
+
+            REPORTER_ASSERT(r, fusesExactly(false, want, noRuns),
+                            "highp %d, pipeline %d fused stages it should not have",
+                            highp, pipeline);
+            REPORTER_ASSERT(r, fusesExactly(true, got, pipeline == 0 ? blendRuns : shadeRuns),
+                            "highp %d, pipeline %d did not fuse the expected runs",
+                            highp, pipeline);
+            for (int i = 0; i < kWidth; i++) {
+                REPORTER_ASSERT(r, got[i] == want[i],
+                                "highp %d, pipeline %d, pixel %d: got %08x, want %08x",
+                                highp, pipeline, i, got[i], want[i]);
+            }
+        }
+    }
+}
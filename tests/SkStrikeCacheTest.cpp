@@ -5,11 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 
+#include <vector>
+
 DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
     SkStrikeCache cache;
 
@@ -51,3 +55,43 @@ DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
 
 
 }
+
+DEF_TEST(SkStrikeCache_ConcurrentLookup, Reporter) {
+    SkStrikeCache cache;
+
+    sk_sp<SkTypeface> typeface =
+            ToolUtils::create_portable_typeface("serif", SkFontStyle::Normal());
+
+    std::vector<SkStrikeSpec> specs;
+    for (int size = 1; size <= 64; size++) {
+        SkFont font(typeface, size);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        specs.push_back(SkStrikeSpec::MakeMask(
+                font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I()));
+    }
+
+    // Every thread looks up every strike; each should be created exactly once.
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    std::vector<SkStrike*> strikes(specs.size() * 8);
+    SkTaskGroup tasks(*executor);
+    tasks.batch((int)strikes.size(), [&](int i) {
+        sk_sp<SkStrike> strike = specs[i % specs.size()].findOrCreateStrike(&cache);
+        strikes[i] = strike.get();
+    });
+    tasks.wait();
+
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == (int)specs.size());
+    for (size_t i = specs.size(); i < strikes.size(); i++) {
+        REPORTER_ASSERT(Reporter, strikes[i] == strikes[i % specs.size()]);
+    }
+
+    // The count budget applies across all the shards.
+    cache.setCacheCountLimit(16);
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() <= 16);
+    REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() > 0);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() == 0);
+}
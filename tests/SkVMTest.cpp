@@ -5,11 +5,18 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkStream.h"
+#include "include/effects/SkGradientShader.h"
 #include "include/private/SkColorData.h"
+#include "src/core/SkArenaAlloc.h"
+#include "src/core/SkAutoMalloc.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkMSAN.h"
+#include "src/core/SkMatrixProvider.h"
 #include "src/core/SkVM.h"
+#include "src/core/SkVMBlitter.h"
 #include "src/gpu/ganesh/GrShaderCaps.h"
 #include "src/sksl/SkSLCompiler.h"
 #include "src/sksl/codegen/SkSLVMCodeGenerator.h"
@@ -2895,3 +2902,118 @@ DEF_TEST(SkVM_Visualizer, r) {
                        "<tr class='source'><td class='mask'>&#8617;v9</td>"
                        "<td colspan=2>int main(int x, int y)</td></tr>"));
 }
+
+DEF_TEST(SkVM_BlitterProgramCache, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    SkPixmap pixmap;
+    SkAssertResult(bitmap.peekPixels(&pixmap));
+
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    const SkMatrixProvider matrices{SkMatrix::I()};
+    auto blit_row = [&] {
+        SkSTArenaAlloc<256> alloc;
+        SkBlitter* blitter = SkVMBlitter::Make(pixmap, paint, matrices, &alloc, nullptr);
+        REPORTER_ASSERT(r, blitter);
+        blitter->blitH(0, 0, 16);
+    };
+
+    // Other threads may be using SkVMBlitter too, so keep this test's programs to itself.
+    SkVMBlitter::ScopedPrivateProgramCache privateCache;
+    blit_row();
+    blit_row();
+    SkVMBlitter::ProgramCacheStats stats = SkVMBlitter::GetProgramCacheStats();
+    REPORTER_ASSERT(r, stats.misses == 1 && stats.hits == 1, "%d misses, %d hits",
+                    stats.misses, stats.hits);
+    REPORTER_ASSERT(r, *bitmap.getAddr32(7, 0) == SkPreMultiplyColor(SK_ColorRED));
+
+    // Round trip the cache, as if through a file, and the program shouldn't need to be rebuilt.
+    SkDynamicMemoryWStream stream;
+    const int saved = SkVMBlitter::SaveProgramCache(&stream);
+    REPORTER_ASSERT(r, saved == 1);
+    sk_sp<SkData> data = stream.detachAsData();
+
+    SkVMBlitter::PurgeProgramCache();
+    SkMemoryStream in(data);
+    REPORTER_ASSERT(r, SkVMBlitter::LoadProgramCache(&in) == saved);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+
+    // The first blitter to find a loaded program must still build it to check it, so that's a
+    // miss; after that, the loaded program is a hit like any other.
+    blit_row();
+    stats = SkVMBlitter::GetProgramCacheStats();
+    REPORTER_ASSERT(r, stats.loaded == 1 && stats.verified == 1 && stats.misses == 1 &&
+                       stats.hits == 0,
+                    "%d loaded, %d verified, %d misses, %d hits",
+                    stats.loaded, stats.verified, stats.misses, stats.hits);
+    blit_row();
+    stats = SkVMBlitter::GetProgramCacheStats();
+    REPORTER_ASSERT(r, stats.verified == 1 && stats.misses == 1 && stats.hits == 1,
+                    "%d verified, %d misses, %d hits", stats.verified, stats.misses, stats.hits);
+    REPORTER_ASSERT(r, *bitmap.getAddr32(7, 0) == SkPreMultiplyColor(SK_ColorRED));
+
+    // Truncated or foreign data loads nothing.
+    SkMemoryStream truncated(data->data(), data->size() - 1);
+    REPORTER_ASSERT(r, SkVMBlitter::LoadProgramCache(&truncated) == 0);
+    SkMemoryStream garbage(data->bytes() + 4, data->size() - 4);
+    REPORTER_ASSERT(r, SkVMBlitter::LoadProgramCache(&garbage) == 0);
+}
+
+DEF_TEST(SkVM_BlitterProgramCacheCorrupt, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    SkPixmap pixmap;
+    SkAssertResult(bitmap.peekPixels(&pixmap));
+
+    // A gradient, so the program reads uniforms and not just constants.
+    const SkPoint pts[] = {{0, 0}, {16, 0}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    SkPaint paint;
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+    const SkMatrixProvider matrices{SkMatrix::I()};
+    auto blit_row = [&] {
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkSTArenaAlloc<256> alloc;
+        SkBlitter* blitter = SkVMBlitter::Make(pixmap, paint, matrices, &alloc, nullptr);
+        REPORTER_ASSERT(r, blitter);
+        blitter->blitH(0, 0, 16);
+        return *bitmap.getAddr32(7, 0);
+    };
+
+    SkVMBlitter::ScopedPrivateProgramCache privateCache;
+    const SkPMColor expected = blit_row();
+    SkDynamicMemoryWStream stream;
+    const int saved = SkVMBlitter::SaveProgramCache(&stream);
+    REPORTER_ASSERT(r, saved == 1);
+    sk_sp<SkData> data = stream.detachAsData();
+
+    // Every truncation loads nothing.
+    for (size_t len = 0; len < data->size(); len++) {
+        SkMemoryStream truncated(data->data(), len);
+        REPORTER_ASSERT(r, SkVMBlitter::LoadProgramCache(&truncated) == 0, "%zu", len);
+    }
+
+    // A flipped bit either makes the file unloadable, or (say, in a Key or a constant) still
+    // describes a well-formed program.  Those must never be used to draw.
+    SkAutoMalloc storage(data->size());
+    auto* bytes = static_cast<uint8_t*>(storage.get());
+    int rejected = 0;
+    for (size_t i = 0; i < data->size(); i++) {
+        memcpy(bytes, data->data(), data->size());
+        bytes[i] ^= 1 << (i % 8);
+
+        SkVMBlitter::PurgeProgramCache();
+        SkMemoryStream flipped(bytes, data->size());
+        const int loaded = SkVMBlitter::LoadProgramCache(&flipped);
+        REPORTER_ASSERT(r, loaded == 0 || loaded == saved, "%zu: %d", i, loaded);
+        rejected += (loaded == 0);
+        REPORTER_ASSERT(r, blit_row() == expected, "%zu", i);
+
+        // Whatever loaded, the blitter had to build its own program to check it against.
+        const SkVMBlitter::ProgramCacheStats stats = SkVMBlitter::GetProgramCacheStats();
+        REPORTER_ASSERT(r, stats.hits == 0 && stats.misses == 1, "%zu: %d hits, %d misses",
+                        i, stats.hits, stats.misses);
+    }
+    REPORTER_ASSERT(r, rejected > 0);
+}
@@ -1183,3 +1183,58 @@ DEF_TEST(surface_image_unity, reporter) {
         }
     }
 }
+
+DEF_TEST(SurfaceDamageTracking, reporter) {
+    auto surface = SkSurface::MakeRasterN32Premul(200, 200);
+    SkCanvas* canvas = surface->getCanvas();
+    SkRegion damage;
+
+    REPORTER_ASSERT(reporter, !surface->enableDamageTracking(0));
+    REPORTER_ASSERT(reporter, surface->enableDamageTracking(64));
+    surface->takeDamage(&damage);
+    REPORTER_ASSERT(reporter, damage.isEmpty());
+
+    // A small rect damages only the tile it lands in; one straddling a tile edge damages both.
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 20, 20), SkPaint());
+    canvas->drawRect(SkRect::MakeXYWH(150, 100, 20, 40), SkPaint());
+    surface->takeDamage(&damage);
+    SkRegion expected;
+    expected.op(SkIRect::MakeLTRB(0, 0, 64, 64), SkRegion::kUnion_Op);
+    expected.op(SkIRect::MakeLTRB(128, 64, 192, 192), SkRegion::kUnion_Op);
+    REPORTER_ASSERT(reporter, damage == expected);
+
+    // Nothing drawn since the last frame.
+    surface->takeDamage(&damage);
+    REPORTER_ASSERT(reporter, damage.isEmpty());
+
+    // Clipped draws only damage their clip, and damage is clipped to the surface.
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(130, 130, 200, 200));
+    canvas->drawPaint(SkPaint());
+    canvas->restore();
+    surface->takeDamage(&damage);
+    REPORTER_ASSERT(reporter, damage == SkRegion(SkIRect::MakeLTRB(128, 128, 200, 200)));
+
+    // Layers damage what they cover when they're drawn back.
+    canvas->saveLayer(nullptr, nullptr);
+    canvas->drawRect(SkRect::MakeXYWH(70, 70, 10, 10), SkPaint());
+    canvas->restore();
+    surface->takeDamage(&damage);
+    REPORTER_ASSERT(reporter, damage.contains(SkIRect::MakeLTRB(64, 64, 128, 128)));
+
+    SkBitmap bm;
+    bm.allocN32Pixels(4, 4);
+    bm.eraseColor(SK_ColorRED);
+    surface->writePixels(bm, 190, 0);
+    surface->takeDamage(&damage);
+    REPORTER_ASSERT(reporter, damage == SkRegion(SkIRect::MakeLTRB(128, 0, 200, 64)));
+}
+
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(SurfaceDamageTracking_Gpu, reporter, ctxInfo) {
+    auto surface = create_gpu_surface(ctxInfo.directContext());
+    REPORTER_ASSERT(reporter, !surface->enableDamageTracking());
+
+    SkRegion damage(SkIRect::MakeWH(10, 10));
+    surface->takeDamage(&damage);
+    REPORTER_ASSERT(reporter, damage.isEmpty());
+}
@@ -152,3 +152,51 @@ DEF_TEST(PublicSwizzleOpts, r) {
     SkSwapRB(&dst, &src, 1);
     REPORTER_ASSERT(r, dst == 0xFA04B0CE);
 }
+
+DEF_TEST(SwizzleOpts16AndIndex, r) {
+    // Big-endian 16-bit components, so the high byte comes first.  Each count covers some of
+    // the SIMD loops plus a tail.
+    constexpr int kMaxCount = 37;
+    uint8_t src[kMaxCount * 8];
+    for (int i = 0; i < (int)sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 37 + 11);
+    }
+    uint32_t table[256];
+    for (int i = 0; i < 256; i++) {
+        table[i] = (uint32_t)i * 0x01020304;
+    }
+
+    auto premul = [](uint32_t c) {
+        uint32_t a = c >> 24;
+        return a << 24 | ((c >> 16 & 0xFF) * a + 127) / 255 << 16
+                       | ((c >>  8 & 0xFF) * a + 127) / 255 <<  8
+                       | ((c >>  0 & 0xFF) * a + 127) / 255 <<  0;
+    };
+
+    for (int count : {1, 3, 4, 8, 9, 16, 17, kMaxCount}) {
+        uint32_t dst[kMaxCount];
+        auto check = [&](SkOpts::Swizzle_8888_u8 fn, int bpp, bool swapRB, bool hasAlpha,
+                         bool premultiply) {
+            fn(dst, src, count);
+            for (int i = 0; i < count; i++) {
+                const uint8_t* p = src + i * bpp;
+                uint32_t a = hasAlpha ? p[6] : 0xFF;
+                uint32_t c = a << 24 | (uint32_t)(swapRB ? p[0] : p[4]) << 16
+                                     | (uint32_t)p[2] << 8
+                                     | (uint32_t)(swapRB ? p[4] : p[0]);
+                REPORTER_ASSERT(r, dst[i] == (premultiply ? premul(c) : c));
+            }
+        };
+        check(SkOpts::RGB16_to_RGB1,  6, false, false, false);
+        check(SkOpts::RGB16_to_BGR1,  6,  true, false, false);
+        check(SkOpts::RGBA16_to_RGBA, 8, false,  true, false);
+        check(SkOpts::RGBA16_to_BGRA, 8,  true,  true, false);
+        check(SkOpts::RGBA16_to_rgbA, 8, false,  true,  true);
+        check(SkOpts::RGBA16_to_bgrA, 8,  true,  true,  true);
+
+        SkOpts::index_to_8888(dst, src, count, table);
+        for (int i = 0; i < count; i++) {
+            REPORTER_ASSERT(r, dst[i] == table[src[i]]);
+        }
+    }
+}
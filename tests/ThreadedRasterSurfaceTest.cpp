@@ -0,0 +1,175 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRect.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/effects/SkImageFilters.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkThreadedRasterSurface.h"
+#include "tests/Test.h"
+#include "tools/ToolUtils.h"
+
+#include <cstdlib>
+
+static void draw_scene(SkCanvas* canvas, bool antiAlias) {
+    canvas->clear(SK_ColorWHITE);
+
+    SkRandom rand;
+    SkPaint paint;
+    for (int i = 0; i < 200; i++) {
+        paint.setColor(rand.nextU() | 0x80000000);
+        paint.setAntiAlias(rand.nextBool() && antiAlias);
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeF(-20, 300), rand.nextRangeF(-20, 200),
+                                    rand.nextRangeF(1, 80), rand.nextRangeF(1, 80));
+        canvas->drawRect(r, paint);
+    }
+
+    const SkPoint pts[] = {{0, 40}, {0, 160}};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+    paint.setAntiAlias(false);
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+    canvas->drawRect(SkRect::MakeXYWH(30, 40, 250, 120), paint);
+    paint.setShader(nullptr);
+
+    SkBitmap src;
+    src.allocN32Pixels(37, 23);
+    src.eraseColor(SK_ColorGREEN);
+    src.erase(SK_ColorMAGENTA, SkIRect::MakeXYWH(5, 5, 20, 10));
+    canvas->save();
+    canvas->translate(61, 17);
+    canvas->scale(3, 2);
+    canvas->drawImage(src.asImage(), 0, 0);
+    canvas->restore();
+
+    paint.setAlphaf(0.5f);
+    canvas->saveLayer(nullptr, &paint);
+    canvas->drawImageRect(src.asImage(), SkRect::MakeXYWH(100, 90, 150, 100),
+                          SkSamplingOptions(SkFilterMode::kLinear));
+    canvas->restore();
+}
+
+// Anti-aliased edges may round differently where a tile clip cuts them, so pixels next to a seam
+// between tiles may be off by one for each seam they touch. Everything else must match exactly.
+static void check_along_seams(skiatest::Reporter* r, const SkBitmap& expected,
+                              const SkBitmap& actual, SkISize tileSize) {
+    // How many seams run through or along the pixel at index i of a row or column.
+    auto cuts = [](int i, int tile, int length) {
+        return int(i > 0 && i % tile == 0) + int(i + 1 < length && (i + 1) % tile == 0);
+    };
+    for (int y = 0; y < expected.height(); y++) {
+        for (int x = 0; x < expected.width(); x++) {
+            SkColor e = expected.getColor(x, y),
+                    a = actual.getColor(x, y);
+            const int tolerance = cuts(x, tileSize.width(),  expected.width()) +
+                                  cuts(y, tileSize.height(), expected.height());
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (std::abs(int((e >> shift) & 0xff) - int((a >> shift) & 0xff)) > tolerance) {
+                    ERRORF(r, "tile size %dx%d: pixel (%d, %d) is %08x, expected %08x",
+                           tileSize.width(), tileSize.height(), x, y, a, e);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(ThreadedRasterSurface_MatchesSerial, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(317, 211);
+
+    // Make our own executor so the --threads parameter doesn't mess things up.
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (bool antiAlias : {false, true}) {
+        SkBitmap expected;
+        expected.allocPixels(info);
+        {
+            SkCanvas canvas(expected);
+            draw_scene(&canvas, antiAlias);
+        }
+
+        for (SkISize tileSize : {SkISize{64, 64}, SkISize{317, 16}, SkISize{7, 500}}) {
+            SkBitmap actual;
+            actual.allocPixels(info);
+
+            SkThreadedRasterSurface::Options options;
+            options.fTileSize = tileSize;
+            options.fExecutor = executor.get();
+            auto surface = SkThreadedRasterSurface::Make(actual, options);
+            REPORTER_ASSERT(r, surface);
+
+            draw_scene(surface->beginFrame(), antiAlias);
+            surface->endFrame();
+
+            if (antiAlias) {
+                check_along_seams(r, expected, actual, tileSize);
+            } else {
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual),
+                                "tile size %dx%d", tileSize.width(), tileSize.height());
+            }
+        }
+    }
+}
+
+DEF_TEST(ThreadedRasterSurface_BackdropAcrossTiles, r) {
+    // A backdrop blur straddling the seams between tiles reads pixels from its neighbors.
+    auto draw = [](SkCanvas* canvas) {
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        for (int x = 0; x < 128; x += 8) {
+            paint.setColor(x % 16 ? SK_ColorBLACK : SK_ColorRED);
+            canvas->drawRect(SkRect::MakeXYWH(x, 0, 4, 128), paint);
+        }
+        const SkRect bounds = SkRect::MakeXYWH(40, 40, 48, 48);
+        sk_sp<SkImageFilter> blur = SkImageFilters::Blur(6, 6, nullptr);
+        canvas->saveLayer(SkCanvas::SaveLayerRec(&bounds, nullptr, blur.get(), 0));
+        canvas->restore();
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeXYWH(60, 0, 8, 128), paint);
+    };
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(128, 128);
+    SkBitmap expected;
+    expected.allocPixels(info);
+    {
+        SkCanvas canvas(expected);
+        draw(&canvas);
+    }
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkBitmap actual;
+    actual.allocPixels(info);
+    SkThreadedRasterSurface::Options options;
+    options.fTileSize = {64, 64};
+    options.fExecutor = executor.get();
+    auto surface = SkThreadedRasterSurface::Make(actual, options);
+    REPORTER_ASSERT(r, surface && surface->tileCount() == 4);
+
+    for (int i = 0; i < 4; i++) {
+        actual.eraseColor(SK_ColorTRANSPARENT);
+        draw(surface->beginFrame());
+        surface->endFrame();
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual), "frame %d", i);
+    }
+}
+
+DEF_TEST(ThreadedRasterSurface_Make, r) {
+    SkBitmap bitmap;
+    REPORTER_ASSERT(r, !SkThreadedRasterSurface::Make(bitmap, {}));
+
+    bitmap.allocN32Pixels(100, 30);
+    SkThreadedRasterSurface::Options options;
+    options.fTileSize = {0, 10};
+    REPORTER_ASSERT(r, !SkThreadedRasterSurface::Make(bitmap, options));
+
+    options.fTileSize = {40, 40};
+    auto surface = SkThreadedRasterSurface::Make(bitmap, options);
+    REPORTER_ASSERT(r, surface && surface->tileCount() == 3);
+}
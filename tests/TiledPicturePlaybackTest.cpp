@@ -0,0 +1,217 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkRect.h"
+#include "include/effects/SkImageFilters.h"
+#include "include/utils/SkRandom.h"
+#include "src/core/SkTiledPicturePlayback.h"
+#include "tests/Test.h"
+#include "tools/ToolUtils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+static sk_sp<SkPicture> make_picture(SkBBHFactory* factory) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(251, 173), factory);
+    canvas->clear(SK_ColorWHITE);
+
+    // Only axis-aligned rects: a tile clip chops curves and slanted edges, which then round
+    // differently all along their length, not just at the seam.
+    SkRandom rand;
+    SkPaint paint;
+    for (int i = 0; i < 300; i++) {
+        paint.setColor(rand.nextU() | 0x80000000);
+        paint.setAntiAlias(rand.nextBool());
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeF(-10, 200), rand.nextRangeF(-10, 150),
+                                    rand.nextRangeF(1, 40), rand.nextRangeF(1, 40));
+        canvas->drawRect(r, paint);
+    }
+
+    paint.setAlphaf(0.5f);
+    canvas->saveLayer(SkRect::MakeXYWH(40, 30, 100, 80), &paint);
+    canvas->drawRect(SkRect::MakeLTRB(45, 25, 135, 115), SkPaint());
+    canvas->restore();
+    return recorder.finishRecordingAsPicture();
+}
+
+// Anti-aliased edges may round differently where a tile clip cuts them, so pixels next to a seam
+// between tiles may be off by one for each seam they touch. Everything else must match exactly.
+static void check_along_seams(skiatest::Reporter* r, const SkBitmap& expected,
+                              const SkBitmap& actual, SkISize grid) {
+    const SkISize size    = expected.dimensions(),
+                  clamped = SkTiledPicturePlayback::Grid(size, grid.width(), grid.height());
+    std::vector<int> columnCuts(size.width()),
+                     rowCuts(size.height());
+    for (int x = 0; x < clamped.width(); x++) {
+        SkIRect tile = SkTiledPicturePlayback::Tile(size, grid.width(), grid.height(), x, 0);
+        columnCuts[tile.left()]      += tile.left()  > 0;
+        columnCuts[tile.right() - 1] += tile.right() < size.width();
+    }
+    for (int y = 0; y < clamped.height(); y++) {
+        SkIRect tile = SkTiledPicturePlayback::Tile(size, grid.width(), grid.height(), 0, y);
+        rowCuts[tile.top()]        += tile.top()    > 0;
+        rowCuts[tile.bottom() - 1] += tile.bottom() < size.height();
+    }
+
+    for (int y = 0; y < size.height(); y++) {
+        for (int x = 0; x < size.width(); x++) {
+            SkColor e = expected.getColor(x, y),
+                    a = actual.getColor(x, y);
+            const int tolerance = columnCuts[x] + rowCuts[y];
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (std::abs(int((e >> shift) & 0xff) - int((a >> shift) & 0xff)) > tolerance) {
+                    ERRORF(r, "grid %dx%d: pixel (%d, %d) is %08x, expected %08x",
+                           grid.width(), grid.height(), x, y, a, e);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(TiledPicturePlayback_MatchesSerial, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(251, 173);
+
+    // Make our own executor so the --threads parameter doesn't mess things up.
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    SkRTreeFactory factory;
+    for (bool withBBH : {true, false}) {
+        sk_sp<SkPicture> picture = make_picture(withBBH ? &factory : nullptr);
+
+        SkMatrix scaled = SkMatrix::Scale(1.25f, 1.1f);
+        scaled.postTranslate(-7.5f, 3.25f);
+        for (const SkMatrix& matrix : {SkMatrix::I(), scaled}) {
+            SkBitmap expected;
+            expected.allocPixels(info);
+            {
+                SkCanvas canvas(expected);
+                canvas.concat(matrix);
+                picture->playback(&canvas);
+            }
+
+            for (SkISize grid : {SkISize{1, 1}, SkISize{4, 4}, SkISize{3, 7}, SkISize{300, 2}}) {
+                SkBitmap actual;
+                actual.allocPixels(info);
+                actual.eraseColor(SK_ColorTRANSPARENT);
+
+                SkTiledPicturePlayback::Options options;
+                options.fColumns  = grid.width();
+                options.fRows     = grid.height();
+                options.fExecutor = executor.get();
+                options.fBuildBBH = withBBH;
+                REPORTER_ASSERT(r, SkTiledPicturePlayback::Draw(picture.get(), actual.pixmap(),
+                                                                matrix, options));
+                check_along_seams(r, expected, actual, grid);
+            }
+        }
+    }
+}
+
+DEF_TEST(TiledPicturePlayback_Tiles, r) {
+    // Tiles cover the target exactly once.
+    for (SkISize grid : {SkISize{1, 1}, SkISize{3, 5}, SkISize{10, 1}, SkISize{40, 40}}) {
+        const SkISize size = {17, 29};
+        const SkISize clamped = SkTiledPicturePlayback::Grid(size, grid.width(), grid.height());
+        const int columns = clamped.width(),
+                  rows    = clamped.height();
+        REPORTER_ASSERT(r, columns == std::min(grid.width(), size.width()) &&
+                           rows    == std::min(grid.height(), size.height()));
+        int64_t area = 0;
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < columns; x++) {
+                SkIRect tile = SkTiledPicturePlayback::Tile(size, grid.width(), grid.height(),
+                                                            x, y);
+                REPORTER_ASSERT(r, !tile.isEmpty());
+                REPORTER_ASSERT(r, SkIRect::MakeSize(size).contains(tile));
+                area += tile.width() * tile.height();
+            }
+        }
+        REPORTER_ASSERT(r, area == size.area());
+    }
+}
+
+DEF_TEST(TiledPicturePlayback_HugeGrid, r) {
+    // A grid of one tile per pixel of a huge target is clamped without overflowing.
+    const SkISize huge = {1 << 20, 1 << 20};
+    SkISize grid = SkTiledPicturePlayback::Grid(huge, SK_MaxS32, SK_MaxS32);
+    REPORTER_ASSERT(r, grid.width() >= 1 && grid.height() >= 1);
+    REPORTER_ASSERT(r, (int64_t)grid.width() * grid.height() <= SkTiledPicturePlayback::kMaxTiles);
+    REPORTER_ASSERT(r, SkTiledPicturePlayback::Tile(huge, SK_MaxS32, SK_MaxS32,
+                                                    grid.width() - 1, grid.height() - 1)
+                               .right() == huge.width());
+
+    // On a small target that's one tile per pixel.
+    grid = SkTiledPicturePlayback::Grid({40, 30}, SK_MaxS32, SK_MaxS32);
+    REPORTER_ASSERT(r, grid == SkISize::Make(40, 30));
+}
+
+DEF_TEST(TiledPicturePlayback_Backdrop, r) {
+    // A backdrop blur across tile seams reads its neighbors' pixels, so can't be drawn by tile.
+    SkPictureRecorder recorder;
+    SkRTreeFactory factory;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(120, 120), &factory);
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    for (int x = 0; x < 120; x += 6) {
+        paint.setColor(x % 12 ? SK_ColorBLACK : SK_ColorGREEN);
+        canvas->drawRect(SkRect::MakeXYWH(x, 0, 3, 120), paint);
+    }
+    const SkRect bounds = SkRect::MakeXYWH(30, 30, 60, 60);
+    sk_sp<SkImageFilter> blur = SkImageFilters::Blur(5, 5, nullptr);
+    canvas->saveLayer(SkCanvas::SaveLayerRec(&bounds, nullptr, blur.get(), 0));
+    canvas->restore();
+
+    // Nest it in another picture too; the backdrop still has to be found.
+    sk_sp<SkPicture> inner = recorder.finishRecordingAsPicture();
+    canvas = recorder.beginRecording(SkRect::MakeWH(120, 120), &factory);
+    canvas->drawPicture(inner);
+    sk_sp<SkPicture> outer = recorder.finishRecordingAsPicture();
+
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const sk_sp<SkPicture>& picture : {inner, outer}) {
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(120, 120);
+        actual.allocN32Pixels(120, 120);
+        {
+            SkCanvas serial(expected);
+            serial.drawPicture(picture);
+        }
+        SkTiledPicturePlayback::Options options;
+        options.fColumns  = 3;
+        options.fRows     = 3;
+        options.fExecutor = executor.get();
+        REPORTER_ASSERT(r, SkTiledPicturePlayback::Draw(picture.get(), actual.pixmap(),
+                                                        SkMatrix::I(), options));
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected, actual));
+    }
+}
+
+DEF_TEST(TiledPicturePlayback_Invalid, r) {
+    sk_sp<SkPicture> picture = make_picture(nullptr);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(10, 10);
+
+    SkTiledPicturePlayback::Options options;
+    REPORTER_ASSERT(r, !SkTiledPicturePlayback::Draw(nullptr, bitmap.pixmap(), SkMatrix::I(),
+                                                     options));
+    REPORTER_ASSERT(r, !SkTiledPicturePlayback::Draw(picture.get(), SkPixmap(), SkMatrix::I(),
+                                                     options));
+
+    options.fColumns = 0;
+    REPORTER_ASSERT(r, !SkTiledPicturePlayback::Draw(picture.get(), bitmap.pixmap(),
+                                                     SkMatrix::I(), options));
+}
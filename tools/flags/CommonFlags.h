@@ -42,7 +42,9 @@ bool CollectImages(CommandLineFlags::StringArray dir, SkTArray<SkString>* output
 void SetCtxOptions(struct GrContextOptions*);
 
 /**
- *  Enable, disable, or force analytic anti-aliasing using --analyticAA and --forceAnalyticAA.
+ *  Enable, disable, or force analytic anti-aliasing using --analyticAA and --forceAnalyticAA,
+ *  or switch to the sparse strips scan converter with --sparseStrips, and fill large paths on
+ *  multiple threads with --threadedPathFill.
  */
 void SetAnalyticAA();
 
@@ -11,10 +11,19 @@ static DEFINE_bool(forceAnalyticAA, false,
             "Force analytic anti-aliasing even if the path is complicated: "
             "whether it's concave or convex, we consider a path complicated"
             "if its number of points is comparable to its resolution.");
+static DEFINE_bool(sparseStrips, false,
+            "Fill anti-aliased paths with the sparse strips scan converter instead of "
+            "analytic anti-aliasing or supersampling.");
+static DEFINE_bool(threadedPathFill, false,
+            "Fill large anti-aliased paths in horizontal bands on multiple threads. "
+            "Those fills use the sparse strips scan converter instead of analytic "
+            "anti-aliasing or supersampling, so their edges may rasterize differently.");
 
 void SetAnalyticAA() {
-    gSkUseAnalyticAA   = FLAGS_analyticAA;
-    gSkForceAnalyticAA = FLAGS_forceAnalyticAA;
+    gSkUseAnalyticAA       = FLAGS_analyticAA;
+    gSkForceAnalyticAA     = FLAGS_forceAnalyticAA;
+    gSkUseSparseStrips     = FLAGS_sparseStrips;
+    gSkUseThreadedPathFill = FLAGS_threadedPathFill;
 }
 
 }